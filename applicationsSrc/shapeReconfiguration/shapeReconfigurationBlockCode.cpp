@@ -51,8 +51,8 @@ void ShapeReconfigurationBlockCode::startup() {
 void ShapeReconfigurationBlockCode::myDistanceBroadcastFunction(std::shared_ptr<Message> _msg, P2PNetworkInterface* sender) {
     MessageOf<pair<int, int>>* msg = static_cast<MessageOf<pair<int, int>>*>(_msg.get());
     pair<int,int> msgData = *msg->getData();
-    console << "I received a distance d = " <<  msgData.first  << " from " << sender->getConnectedBlockId() << "\n";
-    console << "I received a current round of: " <<  msgData.second << "\n";
+    CONSOLE(LOG_LEVEL_DEBUG) << "I received a distance d = " <<  msgData.first  << " from " << sender->getConnectedBlockId() << "\n";
+    CONSOLE(LOG_LEVEL_DEBUG) << "I received a current round of: " <<  msgData.second << "\n";
 
     if(myParent == nullptr || myCurrentRound < msgData.second){
         myChildren.clear();
@@ -103,7 +103,7 @@ void ShapeReconfigurationBlockCode::myDistanceAcknowledgeFunction(std::shared_pt
     string str = msgg.first;
     pair<int, int> msgData = msgg.second;
 
-    console << "I received an acknowledgement from: " << sender->getConnectedBlockId() << " with a distance to leaf d  = " << msgData.first << "\n";
+    CONSOLE(LOG_LEVEL_DEBUG) << "I received an acknowledgement from: " << sender->getConnectedBlockId() << " with a distance to leaf d  = " << msgData.first << "\n";
     myNbWaitedAnswers--;
 
     if(str == "Parent")
@@ -139,7 +139,7 @@ void ShapeReconfigurationBlockCode::myLeaderBroadcastFunction(std::shared_ptr<Me
     
     MessageOf<int>* msg = static_cast<MessageOf<int>*>(_msg.get());
     int msgData = *msg->getData();
-    console << "I received a message leader Id = " <<  msgData  << " from " << sender->getConnectedBlockId() << "\n";
+    CONSOLE(LOG_LEVEL_DEBUG) << "I received a message leader Id = " <<  msgData  << " from " << sender->getConnectedBlockId() << "\n";
 
     if(module->blockId == msgData && isInMotion == false){
         isInMotion = true;
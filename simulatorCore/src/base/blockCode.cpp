@@ -13,6 +13,8 @@
 #include "world.h"
 #include "../grid/lattice.h"
 #include "../grid/target.h"
+#include "../stats/eventProfiler.h"
+#include "../replay/traceExporter.h"
 
 using namespace std;
 
@@ -76,8 +78,8 @@ int BlockCode::sendMessage(HandleableMessage*msg,
         throw InterfaceNotConnectedException(this, msg, dest);
     }
 
-    console << " sends " << msg->getName() << " to "
-            << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    CONSOLE(LOG_LEVEL_DEBUG) << " sends " << msg->getName() << " to "
+                             << dest->getConnectedBlockId() << " at " << t1 << "\n";
 #ifdef DEBUG_MESSAGES
     OUTPUT << "#" << hostBlock->blockId << " " << hostBlock->position
            << " sends " << msg->type << " to "
@@ -99,12 +101,13 @@ int BlockCode::sendMessage(const char*msgString, Message*msg,
     if (not dest->connectedInterface) {
         throw InterfaceNotConnectedException(this, msg, dest);
     }
-    if (msgString)
-        console << " sends " << msgString << " to "
-                << dest->getConnectedBlockId() << " at " << t1 << "\n";
-    else if (msg->isMessageHandleable())
-        console << " sends " << msg->getMessageName() << " to "
-                << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    if (msgString) {
+        CONSOLE(LOG_LEVEL_DEBUG) << " sends " << msgString << " to "
+                                 << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    } else if (msg->isMessageHandleable()) {
+        CONSOLE(LOG_LEVEL_DEBUG) << " sends " << msg->getMessageName() << " to "
+                                 << dest->getConnectedBlockId() << " at " << t1 << "\n";
+    }
 
 #ifdef DEBUG_MESSAGES
     OUTPUT << hostBlock->blockId << " sends " << msg->type << " to "
@@ -150,13 +153,11 @@ int BlockCode::sendMessageToAllNeighbors(const char*msgString, Message*msg,
             while (j<nexcept && p2p!=tabExceptions[j]) j++;
             if (j==nexcept) {
                 sendMessage(msgString, msg->clone(), p2p, t0, dt);
-                Message::incrementMessageCounts();
                 n++;
             }
         }
     }
 
-    Message::adjustClonedMessageCount();
     delete msg;
 
     return n;
@@ -173,6 +174,8 @@ void BlockCode::processLocalEvent(EventPtr pev) {
             // search message id in eventFuncMap
             multimap<int,eventFunc>::iterator im = eventFuncMap.find(message->type);
             multimap<int,eventFunc2>::iterator im2 = eventFuncMap2.find(message->type);
+            utils::EventProfiler::MessageScope profile(message->type);
+            TraceExporter::HandlerScope trace(message, hostBlock->blockId);
             if (im!=eventFuncMap.end()) {
                 P2PNetworkInterface *recv_interface = message->destinationInterface;
                 (*im).second(this,message,recv_interface);
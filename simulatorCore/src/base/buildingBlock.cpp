@@ -20,6 +20,8 @@ namespace BaseSimulator {
 
 bID BuildingBlock::nextId = 0;
 bool BuildingBlock::userConfigHasBeenParsed = false;
+thread_local const ruint *BuildingBlock::presetSeed = nullptr;
+thread_local bool BuildingBlock::deferBlockCode = false;
 
 //===========================================================================================================
 //
@@ -27,11 +29,18 @@ bool BuildingBlock::userConfigHasBeenParsed = false;
 //
 //===========================================================================================================
 
-BuildingBlock::BuildingBlock(int bId, BlockCodeBuilder bcb, int nbInterfaces) {
+BuildingBlock::BuildingBlock(int bId, BlockCodeBuilder bcb, int nbInterfaces)
+    // Seeding a mersenne twister is costly, seed the generator once instead of default constructing it
+    : generator((presetSeed ? *presetSeed : Simulator::getSimulator()->getRandomUint()) * bId) {
 #ifdef DEBUG_OBJECT_LIFECYCLE
     OUTPUT << "BuildingBlock constructor (id:" << nextId << ")" << endl;
 #endif
 
+    if (utils::MemoryAccounting::enable) {
+        memorySize = max(utils::MemoryAccounting::takeAllocationSize(), sizeof(BuildingBlock));
+        utils::MemoryAccounting::getInstance().add(utils::MemoryAccounting::BLOCKS, 1, memorySize);
+    }
+
     if (bId < 0) {
         blockId = nextId;
         nextId++;
@@ -42,31 +51,34 @@ BuildingBlock::BuildingBlock(int bId, BlockCodeBuilder bcb, int nbInterfaces) {
     state.store(ALIVE);
     clock = new PerfectClock();
 
-    ruint seed = Simulator::getSimulator()->getRandomUint();
-    seed *= bId;
-    generator = uintRNG(seed);
-
     buildNewBlockCode = bcb;
 
     if (utils::StatsIndividual::enable) {
         stats = new StatsIndividual();
     }
 
+    P2PNetworkInterfaces.reserve(nbInterfaces);
     for (int i = 0; i < nbInterfaces; i++) {
         P2PNetworkInterfaces.push_back(new P2PNetworkInterface(this));
     }
 
     //setDefaultHardwareParameters();
 
-    blockCode = (BaseSimulator::BlockCode*)bcb(this);
+    blockCode = NULL;
+    if (!deferBlockCode)
+        buildBlockCode();
+
+    isMaster = false;
+}
+
+void BuildingBlock::buildBlockCode() {
+    blockCode = (BaseSimulator::BlockCode*)buildNewBlockCode(this);
 
     // Parse user configuration from configuration file, only performed once
     if (!userConfigHasBeenParsed) {
         userConfigHasBeenParsed = true;
         blockCode->parseUserElements(Simulator::getSimulator()->getConfigDocument());
     }
-
-    isMaster = false;
 }
 
 BuildingBlock::~BuildingBlock() {
@@ -80,6 +92,9 @@ BuildingBlock::~BuildingBlock() {
 
     for (P2PNetworkInterface *p2p : P2PNetworkInterfaces)
         delete p2p;
+
+    if (memorySize)
+        utils::MemoryAccounting::getInstance().add(utils::MemoryAccounting::BLOCKS, -1, -(int64_t)memorySize);
 }
 
     short BuildingBlock::getInterfaceId(const P2PNetworkInterface* itf) const {
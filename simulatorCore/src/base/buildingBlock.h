@@ -20,6 +20,7 @@
 #include "../clock/clock.h"
 #include "../grid/cell3DPosition.h"
 #include "../stats/statsIndividual.h"
+#include "../stats/memoryAccounting.h"
 #include "../utils/random.h"
 
 class Event;
@@ -74,6 +75,16 @@ class BuildingBlock {
     BlockCodeBuilder buildNewBlockCode; //!< function ptr to the block's blockCodeBuilder
     uint8_t orientationCode; //!< Identifier of the modules connector's along the x-axis
     utils::StatsIndividual *stats = NULL; //!< Module stats collected during the simulation
+    unsigned int memorySize = 0; //!< allocated size of the block, if memory accounting is enabled
+
+    MEMORY_ACCOUNTED_CLASS()
+
+    //!< If set, random value drawn in advance from the simulator to seed the next block constructed
+    //!<  by the calling thread, used for parallel construction (see World::prefabricateBlocks)
+    static thread_local const ruint *presetSeed;
+    //!< If set, the blocks constructed by the calling thread are left without block code, which is
+    //!<  built afterwards by buildBlockCode on the main thread (see World::prefabricateBlocks)
+    static thread_local bool deferBlockCode;
     /**
      * @brief BuildingBlock constructor
      * @param bId : the block id of the block to create
@@ -88,6 +99,12 @@ class BuildingBlock {
      */
     virtual ~BuildingBlock();
 
+    /**
+     * @brief Builds the block code of the block with its BlockCodeBuilder, and parses the user
+     *  configuration with the first block code built. Called by the constructor, unless deferBlockCode is set
+     */
+    void buildBlockCode();
+
     /**
      * @brief Getter for P2PNetworkInterfaces attribute
      * @return A vector containing pointers to the block's interfaces
@@ -3,6 +3,8 @@
 
 #include <sstream>
 
+using namespace BaseSimulator::utils;
+
 GlBlock::GlBlock(bID id):blockId(id) {
     position[0] = 0.0;
     position[1] = 0.0;
@@ -12,6 +14,7 @@ GlBlock::GlBlock(bID id):blockId(id) {
     color[2] = 128;
     visible = true;
     isHighlighted = false;
+    accountMemory();
 }
 
 GlBlock::GlBlock(bID id,const Vector3D &pos, const Color &col) : blockId(id) {
@@ -23,10 +26,19 @@ GlBlock::GlBlock(bID id,const Vector3D &pos, const Color &col) : blockId(id) {
     color[2] = GLubyte(col[2]*255.0);
     visible = true;
     isHighlighted = false;
+    accountMemory();
 }
 
 GlBlock::~GlBlock() {
+    if (memorySize)
+        MemoryAccounting::getInstance().add(MemoryAccounting::GLBLOCKS, -1, -(int64_t)memorySize);
+}
 
+void GlBlock::accountMemory() {
+    if (MemoryAccounting::enable) {
+        memorySize = max(MemoryAccounting::takeAllocationSize(), sizeof(GlBlock));
+        MemoryAccounting::getInstance().add(MemoryAccounting::GLBLOCKS, 1, memorySize);
+    }
 }
 
 void GlBlock::setPosition(const Vector3D &pos) {
@@ -12,6 +12,7 @@
 #include "../math/vector3D.h"
 #include "../utils/color.h"
 #include "../utils/tDefs.h"
+#include "../stats/memoryAccounting.h"
 
 namespace ObjLoader {
 class ObjLoader;
@@ -26,6 +27,9 @@ public :
     GLubyte color[3];
     bID blockId;
     bool visible;
+    unsigned int memorySize = 0; //!< allocated size of the block, if memory accounting is enabled
+
+    MEMORY_ACCOUNTED_CLASS()
 
     GlBlock(bID id);
     GlBlock(bID id,const Vector3D &pos, const Color &col);
@@ -50,6 +54,9 @@ public :
     virtual void glDrawShadows(ObjLoader::ObjLoader *ptrObj) { glDraw(ptrObj); };
     virtual void glDrawId(ObjLoader::ObjLoader *ptrObj,int n);
     virtual void glDrawIdByMaterial(ObjLoader::ObjLoader *ptrObj,int &n);
+private:
+    //!< Accounts for the block in MemoryAccounting, called by the constructors
+    void accountMemory();
 };
 
 #endif /* GLBLOCK_H_ */
@@ -23,6 +23,8 @@
 #include "../csg/csg.h"
 #include "../csg/csgParser.h"
 #include "../replay/replayExporter.h"
+#include "../utils/configExporter.h"
+#include "../utils/worldGenerator.h"
 
 using namespace std;
 
@@ -54,8 +56,27 @@ Simulator::Simulator(int argc, char *argv[], BlockCodeBuilder _bcb): bcb(_bcb),
 
     string confFileName = cmdLine.getConfigFile();
 
+    loadStart = chrono::steady_clock::now();
+
+    // block and obstacle elements are streamed from the file buffer (or mapped from
+    //  a binary snapshot), only the rest of the configuration is loaded in xmlDoc
     xmlDoc = new TiXmlDocument(confFileName.c_str());
-    bool isLoaded = xmlDoc->LoadFile();
+    bool isLoaded;
+    if (ConfigSnapshot::isSnapshotFile(confFileName)) {
+        isLoaded = confSnapshot.load(confFileName);
+        if (isLoaded) xmlDoc->Parse(confSnapshot.getXml().data());
+    } else {
+        isLoaded = confStream.load(confFileName);
+        if (isLoaded) xmlDoc->Parse(confStream.getDomText().c_str());
+    }
+    isLoaded = isLoaded and not xmlDoc->Error();
+
+    // A generated world does not require a configuration file, default settings are used instead
+    if (not isLoaded and cmdLine.randomWorldRequested()) {
+        xmlDoc->Clear();
+        xmlDoc->Parse("<world><blockList/></world>");
+        isLoaded = not xmlDoc->Error();
+    }
 
     random_device rd;
     mt19937 gen(rd());
@@ -163,21 +184,32 @@ void Simulator::parseConfiguration(int argc, char*argv[]) {
 
         // Configure the simulation world
         parseWorld(argc, argv);
-        initializeIDPool();
+        if (not cmdLine.randomWorldRequested()) initializeIDPool();
 
         // Instantiate and configure the Scheduler
         loadScheduler(schedulerMaxDate);
 
         // Parse and configure the remaining items
-        parseBlockList();
+        // Modules of the block list are started and linked all at once, after they have all been added
+        if (cmdLine.randomWorldRequested()) {
+            generateWorld();
+        } else {
+            world->beginBulkLoad(confSnapshot.getNbBlocks() + confStream.getBlocks().size());
+            parseBlockList();
+            world->endBulkLoad();
+        }
         parseCameraAndSpotlight();
         parseObstacles();
+        confStream.release();
+        confSnapshot.release();
         parseTarget();
         parseCustomizations();
     } catch(ParsingException const& e) {
         cerr << e.what();
         exit(EXIT_FAILURE);
     }
+
+    loadDuration = chrono::duration<double>(chrono::steady_clock::now() - loadStart).count();
 }
 
 Simulator::IDScheme Simulator::determineIDScheme() {
@@ -292,6 +324,12 @@ bID Simulator::countNumberOfModules() {
     const char *attr;
     bID moduleCount = 0;
 
+    // Count modules from streamed block elements
+    for (const XmlElementView& block : confStream.getBlocks()) {
+        if (block.attribute("obstacle").data() == nullptr)
+            moduleCount++;
+    }
+
     // Count modules from block elements
     for(TiXmlNode *child = xmlBlockListNode->FirstChild("block"); child; child = child->NextSibling("block")){
 
@@ -300,7 +338,7 @@ bID Simulator::countNumberOfModules() {
         TiXmlElement *element;
         element = child->ToElement();
         obst = element->Attribute("obstacle");
-        if(!attr){
+        if(!obst){
             moduleCount++;
         }
         
@@ -396,49 +434,51 @@ void Simulator::initializeIDPool() {
         case MANUAL: {
             bID id;
             TiXmlElement *element;
-            const char *attr;
             unordered_set<int> dupCheck;			// Set containing all previously assigned IDs, used to check for duplicates
-            for(TiXmlNode *child = xmlBlockListNode->FirstChild("block"); child; child = child->NextSibling("block")) {
-                element = child->ToElement();
-                
-                //by hussein
-                attr=element->Attribute("obstacle");
-                if(!attr)
-                {
-                    attr = element->Attribute("id");
-
-                    if (attr) {
-                        try {
-                            string str(attr);
-                            id =  stoull(str); // id in range [0, 2^64 - 1]
-                        } catch (const std::invalid_argument& e) {
-                            stringstream error;
-                            error << "invalid id attribute value in configuration file: "
-                                << attr << "\n";
-                            throw ParsingException(error.str());
-                        } catch (const std::out_of_range& e) {
-                            stringstream error;
-                            error << "out of range id attribute value in configuration file: "
-                                << attr << "\n";
-                            throw ParsingException(error.str());
-                        }
-                    } else {
+
+            // Registers the id attribute of a module, in order of appearance
+            auto addManualId = [&](const char *attr) {
+                if (attr) {
+                    try {
+                        string str(attr);
+                        id =  stoull(str); // id in range [0, 2^64 - 1]
+                    } catch (const std::invalid_argument& e) {
                         stringstream error;
-                        error << "missing id attribute for block node in configuration file while in MANUAL mode" << "\n";
+                        error << "invalid id attribute value in configuration file: "
+                              << attr << "\n";
                         throw ParsingException(error.str());
-                    }
-
-                    // Ensure unicity of the ID, by inserting id to the set and checking that insertion took place
-                    //  (insertion does not take place if there is a duplicate, and false is returned)
-                    if (dupCheck.insert(id).second)
-                        IDPool.push_back(id);
-                    else {
+                    } catch (const std::out_of_range& e) {
                         stringstream error;
-                        error << "duplicate id attribute " << id << " for block node in configuration file while in MANUAL mode" << "\n";
+                        error << "out of range id attribute value in configuration file: "
+                              << attr << "\n";
                         throw ParsingException(error.str());
                     }
+                } else {
+                    stringstream error;
+                    error << "missing id attribute for block node in configuration file while in MANUAL mode" << "\n";
+                    throw ParsingException(error.str());
+                }
 
+                // Ensure unicity of the ID, by inserting id to the set and checking that insertion took place
+                //  (insertion does not take place if there is a duplicate, and false is returned)
+                if (dupCheck.insert(id).second)
+                    IDPool.push_back(id);
+                else {
+                    stringstream error;
+                    error << "duplicate id attribute " << id << " for block node in configuration file while in MANUAL mode" << "\n";
+                    throw ParsingException(error.str());
                 }
+            };
+
+            // Obstacle modules take their ID from the pool when loaded, like other modules
+            for (const XmlElementView& block : confStream.getBlocks()) {
+                string_view v = block.attribute("id");
+                addManualId(v.data() ? string(v).c_str() : nullptr);
+            }
+
+            for(TiXmlNode *child = xmlBlockListNode->FirstChild("block"); child; child = child->NextSibling("block")) {
+                element = child->ToElement();
+                addManualId(element->Attribute("id"));
             }
 
         } break;
@@ -465,6 +505,16 @@ void Simulator::readSimulationType(int argc, char*argv[]) {
         }
         OUTPUT << "Loading " << programPath << " with MeldInterpretVM" << endl;
         MeldInterpret::MeldInterpretVM::setConfiguration(programPath, debugging);
+        MeldInterpret::MeldInterpretVM::nbThreads = cmdLine.getMeldThreads();
+        const string convertProgramFile = cmdLine.getConvertProgramFile();
+        if (not convertProgramFile.empty()) {
+            if (convertProgramFile.size() > 4
+                and convertProgramFile.compare(convertProgramFile.size() - 4, 4, ".cpp") == 0)
+                MeldInterpret::MeldInterpretVM::writeNativeCode(convertProgramFile);
+            else
+                MeldInterpret::MeldInterpretVM::writeProgramImage(convertProgramFile);
+            exit(EXIT_SUCCESS);
+        }
         if(debugging){
             //Don't know what to do yet
             cerr << "warning: MeldInterpreter debugging not implemented yet" << endl;
@@ -606,6 +656,15 @@ void Simulator::parseWorld(int argc, char*argv[]) {
             throw ParsingException(error.str());
         }
 
+        // The grid of a generated world only depends on its topology and size
+        if (cmdLine.randomWorldRequested()) {
+            Cell3DPosition size = WorldGenerator(cmdLine.getRandomTopology(),
+                                                 cmdLine.getRandomTopologyParameter(), seed).getGridSize();
+            lx = size[0];
+            ly = size[1];
+            lz = size[2];
+        }
+
         // Create the simulation world and lattice
         loadWorld(Cell3DPosition(lx,ly,lz),
                   Vector3D(0, 0, 0), // Always use default blocksize
@@ -744,11 +803,94 @@ void Simulator::parseBlockList() {
             OUTPUT << "new default color :" << defaultColor << endl;
         }
 #endif
-        /* Reading a catoms */
-        TiXmlNode *block = xmlBlockListNode->FirstChild("block");
         Cell3DPosition position;
         Color color;
         bool master;
+
+        auto checkInGrid = [this](const Cell3DPosition& position) {
+            if (not getWorld()->lattice->isInGrid(position)) {
+                cerr << "GridLowerBounds: "
+                     << getWorld()->lattice->getGridLowerBounds(position[2]) << endl;
+                cerr << "GridUpperBounds: "
+                     << getWorld()->lattice->getGridUpperBounds(position[2])<< endl;
+                stringstream error;
+                error << "module at " << position << " is out of grid" << "\n";
+                throw ParsingException(error.str());
+            }
+        };
+
+        /* Construct the modules of the snapshot records and streamed elements on several threads,
+           they are then added by loadBlock and loadObstacle in the usual order */
+        if (cmdLine.getBuildThreads() != 1) {
+            vector<bID> blockIds;
+            blockIds.reserve(confSnapshot.getNbBlocks() + confStream.getBlocks().size());
+            for (size_t i = 0; i < confSnapshot.getNbBlocks(); i++)
+                blockIds.push_back(confSnapshot.getBlocks()[i].id);
+            for (size_t i = 0; i < confStream.getBlocks().size(); i++) {
+                if (ids != ORDERED and indexBlock + i >= IDPool.size()) break;
+                blockIds.push_back(ids == ORDERED ? indexBlock + i + 1 : IDPool[indexBlock + i]);
+            }
+            world->prefabricateBlocks(blockIds, bcb, cmdLine.getBuildThreads());
+        }
+
+        /* Reading binary snapshot records, IDs are part of the records */
+        const SnapshotBlock *records = confSnapshot.getBlocks();
+        for (size_t i = 0; i < confSnapshot.getNbBlocks(); i++) {
+            const SnapshotBlock &rec = records[i];
+            position.set(rec.position[0], rec.position[1], rec.position[2]);
+            color.set(rec.color[0], rec.color[1], rec.color[2], rec.color[3]);
+            master = rec.flags & SnapshotBlock::MASTER;
+
+            checkInGrid(position);
+
+            if (rec.flags & SnapshotBlock::OBSTACLE) {
+                loadObstacle(rec.id, bcb, position, color, rec.orientation, master);
+            } else {
+                TiXmlElement blockElt("block");
+                blockElt.SetAttribute("orientation", rec.orientation);
+                ConfigSnapshot::forEachAttribute(confSnapshot.getAttributes(rec),
+                                                 [&](string_view n, string_view v) {
+                    blockElt.SetAttribute(string(n), string(v));
+                    storeBlockAttribute(rec.id, n, v);
+                });
+                loadBlock(&blockElt, rec.id, bcb, position, color, master);
+            }
+        }
+
+        /* Reading streamed block elements, without going through the DOM */
+        for (const XmlElementView& view : confStream.getBlocks()) {
+            color=defaultColor;
+            master=false;
+            string_view v = view.attribute("color");
+            if (v.data()) ConfigStreamParser::parseColor(v, color);
+            v = view.attribute("position");
+            if (v.data()) ConfigStreamParser::parseCell3DPosition(v, position);
+            v = view.attribute("master");
+            if (v == "true" or v == "1") master=true;
+
+            checkInGrid(position);
+
+            if (view.attribute("obstacle").data() == nullptr) {
+                // loadBlock expects an element for parsing block specific attributes
+                bID blockId = ids == ORDERED ? ++indexBlock:IDPool[indexBlock++];
+                TiXmlElement blockElt("block");
+                view.fillTiXmlElement(blockElt);
+                view.forEachAttribute([&](string_view n, string_view v) {
+                    storeBlockAttribute(blockId, n, v);
+                    return false;
+                });
+                loadBlock(&blockElt, blockId, bcb, position, color, master);
+            } else {
+                int orientation = 0 ;
+                v = view.attribute("orientation");
+                const char *p = v.data();
+                if (p) ConfigStreamParser::parseInt(p, p + v.size(), orientation);
+                loadObstacle(ids == ORDERED ? ++indexBlock:IDPool[indexBlock++], bcb, position, color, orientation, master);
+            }
+        }
+
+        /* Reading a catoms */
+        TiXmlNode *block = xmlBlockListNode->FirstChild("block");
         while (block) {
             element = block->ToElement();
             color=defaultColor;
@@ -786,16 +928,8 @@ void Simulator::parseBlockList() {
 #endif
             }
 
-            if (not getWorld()->lattice->isInGrid(position)) {
-                cerr << "GridLowerBounds: "
-                     << getWorld()->lattice->getGridLowerBounds(position[2]) << endl;
-                cerr << "GridUpperBounds: "
-                     << getWorld()->lattice->getGridUpperBounds(position[2])<< endl;
-                stringstream error;
-                error << "module at " << position << " is out of grid" << "\n";
-                throw ParsingException(error.str());
-            }
-            
+            checkInGrid(position);
+
             //by hussein
             const char* obst;
             TiXmlElement *element;
@@ -803,7 +937,10 @@ void Simulator::parseBlockList() {
             obst = element->Attribute("obstacle");
             if(!obst){
                 // cerr << "addBlock(" << currentID << ") pos = " << position << endl;
-                loadBlock(element, ids == ORDERED ? ++indexBlock:IDPool[indexBlock++], bcb, position, color, master);
+                bID blockId = ids == ORDERED ? ++indexBlock:IDPool[indexBlock++];
+                for (const TiXmlAttribute *a = element->FirstAttribute(); a; a = a->Next())
+                    storeBlockAttribute(blockId, a->Name(), a->Value());
+                loadBlock(element, blockId, bcb, position, color, master);
             }
             else{
                 int orientation = 0 ;
@@ -1010,6 +1147,49 @@ void Simulator::parseBlockList() {
     }
 }
 
+void Simulator::generateWorld() {
+    WorldGenerator generator(cmdLine.getRandomTopology(), cmdLine.getRandomTopologyParameter(), seed);
+    generator.generate(world->lattice);
+    const vector<Cell3DPosition> &modules = generator.getModules();
+    const vector<Cell3DPosition> &obstacles = generator.getObstacles();
+
+    if (confSnapshot.getNbBlocks() + confStream.getBlocks().size() > 0)
+        cerr << "warning: modules of the configuration file are replaced by the generated world" << endl;
+    cerr << "Generated " << modules.size() << " modules and " << obstacles.size()
+         << " obstacles in a " << world->lattice->gridSize << " grid" << endl;
+
+    Color color = DARKGREY;
+    TiXmlElement* element = xmlBlockListNode->ToElement();
+    color.set(element->Attribute("color"));
+
+    // Modules are identified by their order of generation, obstacles come after them
+    world->beginBulkLoad(modules.size() + obstacles.size());
+    if (cmdLine.getBuildThreads() != 1) {
+        vector<bID> blockIds(modules.size());
+        for (size_t i = 0; i < modules.size(); i++) blockIds[i] = i + 1;
+        world->prefabricateBlocks(blockIds, bcb, cmdLine.getBuildThreads());
+    }
+    bID blockId = 0;
+    for (const Cell3DPosition &p : modules)
+        world->addBlock(++blockId, bcb, p, color);
+    for (const Cell3DPosition &p : obstacles)
+        loadObstacle(++blockId, bcb, p, GREY, 0, false);
+    world->endBulkLoad();
+}
+
+void Simulator::storeBlockAttribute(bID blockId, string_view name, string_view value) {
+    static const string_view genericAttributes[] = {
+        "position", "color", "master", "obstacle", "id", "orientation"
+    };
+
+    for (const string_view& generic : genericAttributes)
+        if (name == generic) return;
+
+    string& attrs = blockAttributes[blockId];
+    attrs.append(name).push_back('\0');
+    attrs.append(value).push_back('\0');
+}
+
 void Simulator::parseTarget() {
     Target::targetListNode = xmlWorldNode->FirstChild("targetList");
     if (Target::targetListNode) {
@@ -1019,6 +1199,14 @@ void Simulator::parseTarget() {
 }
 
 void Simulator::parseObstacles() {
+    // loading the obstacles from a binary snapshot
+    const SnapshotObstacle *records = confSnapshot.getObstacles();
+    for (size_t i = 0; i < confSnapshot.getNbObstacles(); i++) {
+        const SnapshotObstacle &rec = records[i];
+        world->addObstacle(Cell3DPosition(rec.position[0], rec.position[1], rec.position[2]),
+                           Color(rec.color[0], rec.color[1], rec.color[2], rec.color[3]));
+    }
+
     // loading the obstacles
     TiXmlNode *nodeObstacle = xmlWorldNode->FirstChild("obstacleList");
     if (nodeObstacle) {
@@ -1027,9 +1215,18 @@ void Simulator::parseObstacles() {
         const char *attr= element->Attribute("color");
         defaultColor.set(attr);
 
-        nodeObstacle = nodeObstacle->FirstChild("obstacle");
         Cell3DPosition position;
         Color color;
+        for (const XmlElementView& view : confStream.getObstacles()) {
+            color=defaultColor;
+            string_view v = view.attribute("color");
+            if (v.data()) ConfigStreamParser::parseColor(v, color);
+            v = view.attribute("position");
+            if (v.data()) ConfigStreamParser::parseCell3DPosition(v, position);
+            world->addObstacle(position, color);
+        }
+
+        nodeObstacle = nodeObstacle->FirstChild("obstacle");
         while (nodeObstacle) {
             element = nodeObstacle->ToElement();
             color=defaultColor;
@@ -1075,9 +1272,33 @@ void Simulator::parseCustomizations() {
     }
 }
 
+void Simulator::convertConfiguration(const string& fileName) {
+    cerr << "Configuration " << cmdLine.getConfigFile() << " loaded in "
+         << loadDuration * 1000 << " ms (" << world->getNbBlocks() << " modules)" << endl;
+
+    const string ext = CONFIG_SNAPSHOT_EXT;
+    bool isSnapshot = fileName.size() >= ext.size()
+        and fileName.compare(fileName.size() - ext.size(), ext.size(), ext) == 0;
+
+    // Both formats hold the residual XML of the configuration and the records of all the
+    //  modules and obstacles, so that converted configurations load back identically
+    bool written = isSnapshot ?
+        SnapshotConfigExporter(world, fileName).exportConfiguration() :
+        SnapshotXmlConfigExporter(world, fileName).exportConfiguration();
+    if (not written)
+        exit(EXIT_FAILURE);
+
+    exit(EXIT_SUCCESS);
+}
+
 void Simulator::startSimulation() {
-    // Connect all blocks – TODO: Check if needed to do it here (maybe all blocks are linked on addition)
-    world->linkBlocks();
+    // Only convert the configuration if requested
+    if (not cmdLine.getConvertConfigFile().empty())
+        convertConfiguration(cmdLine.getConvertConfigFile());
+
+    // Connect all blocks, unless they have already been linked during the bulk construction of the world
+    if (not world->areBlocksLinked())
+        world->linkBlocks();
 
     // Finalize scheduler configuration and start simulation if autoStart is enabled
     Scheduler *scheduler = getScheduler();
@@ -12,12 +12,16 @@
 #define TIXML_USE_STL	1
 #include "../deps/TinyXML/tinyxml.h"
 
+#include <chrono>
+
 #include "../utils/tDefs.h"
 #include "../events/scheduler.h"
 #include "world.h"
 #include "../utils/commandLine.h"
 #include "blockCode.h"
 #include "../replay/replayExporter.h"
+#include "../utils/configStreamParser.h"
+#include "../utils/configSnapshot.h"
 
 using namespace std;
 
@@ -40,6 +44,7 @@ class Simulator {
     inline static bool exportFinalConfiguration;
     inline static string configFileName;
     //!< (causes configuration export before simulator termination)
+    inline static string exportConfigFileName; //!< If set, name of the file written by configuration exporters
 
     static Simulator* getSimulator() {
         assert(simulator != NULL);
@@ -97,6 +102,20 @@ class Simulator {
     TiXmlDocument *xmlDoc;		//!< TinyXMLDocument for the configuration file
     TiXmlNode* xmlWorldNode; //!< world XML node from the configuration file
     TiXmlNode* xmlBlockListNode; //!< blockList XML node from the configuration file
+    ConfigStreamParser confStream; //!< Streamed block and obstacle elements, not part of xmlDoc
+    ConfigSnapshot confSnapshot; //!< Block and obstacle records, if the configuration is a binary snapshot
+    std::chrono::steady_clock::time_point loadStart; //!< Date at which configuration loading started
+    double loadDuration = 0; //!< Configuration loading time, in seconds
+    map<bID, string> blockAttributes; //!< Block specific attributes of the configuration ("name\0value\0" pairs), for snapshot export
+
+    /**
+     * @brief Records a block specific configuration attribute, if not one of the generic block attributes
+     *  (position, color, master, obstacle, id, orientation)
+     * @param blockId id of the block
+     * @param name attribute name
+     * @param value attribute value
+     */
+    void storeBlockAttribute(bID blockId, string_view name, string_view value);
 
     BlockCodeBuilder bcb; //!< Function pointer to the target BlockCode builder
 
@@ -206,6 +225,13 @@ class Simulator {
      */
     void parseBlockList();
 
+    /*! @fn generateWorld()
+     *  @brief Adds the modules and obstacles of the world requested with --generate,
+     *   instead of those of the configuration
+     *
+     */
+    void generateWorld();
+
     /*!
      *  @brief Parses the configuration for obstacles information
      *
@@ -215,6 +241,14 @@ class Simulator {
     //<! @brief Parses the configuration for target information, and instantiate them
     void parseTarget();
 
+    /**
+     * @brief Exports the loaded configuration to file fileName, as a binary snapshot if it has
+     *  the CONFIG_SNAPSHOT_EXT extension or as XML otherwise, then terminates the simulator.
+     *  Used for converting configurations between formats (--convert-config option)
+     * @param fileName output file
+     */
+    void convertConfiguration(const string& fileName);
+
     /*! @fn virtual void loadWorld(int lx, int ly, int lz, int argc, char *argv[])
      *  @brief Calls the createWorld function from the target world subclass to instantiate it
      *
@@ -253,6 +287,12 @@ class Simulator {
     inline TiXmlDocument *getConfigDocument() { return xmlDoc; }
 
     inline BlockCodeBuilder getBlockCodeBuilder() { return bcb; }
+
+    /**
+     * @brief Getter for the block specific attributes found in the configuration
+     * @return a map of "name\0value\0" attribute pairs, indexed by block id (blocks without attributes are absent)
+     */
+    inline const map<bID, string>& getBlockAttributes() const { return blockAttributes; }
 };
 
 inline void deleteSimulator() {
@@ -6,11 +6,14 @@
  */
 
 #include <cstdlib>
+#include <thread>
 
 #include "world.h"
+#include "simulator.h"
 #include "../utils/trace.h"
 #include "../gui/openglViewer.h"
 #include "../replay/replayExporter.h"
+#include "../events/events.h"
 
 using namespace std;
 
@@ -135,8 +138,110 @@ namespace BaseSimulator {
         }
     }
 
+    void World::beginBulkLoad(size_t nbBlocks) {
+        bulkLoading = true;
+        bulkBlocks.reserve(nbBlocks);
+        mapGlBlocks.reserve(mapGlBlocks.size() + nbBlocks);
+    }
+
+    bool World::scheduleCodeStart(BuildingBlock *bb, Time date) {
+        if (bulkLoading) {
+            bulkBlocks.emplace_back(bb, date);
+            return true;
+        }
+
+        getScheduler()->schedule(new CodeStartEvent(date, bb));
+        return false;
+    }
+
+    void World::prefabricateBlocks(const vector<bID> &ids, BlockCodeBuilder bcb, unsigned int nbThreads) {
+        if (ids.empty()) return;
+
+        // The first block is constructed by the calling thread, as the first block code parses
+        //  the user configuration. It also tells whether the world supports parallel construction.
+        BuildingBlock *first = createBlock(ids[0], bcb);
+        if (not first) return;
+
+        // Seeds are drawn in addition order, as they would be by the constructors of addBlock
+        vector<ruint> seeds(ids.size());
+        for (size_t i = 1; i < ids.size(); i++)
+            seeds[i] = Simulator::getSimulator()->getRandomUint();
+
+        const size_t offset = prefabricatedBlocks.size();
+        prefabricatedBlocks.resize(offset + ids.size(), nullptr);
+        prefabricatedBlocks[offset] = first;
+
+        if (nbThreads == 0) nbThreads = max(1u, thread::hardware_concurrency());
+        const size_t rangeSize = (ids.size() - 1 + nbThreads - 1) / nbThreads;
+        vector<thread> workers;
+        for (size_t begin = 1; begin < ids.size(); begin += rangeSize) {
+            const size_t end = min(ids.size(), begin + rangeSize);
+            workers.emplace_back([this, &ids, &seeds, bcb, offset, begin, end]() {
+                BuildingBlock::deferBlockCode = true;
+                for (size_t i = begin; i < end; i++) {
+                    BuildingBlock::presetSeed = &seeds[i];
+                    prefabricatedBlocks[offset + i] = createBlock(ids[i], bcb);
+                }
+                BuildingBlock::presetSeed = nullptr;
+                BuildingBlock::deferBlockCode = false;
+            });
+        }
+
+        for (thread &worker : workers)
+            worker.join();
+
+        // User block codes are not required to be thread-safe, they are built by this thread
+        for (size_t i = offset + 1; i < prefabricatedBlocks.size(); i++)
+            prefabricatedBlocks[i]->buildBlockCode();
+
+        // Interfaces were numbered in construction order, renumber them in addition order
+        uint64_t globalId = UINT64_MAX;
+        for (size_t i = offset; i < prefabricatedBlocks.size(); i++)
+            for (P2PNetworkInterface *itf : prefabricatedBlocks[i]->getP2PNetworkInterfaces())
+                globalId = min(globalId, itf->globalId);
+        for (size_t i = offset; i < prefabricatedBlocks.size(); i++)
+            for (P2PNetworkInterface *itf : prefabricatedBlocks[i]->getP2PNetworkInterfaces())
+                itf->globalId = globalId++;
+    }
+
+    BuildingBlock *World::takePrefabricatedBlock(bID blockId) {
+        if (nextPrefabricatedBlock < prefabricatedBlocks.size()
+            and prefabricatedBlocks[nextPrefabricatedBlock]->blockId == blockId)
+            return prefabricatedBlocks[nextPrefabricatedBlock++];
+
+        return nullptr;
+    }
+
+    void World::endBulkLoad() {
+        bulkLoading = false;
+
+        // Blocks that have been prefabricated but not added, if parsing took another path
+        for (size_t i = nextPrefabricatedBlock; i < prefabricatedBlocks.size(); i++)
+            delete prefabricatedBlocks[i];
+        vector<BuildingBlock *>().swap(prefabricatedBlocks);
+        nextPrefabricatedBlock = 0;
+
+        if (bulkBlocks.empty()) return;
+
+        // Withdraw deferred blocks from the lattice, and put them back one by one, so that each
+        //  block only sees the neighbors that were inserted before it
+        for (const auto &deferred : bulkBlocks)
+            lattice->remove(deferred.first->position, false);
+
+        for (const auto &deferred : bulkBlocks) {
+            BuildingBlock *bb = deferred.first;
+            getScheduler()->schedule(new CodeStartEvent(deferred.second, bb));
+            lattice->insert(bb, bb->position, false);
+            linkBlock(bb->position);
+        }
+
+        vector<pair<BuildingBlock *, Time>>().swap(bulkBlocks);
+        bulkLinked = true;
+    }
+
     void World::linkBlocks() {
-        //TODO: Might not be necessary anymore, since a module is now linked to its neighbors when added to the lattice
+        // Blocks linking themselves on addition have already been linked, either individually or by endBulkLoad,
+        //  this pass is only required by worlds whose addBlock does not call linkBlock
         const Cell3DPosition &lb = lattice->getGridLowerBounds();
         const Cell3DPosition &ub = lattice->getGridUpperBounds();
         Cell3DPosition p;
@@ -183,8 +288,8 @@ namespace BaseSimulator {
                 toBlock = fromBlock->connectedInterface;
 
                 // Clear message queue
-                fromBlock->outgoingQueue.clear();
-                toBlock->outgoingQueue.clear();
+                fromBlock->clearOutgoingQueue();
+                toBlock->clearOutgoingQueue();
 
                 // Notify respective codeBlocks
                 block->removeNeighbor(fromBlock);
@@ -67,6 +67,12 @@ namespace BaseSimulator {
          ************************************************************/
 
         bID maxBlockId = 0; //!< The block id of the block with the highest id in the world
+
+        bool bulkLoading = false; //!< true between beginBulkLoad and endBulkLoad
+        bool bulkLinked = false; //!< true if all blocks of the configuration have been linked by endBulkLoad
+        vector<pair<BuildingBlock *, Time>> bulkBlocks; //!< blocks added during bulk loading and the date of their CodeStartEvent, in insertion order
+        vector<BuildingBlock *> prefabricatedBlocks; //!< blocks constructed by prefabricateBlocks, in addition order
+        size_t nextPrefabricatedBlock = 0; //!< index of the next prefabricated block to be added to the world
         // vector<ScenarioEvent&> tabEvents;
 
         /**
@@ -212,6 +218,68 @@ namespace BaseSimulator {
                               const Cell3DPosition &pos, const Color &col,
                               short orientation = 0, bool master = false) = 0;
 
+        /**
+         * @brief Starts the bulk construction of the world. Until endBulkLoad is called, blocks added
+         *  through scheduleCodeStart are inserted in the lattice but neither started nor linked.
+         * @param nbBlocks : expected number of blocks, used to preallocate the world containers
+         */
+        void beginBulkLoad(size_t nbBlocks);
+
+        /**
+         * @brief Ends the bulk construction of the world, schedules the CodeStartEvent of the
+         *  deferred blocks and links them in a single linear pass.
+         *
+         * Blocks are processed in insertion order and only linked to the blocks processed before
+         *  them, so that events are scheduled exactly as if blocks had been linked on addition.
+         */
+        void endBulkLoad();
+
+        /**
+         * @brief Schedules the CodeStartEvent of a newly added block, or defers it to endBulkLoad
+         *  during bulk construction. In the latter case, the block must not be linked by addBlock.
+         * @param bb : the new block
+         * @param date : date of the CodeStartEvent
+         * @return true if the block has been deferred
+         */
+        bool scheduleCodeStart(BuildingBlock *bb, Time date);
+
+        /**
+         * @brief Instantiates a block of the type of the world, without adding it to the world.
+         *  Worlds that support parallel construction override this function.
+         * @param blockId : id of the block
+         * @param bcb : a pointer to the user function returning the BlockCode to execute on the block
+         * @return the new block, or nullptr if the world does not support parallel construction
+         */
+        virtual BuildingBlock *createBlock(bID blockId, BlockCodeBuilder bcb) { return nullptr; }
+
+        /**
+         * @brief Constructs blocks ahead of their addition to the world, on several threads.
+         *
+         * The list of ids is split into contiguous ranges, which follow the order of the configuration
+         *  file and thus cover distinct regions of the lattice. Random seeds and interface ids are
+         *  assigned in list order, so that blocks are identical to those constructed by addBlock.
+         *  Only modules and their interfaces are constructed concurrently: block codes are built
+         *  after the join by the calling thread, in list order, and their constructors need not be
+         *  thread-safe. They draw their random values from their module after its constructor.
+         *
+         * @param ids : ids of the blocks (modules and obstacles), in the order in which they will be added
+         * @param bcb : a pointer to the user function returning the BlockCode to execute on the blocks
+         * @param nbThreads : number of construction threads, 0 to use all hardware threads
+         */
+        void prefabricateBlocks(const vector<bID> &ids, BlockCodeBuilder bcb, unsigned int nbThreads);
+
+        /**
+         * @brief Takes the next prefabricated block, to be called by addBlock instead of constructing a block
+         * @param blockId : id of the block being added
+         * @return the prefabricated block, or nullptr if the next prefabricated block does not have id blockId
+         */
+        BuildingBlock *takePrefabricatedBlock(bID blockId);
+
+        /**
+         * @brief Indicates whether all blocks of the configuration have already been linked by endBulkLoad
+         */
+        bool areBlocksLinked() const { return bulkLinked; }
+
         /**
          * @brief Deletes a block from the simulation after disconnecting it and all of
          *  its neighbors and notifying them
@@ -10,6 +10,7 @@
 
 #include "../events/scheduler.h"
 #include "../comm/network.h"
+#include "../replay/traceExporter.h"
 #include "../utils/trace.h"
 #include "../stats/statsIndividual.h"
 #include "../utils/utils.h"
@@ -20,10 +21,10 @@ using namespace std;
 using namespace BaseSimulator;
 using namespace BaseSimulator::utils;
 
-uint64_t Message::nextId = 0;
-uint64_t Message::nbMessages = 0;
+std::atomic<uint64_t> Message::nextId(0);
+std::atomic<uint64_t> Message::nbMessages(0);
 
-uint64_t P2PNetworkInterface::nextId = 0;
+std::atomic<uint64_t> P2PNetworkInterface::nextId(0);
 int P2PNetworkInterface::defaultDataRate = 1000000;
 
 //===========================================================================================================
@@ -33,15 +34,27 @@ int P2PNetworkInterface::defaultDataRate = 1000000;
 //===========================================================================================================
 
 Message::Message() {
-    id = nextId;
-    nextId++;
+    id = nextId++;
     nbMessages++;
+    if (MemoryAccounting::enable)
+        memorySize = max(MemoryAccounting::takeAllocationSize(), sizeof(Message));
     MESSAGE_CONSTRUCTOR_INFO();
 }
 
+Message::Message(unsigned int t) : Message() {
+    type = t;
+}
+
+Message::Message(const Message &m) : Message(m.type) {
+    sourceInterface = m.sourceInterface;
+    destinationInterface = m.destinationInterface;
+}
+
 Message::~Message() {
     MESSAGE_DESTRUCTOR_INFO();
     nbMessages--;
+    if (memoryTracked)
+        MemoryAccounting::getInstance().add(MemoryAccounting::MESSAGES, -1, -(int64_t)memorySize, type);
 }
 
 uint64_t Message::getNbMessages() {
@@ -53,12 +66,7 @@ string Message::getMessageName() const {
 }
 
 Message* Message::clone() const {
-    Message* ptr = new Message(*this);
-    ptr->sourceInterface = sourceInterface;
-    ptr->destinationInterface = destinationInterface;
-    ptr->type = type;
-    adjustClonedMessageCount();
-    return ptr;
+    return new Message(*this);
 }
 
 //===========================================================================================================
@@ -88,9 +96,11 @@ P2PNetworkInterface::P2PNetworkInterface(BaseSimulator::BuildingBlock *b) {
     hostBlock = b;
     connectedInterface = NULL;
     availabilityDate = 0;
-    globalId = nextId;
-    nextId++;
+    globalId = nextId++;
     dataRate = new StaticRate(defaultDataRate);
+    if (MemoryAccounting::enable)
+        MemoryAccounting::getInstance().add(MemoryAccounting::INTERFACES, 1,
+                                            sizeof(P2PNetworkInterface) + sizeof(StaticRate));
 }
 
 void P2PNetworkInterface::setDataRate(Rate *r) {
@@ -106,6 +116,18 @@ P2PNetworkInterface::~P2PNetworkInterface() {
 #endif
 #endif
     delete dataRate;
+    if (MemoryAccounting::enable) {
+        MemoryAccounting::getInstance().add(MemoryAccounting::INTERFACES, -1,
+                                            -(int64_t)(sizeof(P2PNetworkInterface) + sizeof(StaticRate)));
+        clearOutgoingQueue();
+    }
+}
+
+void P2PNetworkInterface::clearOutgoingQueue() {
+    if (MemoryAccounting::enable and not outgoingQueue.empty())
+        MemoryAccounting::getInstance().add(MemoryAccounting::OUTGOING_QUEUES, -(int64_t)outgoingQueue.size(),
+                                            -(int64_t)(outgoingQueue.size() * sizeof(MessagePtr)));
+    outgoingQueue.clear();
 }
 
 void P2PNetworkInterface::send(Message *m) {
@@ -117,7 +139,13 @@ bool P2PNetworkInterface::addToOutgoingBuffer(MessagePtr msg) {
 
     if (connectedInterface != NULL) {
         outgoingQueue.push_back(msg);
+        if (MemoryAccounting::enable) {
+            MemoryAccounting::getInstance().trackMessage(msg.get());
+            MemoryAccounting::getInstance().add(MemoryAccounting::OUTGOING_QUEUES, 1, sizeof(MessagePtr));
+        }
         BaseSimulator::utils::StatsIndividual::incOutgoingMessageQueueSize(hostBlock->stats);
+        if (TraceExporter::isTraceEnabled())
+            TraceExporter::getInstance()->writeMessageSend(*msg, hostBlock->blockId);
         if (availabilityDate < BaseSimulator::getScheduler()->now()) availabilityDate = BaseSimulator::getScheduler()->now();
         if (outgoingQueue.size() == 1 && messageBeingTransmitted == NULL) { //TODO
             BaseSimulator::getScheduler()->schedule(new NetworkInterfaceStartTransmittingEvent(availabilityDate,this));
@@ -150,6 +178,8 @@ void P2PNetworkInterface::send() {
 
     msg = outgoingQueue.front();
     outgoingQueue.pop_front();
+    if (MemoryAccounting::enable)
+        MemoryAccounting::getInstance().add(MemoryAccounting::OUTGOING_QUEUES, -1, -(int64_t)sizeof(MessagePtr));
 
     BaseSimulator::utils::StatsIndividual::decOutgoingMessageQueueSize(hostBlock->stats);
 
@@ -8,12 +8,14 @@
 #ifndef NETWORK_H_
 #define NETWORK_H_
 
+#include <atomic>
 #include <deque>
 #include <string>
 
 #include "rate.h"
 #include "../utils/tDefs.h"
 #include "../base/buildingBlock.h"
+#include "../stats/memoryAccounting.h"
 
 using namespace std;
 
@@ -38,22 +40,26 @@ typedef std::shared_ptr<Message> MessagePtr;
 
 class Message {
 protected:
-    static uint64_t nextId;
-    static uint64_t nbMessages;
+    static std::atomic<uint64_t> nextId; //!< atomic, as messages may be created by several threads
+    static std::atomic<uint64_t> nbMessages; //!< atomic, as messages may be created by several threads
 public:
     uint64_t id;
     //unsigned int id;
     unsigned int type;
     P2PNetworkInterface *sourceInterface, *destinationInterface;
+    unsigned int memorySize = 0; //!< allocated size of the message, if memory accounting is enabled
+    bool memoryTracked = false; //!< true if the message is accounted by MemoryAccounting
+
+    MEMORY_ACCOUNTED_CLASS()
 
     Message();
-    Message(unsigned int t):type(t) {};
+    Message(unsigned int t);
+    //!< Copies are counted as new messages, with their own id, so that clones need no bookkeeping
+    Message(const Message &m);
     virtual ~Message();
 
     static uint64_t getNbMessages();
     virtual string getMessageName() const;
-    static void incrementMessageCounts() { nextId++; nbMessages++; }
-    static inline void adjustClonedMessageCount() { nbMessages++; }
 
     virtual unsigned int size() const { return(4); }
     /**
@@ -100,7 +106,7 @@ public :
 
 class P2PNetworkInterface {
 protected:
-    static uint64_t nextId;
+    static std::atomic<uint64_t> nextId; //!< atomic, as blocks and their interfaces may be constructed in parallel
     static int defaultDataRate;
 
     BaseSimulator::Rate* dataRate;
@@ -119,6 +125,9 @@ class P2PNetworkInterface {
     P2PNetworkInterface(BaseSimulator::BuildingBlock *b);
     ~P2PNetworkInterface();
 
+    //!< Drops the messages waiting in the outgoing queue
+    void clearOutgoingQueue();
+
     void send(Message *m);
 
     bool addToOutgoingBuffer(MessagePtr msg);
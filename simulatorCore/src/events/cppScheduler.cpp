@@ -17,6 +17,13 @@
 #include "../base/world.h"
 #include "../base/simulator.h"
 #include "../replay/replayExporter.h"
+#include "../utils/configExporter.h"
+#include "../stats/eventProfiler.h"
+#include "../stats/statsSampler.h"
+#include "../stats/memoryAccounting.h"
+#include "../stats/metricsExporter.h"
+#include "../replay/traceExporter.h"
+#include "../utils/logSink.h"
 
 using namespace std;
 using namespace BaseSimulator::utils;
@@ -62,6 +69,15 @@ void *CPPScheduler::startPaused(/*void *param*/) {
         auto systemStartTime = get_time::now();
         cout << TermColor::SchedulerColor << "" << "Scheduler : start order received " << 0 << TermColor::Reset << endl;
 
+        if (EventProfiler::enable)
+            EventProfiler::getInstance().start();
+
+        MetricsExporter::start();
+
+        // Open trace file and set its host time origin
+        if (TraceExporter::isTraceEnabled())
+            TraceExporter::getInstance();
+
         // Write first key frame
         if (ReplayExporter::isReplayEnabled())
             ReplayExporter::getInstance()->writeKeyFrame(0);
@@ -94,12 +110,25 @@ void *CPPScheduler::startPaused(/*void *param*/) {
                         first=eventsMap.begin();
                         pev = (*first).second;
                         currentDate = pev->date;
+                        if (StatsSampler::period)
+                            StatsSampler::sampleIfNeeded(currentDate);
                         contextModule = pev->getConcernedBlock();
-                        pev->consume();
+                        {
+                            EventProfiler::EventScope profile(pev);
+                            TraceExporter::EventScope trace(pev);
+                            pev->consume();
+                        }
                         contextModule = NULL;
                         StatsCollector::getInstance().incEventsCount();
                         eventsMap.erase(first);
                         eventsMapSize--;
+                        StatsCollector::getInstance().updateSchedulerState(currentDate, eventsMapSize);
+
+                        if (ConfigExporter::exportPeriod)
+                            ConfigExporter::exportConfigurationIfNeeded(currentDate);
+
+                        if (MemoryAccounting::dumpRequested)
+                            MemoryAccounting::dumpIfRequested();
                     }
 
                     if (terminate.load()) {
@@ -137,14 +166,27 @@ void *CPPScheduler::startPaused(/*void *param*/) {
                             first=eventsMap.begin();
                             pev = (*first).second;
                             currentDate = pev->date;
+                            if (StatsSampler::period)
+                                StatsSampler::sampleIfNeeded(currentDate);
                             //lock();
                             contextModule = pev->getConcernedBlock();
-                            pev->consume();
+                            {
+                                EventProfiler::EventScope profile(pev);
+                                TraceExporter::EventScope trace(pev);
+                                pev->consume();
+                            }
                             contextModule = NULL;
                             StatsCollector::getInstance().incEventsCount();
                             //unlock();
                             eventsMap.erase(first);
                             eventsMapSize--;
+                            StatsCollector::getInstance().updateSchedulerState(currentDate, eventsMapSize);
+
+                            if (ConfigExporter::exportPeriod)
+                                ConfigExporter::exportConfigurationIfNeeded(currentDate);
+
+                            if (MemoryAccounting::dumpRequested)
+                                MemoryAccounting::dumpIfRequested();
                         }
                     }
 
@@ -176,6 +218,14 @@ void *CPPScheduler::startPaused(/*void *param*/) {
 
         pev.reset();
 
+        if (EventProfiler::enable)
+            EventProfiler::getInstance().stop();
+
+        if (StatsSampler::period)
+            StatsSampler::endSampling(currentDate);
+
+        MetricsExporter::stop();
+
         StatsCollector::getInstance().updateElapsedTime(currentDate, chrono::duration_cast<us>(elapsedTime).count());
         StatsCollector::getInstance().setLivingCounters(Event::getNbLivingEvents(), Message::getNbMessages());
         StatsCollector::getInstance().setEndEventsQueueSize(eventsMap.size());
@@ -185,6 +235,7 @@ void *CPPScheduler::startPaused(/*void *param*/) {
             && !terminate.load()) {
             getWorld()->exportConfiguration();
         }
+        ConfigExporter::waitForBackgroundExport();
 
         // if autoStop is enabled, terminate simulation
         if (willAutoStop() && !terminate.load()) {
@@ -196,7 +247,6 @@ void *CPPScheduler::startPaused(/*void *param*/) {
     }
 
     terminate.store(true);
-    schedulerThread = NULL;	// No need for the scheduler to delete this thread, it will have terminated already
 
     // Terminate replay export if enabled
     if (ReplayExporter::isReplayEnabled()) {
@@ -204,5 +254,12 @@ void *CPPScheduler::startPaused(/*void *param*/) {
         ReplayExporter::getInstance()->endExport();
     }
 
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->endExport();
+
+    if (LogSink::isEnabled())
+        LogSink::endLogging();
+
+    schedulerThread = NULL;	// No need for the scheduler to delete this thread, it will have terminated already
     return(NULL);
 }
@@ -34,7 +34,9 @@ class CPPScheduler : public BaseSimulator::Scheduler {
     }
 
     void waitForSchedulerEnd() {
-        schedulerThread->join();
+        // Short simulations can end and release schedulerThread before this call
+        thread *t = schedulerThread;
+        if (t and t->joinable()) t->join();
     }
 
     inline int getMode() { return schedulerMode; }
@@ -13,8 +13,8 @@
 #include "../base/blockCode.h"
 #include "../stats/statsIndividual.h"
 
-int Event::nextId = 0;
-unsigned int Event::nbLivingEvents = 0;
+std::atomic<int> Event::nextId(0);
+std::atomic<unsigned int> Event::nbLivingEvents(0);
 
 using namespace std;
 using namespace BaseSimulator;
@@ -26,28 +26,33 @@ using namespace BaseSimulator;
 //===========================================================================================================
 
 Event::Event(Time t) {
-    id = nextId;
-    nextId++;
+    id = nextId++;
     nbLivingEvents++;
     date = t;
     eventType = EVENT_GENERIC;
     randomNumber = 0;
+    if (utils::MemoryAccounting::enable)
+        memorySize = max(utils::MemoryAccounting::takeAllocationSize(), sizeof(Event));
     EVENT_CONSTRUCTOR_INFO();
 }
 
 Event::Event(Event *ev) {
-    id = nextId;
-    nextId++;
+    id = nextId++;
     nbLivingEvents++;
     date = ev->date;
     eventType = ev->eventType;
     randomNumber = 0;
+    if (utils::MemoryAccounting::enable)
+        memorySize = max(utils::MemoryAccounting::takeAllocationSize(), sizeof(Event));
     EVENT_CONSTRUCTOR_INFO();
 }
 
 Event::~Event() {
     EVENT_DESTRUCTOR_INFO();
     nbLivingEvents--;
+    if (memoryTracked)
+        utils::MemoryAccounting::getInstance().add(utils::MemoryAccounting::EVENTS, -1,
+                                                   -(int64_t)memorySize, eventType);
 }
 
 const string Event::getEventName() {
@@ -10,6 +10,7 @@
 
 //class BuildingBlock;
 
+#include <atomic>
 #include <inttypes.h>
 #include <string>
 #include "../base/buildingBlock.h"
@@ -18,6 +19,7 @@
 #include "../utils/color.h"
 #include "../utils/tDefs.h"
 #include "../utils/random.h"
+#include "../stats/memoryAccounting.h"
 
 using namespace std;
 using namespace BaseSimulator;
@@ -48,14 +50,18 @@ typedef std::shared_ptr<Event> EventPtr;
 
 class Event {
 protected:
-    static int nextId;
-    static unsigned int nbLivingEvents;
+    static std::atomic<int> nextId; //!< atomic, as events may be created by several threads
+    static std::atomic<unsigned int> nbLivingEvents; //!< atomic, as events may be created by several threads
 
 public:
     int id;				//!< unique ID of the event (mainly for debugging purpose)
     Time date;		//!< time at which the event will be processed. 0 means simulation start
     int eventType;		//!< see the various types at the beginning of this file
     BaseSimulator::ruint randomNumber;
+    unsigned int memorySize = 0; //!< allocated size of the event, if memory accounting is enabled
+    bool memoryTracked = false; //!< true if the event is accounted by MemoryAccounting
+
+    MEMORY_ACCOUNTED_CLASS()
 
     Event(Time t);
     Event(Event *ev);
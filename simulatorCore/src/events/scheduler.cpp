@@ -14,6 +14,8 @@
 #include "scheduler.h"
 #include "../utils/trace.h"
 #include "../stats/statsIndividual.h"
+#include "../stats/eventProfiler.h"
+#include "../stats/memoryAccounting.h"
 
 using namespace std;
 using namespace BaseSimulator::utils;
@@ -89,6 +91,9 @@ bool Scheduler::schedule(Event *ev) {
         return(false);
     }
 
+    if (MemoryAccounting::enable)
+        MemoryAccounting::getInstance().trackEvent(ev);
+
     lock();
 
     eventsMap.insert(pair<Time, EventPtr>(pev->date,pev));
@@ -131,6 +136,11 @@ void Scheduler::trace(string message, bID id,const Color &color) {
         mutex_trace.unlock();
     }
 
+#ifdef LOGFILE
+    // Nothing to format if log file has not been opened (-l)
+    if (not OUTPUT.is_open()) return;
+#endif
+
     OUTPUT.precision(6);
     OUTPUT << fixed << (double)(currentDate)/1000000 << " #" << id << ": " << message << endl;
 }
@@ -226,9 +236,23 @@ bool Scheduler::hasEvent(int id, unsigned long blockId) {
 
 void Scheduler::printStats() {
   cout << StatsCollector::getInstance();
+  if (not StatsCollector::jsonFileName.empty()
+      and not StatsCollector::getInstance().writeJSON(StatsCollector::jsonFileName)) {
+    cerr << "error: could not write statistics to " << StatsCollector::jsonFileName << endl;
+  }
   if (StatsIndividual::enable) {
     cout << StatsIndividual::getStats();
   }
+  if (EventProfiler::enable) {
+    cout << EventProfiler::getInstance();
+    if (not EventProfiler::jsonFileName.empty()
+        and not EventProfiler::getInstance().writeJSON(EventProfiler::jsonFileName)) {
+      cerr << "error: could not write event profile to " << EventProfiler::jsonFileName << endl;
+    }
+  }
+  if (MemoryAccounting::enable) {
+    cout << MemoryAccounting::getInstance();
+  }
 }
 
 void Scheduler::toggle_pause() {
@@ -244,7 +244,9 @@ class Scheduler {
     //!< @brief Used to synchronise the Scheduler thread with the graphical interface, or other simulation components
     //!<  (destructors), to ensure that scheduler is effectively stopped before releasing memory
     inline void waitForSchedulerEnd() {
-        schedulerThread->join();
+        // Short simulations can end and release schedulerThread before this call
+        thread *t = schedulerThread;
+        if (t and t->joinable()) t->join();
     }
 
     //!< @attention Related to debugger, not completely implemented yet. (incomplete feature)
@@ -20,6 +20,7 @@
 #include "../utils/trace.h"
 #include "../utils/utils.h"
 #include "../utils/global.h"
+#include "../stats/memoryAccounting.h"
 
 // #define showStatsFPS  0
 
@@ -483,6 +484,12 @@ void GlutContext::keyboardFunc(unsigned char c, int x, int y) {
             }
         } break;
         case ',': enableShowFPS = !enableShowFPS; break;
+        case 'M':
+            if (BaseSimulator::utils::MemoryAccounting::enable)
+                cout << BaseSimulator::utils::MemoryAccounting::getInstance();
+            else
+                cout << "Memory accounting is disabled, run with --memory to enable it" << endl;
+            break;
         default: { // Pass on key press to user blockcode handler
             // NOTE: Since C++ does not handle static virtual functions, we need
             //  to get a pointer to a blockcode and call onUserKeyPressed from
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "meldInterpretArena.h"
+
+namespace MeldInterpret {
+
+#ifdef MELD_ARENA_CHECKS
+/** Header of every block in check mode, keeps the block aligned as returned by malloc */
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t sizeClass; /** 0 for blocks larger than MAX_SIZE */
+    uint64_t padding;
+};
+
+#define BLOCK_LIVE  0x4d454c44 /** "MELD" */
+#define BLOCK_FREED 0x46524545 /** "FREE" */
+#define HEADER(p) ((BlockHeader*)(p) - 1)
+
+static void *systemAlloc(size_t size, uint32_t sizeClass) {
+    BlockHeader *header = (BlockHeader*)malloc(sizeof(BlockHeader) + size);
+    MeldArena::nbMallocs++;
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+static void systemFree(void *p) {
+    MeldArena::nbFrees++;
+    free(HEADER(p));
+}
+#else
+#define systemAlloc(size, sizeClass) malloc(size)
+#define systemFree(p) free(p)
+#endif
+
+MeldArena::~MeldArena() {
+    for (size_t c = 1; c < NB_CLASSES; c++) {
+        while (freeLists[c] != NULL) {
+            FreeBlock *block = freeLists[c];
+            freeLists[c] = block->next;
+            systemFree(block);
+        }
+    }
+}
+
+void *MeldArena::allocate(size_t size) {
+    void *p;
+    size_t c = sizeClass(size);
+
+    if (size > MAX_SIZE) {
+        p = systemAlloc(size, 0);
+    } else if (freeLists[c] != NULL) {
+        p = freeLists[c];
+        freeLists[c] = freeLists[c]->next;
+    } else {
+        p = systemAlloc(c * GRANULARITY, c);
+    }
+
+#ifdef MELD_ARENA_CHECKS
+    HEADER(p)->magic = BLOCK_LIVE;
+    nbAllocations++;
+    nbLiveBlocks++;
+#endif
+
+    return p;
+}
+
+void MeldArena::release(void *p, size_t size) {
+    size_t c = sizeClass(size);
+
+#ifdef MELD_ARENA_CHECKS
+    if (HEADER(p)->magic == BLOCK_FREED) {
+        fprintf(stderr, "MeldArena: double free of block %p (%zu bytes)\n", p, size);
+        exit(EXIT_FAILURE);
+    }
+    if (HEADER(p)->magic != BLOCK_LIVE
+        || HEADER(p)->sizeClass != (size > MAX_SIZE ? 0 : c)) {
+        fprintf(stderr, "MeldArena: invalid free of block %p (%zu bytes)\n", p, size);
+        exit(EXIT_FAILURE);
+    }
+    HEADER(p)->magic = BLOCK_FREED;
+    nbReleases++;
+    nbLiveBlocks--;
+#endif
+
+    if (size > MAX_SIZE) {
+        systemFree(p);
+        return;
+    }
+
+    FreeBlock *block = (FreeBlock*)p;
+    block->next = freeLists[c];
+    freeLists[c] = block;
+}
+
+#ifdef MELD_ARENA_CHECKS
+bool MeldArena::isLive(void *p) {
+    return p != NULL && HEADER(p)->magic == BLOCK_LIVE;
+}
+
+void MeldArena::printReport(uint64_t nbReferenced) {
+    double rules = nbRulesFired > 0 ? nbRulesFired.load() : 1;
+    printf("MeldArena: %lu allocations, %lu releases, %lu mallocs, %lu frees\n",
+           (unsigned long)nbAllocations, (unsigned long)nbReleases,
+           (unsigned long)nbMallocs, (unsigned long)nbFrees);
+    printf("MeldArena: %lu rules fired, %.2f allocator calls per rule (%.2f without free lists)\n",
+           (unsigned long)nbRulesFired, (nbMallocs + nbFrees) / rules,
+           (nbAllocations + nbReleases) / rules);
+    printf("MeldArena: %lu live blocks, %lu referenced by the VMs, %lu leaked or in flight\n",
+           (unsigned long)nbLiveBlocks, (unsigned long)nbReferenced,
+           (unsigned long)(nbLiveBlocks - nbReferenced));
+}
+#endif
+
+}
@@ -0,0 +1,82 @@
+/*! @file meldInterpretArena.h
+ * @brief Size-class free lists for the tuples and queue entries of a MeldInterpret VM
+ */
+
+#ifndef MELDINTERPARENA_H_
+#define MELDINTERPARENA_H_
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+
+namespace MeldInterpret {
+
+/**
+ * Allocator of the tuples and queue entries of one MeldInterpretVM. Released blocks are kept in
+ *  a free list per size class (multiples of GRANULARITY bytes, up to MAX_SIZE) and handed back
+ *  by the next allocation of the same class, so that a VM in steady state does not call malloc
+ *  and free. Blocks are obtained from malloc one by one and never moved: a block may be released
+ *  to another arena than the one that allocated it, and may outlive its VM (tuples referenced by
+ *  messages in flight). Larger blocks are passed through to malloc and free.
+ * With MELD_ARENA_CHECKS defined, every release is checked for double and invalid frees, and the
+ *  allocator statistics and leaked blocks are reported at the end of the run
+ *  (MeldInterpretVM::checkArenas).
+ */
+class MeldArena {
+public:
+    static const size_t GRANULARITY = 8;
+    static const size_t MAX_SIZE = 256;
+    static const size_t NB_CLASSES = MAX_SIZE / GRANULARITY + 1;
+
+    MeldArena() {};
+    ~MeldArena();
+
+    /**
+     * @brief Allocates a block of at least size bytes
+     * @return the block, uninitialized
+     */
+    void *allocate(size_t size);
+
+    /**
+     * @brief Releases a block returned by allocate
+     * @param size size given to allocate for this block
+     */
+    void release(void *p, size_t size);
+
+#ifdef MELD_ARENA_CHECKS
+    //!< Allocator statistics of all arenas
+    static inline std::atomic<uint64_t> nbAllocations{0}; //!< blocks handed out by allocate
+    static inline std::atomic<uint64_t> nbReleases{0}; //!< blocks given back to release
+    static inline std::atomic<uint64_t> nbMallocs{0}; //!< calls to malloc
+    static inline std::atomic<uint64_t> nbFrees{0}; //!< calls to free
+    static inline std::atomic<uint64_t> nbLiveBlocks{0}; //!< blocks currently allocated
+    static inline std::atomic<uint64_t> nbRulesFired{0}; //!< rules executed by the VMs, for the per rule ratios
+
+    //!< @return true if p is a block of an arena that has not been released
+    static bool isLive(void *p);
+
+    /**
+     * @brief Prints the allocator statistics
+     * @param nbReferenced number of live blocks still referenced by the VM databases and queues,
+     *  the others are leaked or held by messages in flight
+     */
+    static void printReport(uint64_t nbReferenced);
+#endif
+
+private:
+    struct FreeBlock { FreeBlock *next; };
+
+    FreeBlock *freeLists[NB_CLASSES] = {}; //!< released blocks, by size class
+
+    MeldArena(MeldArena const&); //<! Disable copy constructor
+    void operator=(MeldArena const&); //<! Disable assignment operator
+
+    //!< @return size class of a block of size bytes
+    static size_t sizeClass(size_t size) {
+        return size == 0 ? 1 : (size + GRANULARITY - 1) / GRANULARITY;
+    }
+};
+
+}
+
+#endif /* MELDINTERPARENA_H_ */
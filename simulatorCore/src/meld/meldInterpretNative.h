@@ -0,0 +1,84 @@
+/*! @file meldInterpretNative.h
+ * @brief Interface between the MeldInterpret VM and the native code of a Meld program
+ *
+ * MeldInterpretVM::writeNativeCode translates the code of the predicates and rules of a program,
+ *  and the bodies of their iterations, to C++ functions which replace process_bytecode for this
+ *  code. Control flow, register moves, arithmetic, comparisons and the moves of tuple fields whose
+ *  offset is resolved by predecode are compiled. The instructions which use the database, the
+ *  messages or the module (iterations, ALLOC, ADDLINEAR, SEND...) are run by the VM through
+ *  MeldNativeContext::execute.
+ *
+ * The generated file only includes this header. It is compiled into the program plugin by
+ *  utilities/meldProgramPlugin.sh, or on its own into a library loaded by
+ *  MeldInterpretVM::readNativeCode.
+ */
+
+#ifndef MELDINTERPNATIVE_H_
+#define MELDINTERPNATIVE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define MELD_NATIVE_VERSION 1 /** version of this interface, checked when the code is loaded */
+
+/** VM running the native code */
+struct MeldNativeContext {
+    void *vm; /** MeldInterpretVM of the module */
+    const unsigned char *prog; /** meld_prog */
+    /** Runs the instruction at pc with the interpreter, returns the result of an iteration
+     * (RET_RET, RET_NEXT, RET_LINEAR, RET_DERIVED or RET_NO_RET) and RET_NO_RET otherwise */
+    int (*execute)(void *vm, const unsigned char *pc, void *tuple, int isNew, int isLinear,
+                   uintptr_t *reg);
+};
+
+/** Native code of the bytecode at one offset, with the arguments and result of process_bytecode */
+typedef int (*MeldNativeFunction)(const MeldNativeContext *ctx, void *tuple, int isNew,
+                                  int isLinear, uintptr_t *reg, unsigned char state);
+
+/** Entry of meld_native_code */
+struct MeldNativeEntry {
+    uint32_t offset; /** offset of the code in meld_prog */
+    MeldNativeFunction function;
+};
+
+/** Symbols defined by the generated code */
+extern "C" {
+    /** Compiled code, terminated by an entry without function */
+    extern const MeldNativeEntry meld_native_code[];
+    /** MELD_NATIVE_VERSION of the generator */
+    extern const uint32_t meld_native_version;
+    /** Size and FNV-1a hash of the bytecode the code was generated from */
+    extern const uint32_t meld_native_program_size;
+    extern const uint64_t meld_native_program_hash;
+}
+
+/** Values of the registers, as read by the MELD_INT, MELD_FLOAT, MELD_BOOL and MELD_NODE_ID
+ * macros of the VM */
+static inline int32_t meld_native_int(const uintptr_t *r) {
+    int32_t v;
+    memcpy(&v, r, sizeof(v));
+    return v;
+}
+
+static inline double meld_native_float(const uintptr_t *r) {
+    double v;
+    memcpy(&v, r, sizeof(v));
+    return v;
+}
+
+static inline unsigned char meld_native_bool(const uintptr_t *r) {
+    unsigned char v;
+    memcpy(&v, r, sizeof(v));
+    return v;
+}
+
+static inline uint16_t meld_native_node_id(const uintptr_t *r) {
+    uint16_t v;
+    memcpy(&v, r, sizeof(v));
+    return v;
+}
+
+/** Address of the field at offset off of the tuple in register r */
+#define MELD_NATIVE_FIELD(reg, r, off) ((unsigned char*)(reg)[r] + (off))
+
+#endif /* MELDINTERPNATIVE_H_ */
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "meldInterpretProfile.h"
+
+using namespace std;
+
+namespace MeldInterpret {
+
+void MeldProfile::resize(size_t nbRules, size_t nbTypes) {
+    ruleFirings.assign(nbRules, 0);
+    ruleTimeNs.assign(nbRules, 0);
+    derived.assign(nbTypes, 0);
+    retracted.assign(nbTypes, 0);
+    sent.assign(nbTypes, 0);
+}
+
+/** Adds src to dst, element by element, growing dst if needed */
+static void addCounters(vector<uint64_t> &dst, const vector<uint64_t> &src) {
+    if (dst.size() < src.size())
+        dst.resize(src.size(), 0);
+    for (size_t i = 0; i < src.size(); i++)
+        dst[i] += src[i];
+}
+
+void MeldProfile::add(const MeldProfile &p) {
+    instructions += p.instructions;
+    addCounters(ruleFirings, p.ruleFirings);
+    addCounters(ruleTimeNs, p.ruleTimeNs);
+    addCounters(derived, p.derived);
+    addCounters(retracted, p.retracted);
+    addCounters(sent, p.sent);
+}
+
+static string label(char **names, size_t nbNames, size_t i, const char *kind) {
+    return i < nbNames && names[i] != NULL ? string(names[i]) : string(kind) + " " + to_string(i);
+}
+
+void MeldProfile::print(char **ruleNames, size_t nbRuleNames,
+                        char **tupleNames, size_t nbTupleNames) const {
+    uint64_t firings = 0, timeNs = 0;
+    vector<size_t> rules;
+    for (size_t r = 0; r < ruleFirings.size(); r++) {
+        firings += ruleFirings[r];
+        timeNs += ruleTimeNs[r];
+        if (ruleFirings[r] > 0)
+            rules.push_back(r);
+    }
+    sort(rules.begin(), rules.end(), [this](size_t a, size_t b) {
+        return ruleTimeNs[a] > ruleTimeNs[b];
+    });
+
+    printf("MeldProfile: %lu instructions executed, %lu rules fired in %.3f ms\n",
+           (unsigned long)instructions, (unsigned long)firings, timeNs / 1e6);
+    printf("MeldProfile: %10s %12s %12s  %s\n", "fired", "time (ms)", "ns/firing", "rule");
+    for (size_t r : rules) {
+        printf("MeldProfile: %10lu %12.3f %12.0f  %s\n", (unsigned long)ruleFirings[r],
+               ruleTimeNs[r] / 1e6, (double)ruleTimeNs[r] / ruleFirings[r],
+               label(ruleNames, nbRuleNames, r, "rule").c_str());
+    }
+
+    vector<size_t> types;
+    for (size_t t = 0; t < derived.size(); t++) {
+        if (derived[t] + retracted[t] + sent[t] > 0)
+            types.push_back(t);
+    }
+    sort(types.begin(), types.end(), [this](size_t a, size_t b) {
+        return derived[a] + retracted[a] + sent[a] > derived[b] + retracted[b] + sent[b];
+    });
+
+    printf("MeldProfile: %10s %12s %12s  %s\n", "derived", "retracted", "sent", "predicate");
+    for (size_t t : types) {
+        printf("MeldProfile: %10lu %12lu %12lu  %s\n", (unsigned long)derived[t],
+               (unsigned long)retracted[t], (unsigned long)sent[t],
+               label(tupleNames, nbTupleNames, t, "predicate").c_str());
+    }
+}
+
+}
@@ -0,0 +1,49 @@
+/*! @file meldInterpretProfile.h
+ * @brief Execution counters of the MeldInterpret VMs, per rule and per predicate
+ */
+
+#ifndef MELDINTERPPROFILE_H_
+#define MELDINTERPPROFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MeldInterpret {
+
+/**
+ * Execution profile of one MeldInterpretVM, or of all the VMs of a run once added up: instructions
+ *  executed, firings and time of each rule, and tuples derived, retracted and sent to neighbors for
+ *  each predicate. Derived and retracted tuples are the ones handled by the VM, whether produced
+ *  locally or received.
+ * The VMs only count with MELD_PROFILE defined, the profile of all the VMs is then printed at the
+ *  end of the run (MeldInterpretVM::printProfile). Without it, the VMs have no profile and no
+ *  counting code.
+ */
+class MeldProfile {
+public:
+    uint64_t instructions = 0; //!< bytecode instructions executed
+    std::vector<uint64_t> ruleFirings; //!< by rule, executions of the rule body
+    std::vector<uint64_t> ruleTimeNs; //!< by rule, time spent in the rule body, in ns
+    std::vector<uint64_t> derived; //!< by predicate, tuples handled as derivations
+    std::vector<uint64_t> retracted; //!< by predicate, tuples handled as retractions
+    std::vector<uint64_t> sent; //!< by predicate, tuples sent to a neighbor
+
+    /** Sets the number of rules and predicates of the program, counters start at 0 */
+    void resize(size_t nbRules, size_t nbTypes);
+
+    /** Adds the counters of p to this profile */
+    void add(const MeldProfile &p);
+
+    /**
+     * @brief Prints the profile, rules by decreasing time and predicates by decreasing activity,
+     *  leaving out the ones with no activity
+     * @param ruleNames labels of the first nbRuleNames rules, the others are printed by number
+     * @param tupleNames labels of the first nbTupleNames predicates, the others are printed by number
+     */
+    void print(char **ruleNames, size_t nbRuleNames, char **tupleNames, size_t nbTupleNames) const;
+};
+
+}
+
+#endif /* MELDINTERPPROFILE_H_ */
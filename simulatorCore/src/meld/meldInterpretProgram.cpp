@@ -0,0 +1,108 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "meldInterpretProgram.h"
+
+using namespace std;
+
+namespace MeldInterpret {
+
+bool MeldProgramImage::write(const string &path, const unsigned char *prog, size_t progSize,
+                             char **tupleNames, size_t nbTypes, char **ruleNames, size_t nbRules) {
+    string names;
+    for (size_t i = 0; i < nbTypes; i++)
+        names.append(tupleNames[i], strlen(tupleNames[i]) + 1);
+    for (size_t i = 0; i < nbRules; i++)
+        names.append(ruleNames[i], strlen(ruleNames[i]) + 1);
+
+    MeldImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MELD_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(MeldImageHeader);
+    header.progSize = progSize;
+    header.nbTypes = nbTypes;
+    header.nbRules = nbRules;
+    header.namesSize = names.size();
+
+    ofstream fout(path, ios::out | ios::binary | ios::trunc);
+    fout.write((const char*)&header, sizeof(header));
+    fout.write((const char*)prog, progSize);
+    fout.write(names.data(), names.size());
+    return fout.good();
+}
+
+bool MeldProgramImage::load(const string &path) {
+    release();
+
+#ifndef WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            data = (const char*)addr;
+            size = st.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+#endif
+
+    if (data == NULL) {
+        ifstream fin(path, ios::in | ios::binary);
+        if (!fin) return false;
+        buffer.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    // Validate header and sections bounds
+    const MeldImageHeader *h = (const MeldImageHeader*)data;
+    if (size < sizeof(MeldImageHeader)
+        || memcmp(h->magic, MELD_IMAGE_MAGIC, sizeof(h->magic)) != 0
+        || h->version != VERSION
+        || h->headerSize != sizeof(MeldImageHeader)
+        || h->progSize < 2
+        || (uint64_t)sizeof(MeldImageHeader) + h->progSize + h->namesSize != size
+        || (h->namesSize > 0 && data[size - 1] != '\0')) {
+        release();
+        return false;
+    }
+
+    // Index the names, the VMs only see arrays of char*, as built by the .bb reader
+    const char *name = data + sizeof(MeldImageHeader) + h->progSize;
+    for (uint32_t i = 0; i < h->nbTypes + h->nbRules; i++) {
+        if (name >= data + size) {
+            release();
+            return false;
+        }
+        (i < h->nbTypes ? tupleNames : ruleNames).push_back((char*)name);
+        name += strlen(name) + 1;
+    }
+
+    return true;
+}
+
+void MeldProgramImage::release() {
+#ifndef WIN32
+    if (mapped) munmap((void*)data, size);
+#endif
+    vector<char>().swap(buffer);
+    vector<char*>().swap(tupleNames);
+    vector<char*>().swap(ruleNames);
+    data = NULL;
+    size = 0;
+    mapped = false;
+}
+
+}
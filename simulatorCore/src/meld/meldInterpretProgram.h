@@ -0,0 +1,82 @@
+/*! @file meldInterpretProgram.h
+ * @brief Precompiled, memory-mappable image of a Meld program
+ *
+ * An image holds the bytecode and the predicate and rule names of a program as read from a .bb
+ *  file, so that it is loaded without any text parsing. The file is mapped read-only and shared
+ *  by all the VMs of the simulation: meld_prog and the names point into the mapping.
+ *
+ * File layout (host byte order):
+ *  [MeldImageHeader][bytecode][predicate names, '\0' terminated][rule names, '\0' terminated]
+ */
+
+#ifndef MELDINTERPPROGRAM_H_
+#define MELDINTERPPROGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MeldInterpret {
+
+#define MELD_IMAGE_MAGIC "MELDPIMG" /** first 8 bytes of every program image */
+#define MELD_IMAGE_EXT ".mpi"       /** extension of program images */
+
+/** Header of a program image */
+struct MeldImageHeader {
+    char magic[8];       /** MELD_IMAGE_MAGIC */
+    uint32_t version;    /** MeldProgramImage::VERSION of the writer */
+    uint32_t headerSize; /** sizeof(MeldImageHeader) of the writer */
+    uint32_t progSize;   /** size of the bytecode */
+    uint32_t nbTypes;    /** number of predicate names */
+    uint32_t nbRules;    /** number of rule names */
+    uint32_t namesSize;  /** size of the names, with their terminating '\0' */
+};
+
+/**
+ * Read-only view of a program image, kept for the whole simulation
+ */
+class MeldProgramImage {
+    const char *data = NULL; /** content of the file */
+    size_t size = 0; /** size of the file */
+    bool mapped = false; /** true if data was memory-mapped, false if read into buffer */
+    std::vector<char> buffer; /** file content when memory mapping is unavailable */
+    std::vector<char*> tupleNames, ruleNames; /** names, pointing into data */
+
+    MeldProgramImage(MeldProgramImage const&); //<! Disable copy constructor
+    void operator=(MeldProgramImage const&); //<! Disable assignment operator
+public:
+    static const uint32_t VERSION = 1; /** current version of the format */
+
+    MeldProgramImage() {};
+    ~MeldProgramImage() { release(); };
+
+    /**
+     * @brief Writes a program image
+     * @return false if the file could not be written
+     */
+    static bool write(const std::string &path, const unsigned char *prog, size_t progSize,
+                      char **tupleNames, size_t nbTypes, char **ruleNames, size_t nbRules);
+
+    /**
+     * @brief Maps a program image and checks its header and bounds
+     * @return false if path is not a valid image
+     */
+    bool load(const std::string &path);
+
+    /** Unmaps the image */
+    void release();
+
+    const unsigned char *getProgram() const {
+        return (const unsigned char*)data + sizeof(MeldImageHeader);
+    }
+    size_t getProgramSize() const { return ((const MeldImageHeader*)data)->progSize; }
+    char **getTupleNames() { return tupleNames.data(); }
+    char **getRuleNames() { return ruleNames.data(); }
+    size_t getNbTupleNames() const { return tupleNames.size(); }
+    size_t getNbRuleNames() const { return ruleNames.size(); }
+};
+
+}
+
+#endif /* MELDINTERPPROGRAM_H_ */
@@ -19,6 +19,7 @@
 #include "../base/blockCode.h"
 #include "../utils/trace.h"
 #include "../replay/replayExporter.h"
+#include "../replay/traceExporter.h"
 
 using namespace std;
 using us = chrono::microseconds;
@@ -61,6 +62,14 @@ void MeldInterpretScheduler::SemWaitOrReadDebugMessage() {
     }
 }
 
+/** An event of a block may have given work to its VM: received tuple, due delayed tuple,
+ * neighbor change... */
+static inline void wakeUpVM(const EventPtr &pev) {
+    BuildingBlock *block = pev->getConcernedBlock();
+    if (block != NULL)
+        MeldInterpretVM::wakeUp(block);
+}
+
 void *MeldInterpretScheduler::startPaused(/*void *param*/) {
 
     int seed = 500;
@@ -93,6 +102,10 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
     auto pausedTime = systemStartTime - systemStartTime; // zero by default
     cout << TermColor::SchedulerColor << "Scheduler : start order received " << 0 << TermColor::Reset << endl;
 
+    // Open trace file and set its host time origin
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance();
+
     // Write first key frame
     if (ReplayExporter::isReplayEnabled())
         ReplayExporter::getInstance()->writeKeyFrame(0);
@@ -103,9 +116,19 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
         //MeldInterpretDebugger::print("Simulation starts in deterministic mode");
         while (state != ENDED) {
             do {
-                  while (!eventsMap.empty()  || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+                  while (!eventsMap.empty() || !MeldInterpretVM::equilibrium()
+                         || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
                         hasProcessed = true;
 
+                        // The VMs run until equilibrium before time moves on to the next event
+                        if (!MeldInterpretVM::equilibrium()
+                            && (eventsMap.empty() || eventsMap.begin()->first > currentDate)) {
+                            MeldInterpretVM::processAll();
+                            if (terminate.load())
+                                break;
+                            continue;
+                        }
+
                         if (ReplayExporter::isReplayEnabled())
                             ReplayExporter::getInstance()->writeKeyFrameIfNeeded(currentDate);
 
@@ -114,6 +137,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                         pev = (*first).second;
                         currentDate = pev->date;
                         pev->consume();
+                        wakeUpVM(pev);
                         StatsCollector::getInstance().incEventsCount();
                         eventsMap.erase(first);
                         eventsMapSize--;
@@ -176,7 +200,8 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
     case SCHEDULER_MODE_REALTIME:
         OUTPUT << "Realtime mode scheduler\n" << endl;
         //MeldInterpretDebugger::print("Simulation starts in real time mode");
-        while((state != ENDED && !eventsMap.empty()) || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+        while((state != ENDED && (!eventsMap.empty() || !MeldInterpretVM::equilibrium()))
+              || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
             auto systemCurrentTime = get_time::now() - pausedTime;
             auto systemCurrentTimeMax = systemCurrentTime - systemStartTime;
             // currentDate = systemCurrentTimeMax;
@@ -220,6 +245,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                     currentDate = pev->date;
                     //lock();
                     pev->consume();
+                    wakeUpVM(pev);
                     StatsCollector::getInstance().incEventsCount();
                     //unlock();
                     eventsMap.erase(first);
@@ -233,6 +259,11 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                 pev = (*first).second;
             }
 
+            // One pass of the VMs per iteration, they do not wait while they have work
+            const bool vmsBusy = !MeldInterpretVM::equilibrium();
+            if (vmsBusy)
+                MeldInterpretVM::processAll();
+
             if (state == PAUSED) {
                 cout << "paused" << endl;
                 auto pauseBeginning = get_time::now();
@@ -241,7 +272,7 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
                 pausedTime = get_time::now() - pauseBeginning;
             }
 
-            if (!eventsMap.empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE) {
+            if (!vmsBusy && (!eventsMap.empty() || schedulerLength == SCHEDULER_LENGTH_INFINITE)) {
                 std::chrono::milliseconds timespan(5);
                 std::this_thread::sleep_for(timespan);
             }
@@ -276,6 +307,12 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
         glutLeaveMainLoop();
 
     printStats();
+#ifdef MELD_ARENA_CHECKS
+    MeldInterpretVM::checkArenas();
+#endif
+#ifdef MELD_PROFILE
+    MeldInterpretVM::printProfile();
+#endif
 
     terminate.store(true);
 
@@ -286,6 +323,9 @@ void *MeldInterpretScheduler::startPaused(/*void *param*/) {
         ReplayExporter::getInstance()->endExport();
     }
 
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->endExport();
+
     return(NULL);
 }
 
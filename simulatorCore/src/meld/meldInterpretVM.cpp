@@ -1,11 +1,21 @@
 
 #include <iostream>
+#include <fstream>
 #include <cassert>
+#include <chrono>
+#include <set>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <dlfcn.h>
 
 #include "meldInterpretVM.h"
 #include "meldInterpretEvents.h"
 #include "meldInterpretMessages.h"
 #include "meldInterpretScheduler.h"
+#include "meldInterpretProgram.h"
 #include "../events/events.h"
 #include "../motion/translationEvents.h"
 #include "../base/world.h"
@@ -23,10 +33,39 @@ char** MeldInterpretVM::tuple_names;
 char* rule_names_load[] = {(char*)("_init -o node-axioms."), };
 char** MeldInterpretVM::rule_names = rule_names_load;
 
-map<int, MeldInterpretVM*> MeldInterpretVM::vmMap;
+std::vector<MeldInterpretVM*> MeldInterpretVM::vms;
+std::vector<MeldInterpretVM*> MeldInterpretVM::busyVMs;
+std::atomic<unsigned int> MeldInterpretVM::nbBusyVMs(0);
+unsigned int MeldInterpretVM::nbThreads = 1;
 bool MeldInterpretVM::configured = false;
 bool MeldInterpretVM::debugging = false;
 unsigned char * MeldInterpretVM::arguments = NULL;
+std::vector<decoded_fields> MeldInterpretVM::decodedFields;
+std::vector<MeldNativeFunction> MeldInterpretVM::nativeCode;
+bool MeldInterpretVM::nativeDispatch = true;
+extern_funct_type *MeldInterpretVM::program_extern_functs = NULL;
+int *MeldInterpretVM::program_extern_functs_args = NULL;
+
+/** Size of meld_prog and number of names read, 0 if unknown (program plugins) */
+static size_t meld_prog_size = 0;
+static size_t nb_tuple_names = 0;
+static size_t nb_rule_names = 0;
+#ifdef MELD_PROFILE
+/** Execution counters of the VMs already destroyed */
+static MeldProfile retiredProfile;
+#endif
+/** Image of the program when loaded from a program image, shared by all VMs */
+static MeldProgramImage programImage;
+
+/** FNV-1a hash of size bytes, continuing hash h */
+static inline uint64_t hash_bytes(const void *data, size_t size, uint64_t h = 14695981039346656037ULL) {
+    const unsigned char *bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
 
 
 MeldInterpretVM::MeldInterpretVM(BaseSimulator::BuildingBlock *b){
@@ -49,11 +88,20 @@ MeldInterpretVM::MeldInterpretVM(BaseSimulator::BuildingBlock *b){
 #endif
     host = b;
     blockId = (NodeID)b->blockId;
+    extern_functs = program_extern_functs;
+    extern_functs_args = program_extern_functs_args;
+    nativeContext.vm = this;
+    nativeContext.prog = meld_prog;
+    nativeContext.execute = execute_native;
 
     vm_alloc();
     vm_init();
 
-    hasWork = true;
+    hasWork = false;
+    nbChanges = 0;
+    busyIndex = -1;
+    setHasWork(true);
+    buffering = false;
     polling = false;
     deterministicSet = false;
     firstStart = true;
@@ -67,7 +115,9 @@ MeldInterpretVM::MeldInterpretVM(BaseSimulator::BuildingBlock *b){
     enqueue_count(numNeighbors, 1);
     neighbors = (NodeID*)malloc(b->getNbInterfaces() * sizeof(NodeID));
 
-    vmMap.insert(std::pair<int, MeldInterpretVM*>(blockId,this));
+    if (blockId >= vms.size())
+        vms.resize(blockId + 1, NULL);
+    vms[blockId] = this;
 }
 
 MeldInterpretVM::~MeldInterpretVM(){
@@ -83,9 +133,30 @@ MeldInterpretVM::~MeldInterpretVM(){
       tupleEntry = tupleNextEntry;
       }
       }*/
-    free(delayedTuples);
+    if (busyIndex >= 0)
+        leaveBusyVMs();
+    vms[blockId] = NULL;
+#ifdef MELD_PROFILE
+    retiredProfile.add(profile);
+#endif
+
+    for (int i = 0; i < NUM_TYPES; i++) {
+        if (tuples[i] == NULL)
+            continue;
+        /* The record sets of live aggregates hold heap memory, outside of the arena */
+        if (TYPE_IS_AGG(i)) {
+            for (tuple_entry *entry = tuples[i]->head; entry != NULL; entry = entry->next) {
+                tuple_aggregate *agg_queue = static_cast<tuple_aggregate*>(entry->records.agg_queue);
+                if (agg_queue == NULL)
+                    continue;
+                agg_queue->~tuple_aggregate();
+                arena.release(agg_queue, sizeof(tuple_aggregate));
+            }
+        }
+        arena.release(tuples[i], sizeof(tuple_queue));
+    }
+    delete delayedTuples;
     free(tuples);
-    free(newStratTuples);
     free(newTuples);
     free(neighbors);
     free(receivedTuples);
@@ -114,13 +185,10 @@ void MeldInterpretVM::print_newStratTuples(void)
 {
     fprintf(stderr, "\x1b[34m--%d--\tContent of queue newStratTuples: \n",
             blockId);
-    if (newStratTuples) {
-        tuple_pentry *tupleEntry;
-        for (tupleEntry = newStratTuples->queue; tupleEntry != NULL; tupleEntry = tupleEntry->next) {
-            tuple_print(tupleEntry->tuple, stderr);
-            fprintf(stderr, " -- isNew = %d\n", tupleEntry->records.count);
-        }
-    }
+    newStratTuples.for_each([this](tuple_pentry *tupleEntry) {
+        tuple_print(tupleEntry->tuple, stderr);
+        fprintf(stderr, " -- isNew = %d\n", tupleEntry->records.count);
+    });
     fprintf(stderr, "\x1b[0m");
 }
 
@@ -133,9 +201,10 @@ NodeID MeldInterpretVM::get_neighbor_ID(int face){
 /** Enqueue a tuple for execution */
 void MeldInterpretVM::enqueueNewTuple(tuple_t tuple, record_type isNew){
     assert (TUPLE_TYPE(tuple) < NUM_TYPES);
+    nbChanges++;
 
     if (TYPE_IS_STRATIFIED(TUPLE_TYPE(tuple))) {
-        p_enqueue(newStratTuples, TYPE_STRATIFICATION_ROUND(TUPLE_TYPE(tuple)), tuple, 0, isNew);
+        newStratTuples.push(p_alloc(TYPE_STRATIFICATION_ROUND(TUPLE_TYPE(tuple)), tuple, 0, isNew));
     }
     else {
         queue_enqueue(newTuples, tuple, isNew);
@@ -255,6 +324,7 @@ void MeldInterpretVM::init_all_consts(void) {
 void MeldInterpretVM::processOneRule(void) {
     // processing new facts and updating axioms
     waiting = 0;
+    tuple_pentry *entry;
 
     //If there are new tuples
     if(!queue_is_empty(newTuples)) {
@@ -264,45 +334,56 @@ void MeldInterpretVM::processOneRule(void) {
         tuple_handle(tuple, isNew, reg);
         waiting = 1;
         //Else if there are new delayed tuple available
-    } else if (!p_empty(delayedTuples) && p_peek(delayedTuples)->priority <= myGetTime()) {
-        tuple_pentry *entry = p_dequeue(delayedTuples);
+    } else if (delayedTuples != NULL
+               && (entry = delayedTuples->pop_expired(myGetTime())) != NULL) {
 
         tuple_send(entry->tuple, entry->rt, 0, entry->records.count);
-        free(entry);
+        arena.release(entry, sizeof(tuple_pentry));
         waiting = 1;
         //Else if there are new stratified tuple
-    } else if (!(p_empty(newStratTuples))) {
-        tuple_pentry *entry = p_dequeue(newStratTuples);
+    } else if (!newStratTuples.empty()) {
+        entry = newStratTuples.pop();
         tuple_handle(entry->tuple, entry->records.count, reg);
 
-        free(entry);
+        arena.release(entry, sizeof(tuple_pentry));
         //Else if there are no tuple to process
         waiting = 1;
     } else {
-
-        if (!p_empty(delayedTuples)) {
-            waiting = 1;
-        }
-        /** If all tuples have been processed
-         * update rule state and process them if they are ready */
+        /** Delayed tuples which are not due yet are no work: the VM is woken up at their
+         * date by the ComputePredicateEvent scheduled by tuple_send, see wakeUp */
+        /** If all tuples have been processed, fire the first ready rule which changes
+         * something. A ready rule whose body does nothing, e.g. because its guard fails,
+         * is no work, otherwise a VM would never be idle */
         for (int i = 0; i < NUM_RULES; ++i) {
-            //If a rule has all its predicate (considered ACTIVE)
-            if (updateRuleState(i)) {
-                waiting = 1;
+            /** A rule is ready if all its included predicates have facts.
+             * Don't process persistent rules (which is useless)
+             * as they all have only a RETURN instruction.
+             */
+            if (updateRuleState(i) && !RULE_ISPERSISTENT(i)) {
                 /** Set state byte used by DEBUG */
                 meld_byte processState = PROCESS_RULE | (i << 4);
-                /** Don't process persistent rules (which is useless)
-                 * as they all have only a RETURN instruction.
-                 */
-                if (!RULE_ISPERSISTENT(i)) {
-                    /** Trigger execution */
-                    process_bytecode (NULL, RULE_START(i), 1, NOT_LINEAR, reg, processState);
+                const unsigned int changesBefore = nbChanges;
+#ifdef MELD_ARENA_CHECKS
+                MeldArena::nbRulesFired++;
+#endif
+#ifdef MELD_PROFILE
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+                /** Trigger execution */
+                process_bytecode (NULL, RULE_START(i), 1, NOT_LINEAR, reg, processState);
+#ifdef MELD_PROFILE
+                profile.ruleFirings[i]++;
+                profile.ruleTimeNs[i] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+#endif
 
-                    /** After one rule is executed we set the VM on waiting until next call of scheduler*/
-                    i = NUM_RULES;
+                /** After one rule has changed something we set the VM on waiting until next
+                 * call of scheduler */
+                if (nbChanges != changesBefore) {
+                    waiting = 1;
+                    break;
                 }
             }
-            /** else: Rule not ready yet, set status to not waiting until new fact appear */
         }
     }
 
@@ -364,7 +445,7 @@ void MeldInterpretVM::receive_tuple(int isNew, tuple_t tpl, meld_byte face) {
         //tuple_queue *queue = receivedTuples + face;
         tuple_queue *queue = &(receivedTuples[face]);
         if(isNew > 0) {
-            tuple = malloc(tuple_size);
+            tuple = ALLOC_TUPLE(tuple_size);
             memcpy(tuple, rcvdTuple, tuple_size);
             queue_enqueue(queue, tuple, (record_type)isNew);
         } else {
@@ -379,7 +460,7 @@ void MeldInterpretVM::receive_tuple(int isNew, tuple_t tpl, meld_byte face) {
         }
     }
 
-    tuple = malloc(tuple_size);
+    tuple = ALLOC_TUPLE(tuple_size);
     memcpy(tuple, rcvdTuple, tuple_size);
     enqueueNewTuple(tuple, (record_type)isNew);
 }
@@ -387,8 +468,15 @@ void MeldInterpretVM::receive_tuple(int isNew, tuple_t tpl, meld_byte face) {
 /** Sends a tuple to Block of ID rt, with or without delay */
 void MeldInterpretVM::tuple_send(tuple_t tuple, NodeID rt, meld_int delay, int isNew) {
     assert (TUPLE_TYPE(tuple) < NUM_TYPES);
+    nbChanges++;
     if (delay > 0) {
-        p_enqueue(delayedTuples, myGetTime() + delay, tuple, rt, (record_type) isNew);
+        if (delayedTuples == NULL)
+            delayedTuples = new tuple_wheel(myGetTime());
+        const Time due = myGetTime() + delay;
+        delayedTuples->push(p_alloc(due, tuple, rt, (record_type) isNew));
+        /** myGetTime is in ms of local time, the scheduler is in us of simulation time,
+         * 1 us later so that the local time has reached due whatever the clock rounding */
+        schedule(new ComputePredicateEvent(host->getSimulationTime(due * 1000) + 1, host));
         return;
     }
 
@@ -414,8 +502,10 @@ void MeldInterpretVM::tuple_send(tuple_t tuple, NodeID rt, meld_int delay, int i
             ptr->sourceInterface = p2p;
             if(p2p->connectedInterface != NULL)
                 ptr->destinationInterface  = p2p->connectedInterface;
-            MeldInterpret::getScheduler()->schedule(
-                new VMSendMessageEvent(MeldInterpret::getScheduler()->now(), host, ptr, p2p));
+            schedule(new VMSendMessageEvent(MeldInterpret::getScheduler()->now(), host, ptr, p2p));
+#ifdef MELD_PROFILE
+            profile.sent[TUPLE_TYPE(tuple)]++;
+#endif
         }
         else {
             /** This may happen when you delete a block in the simulator */
@@ -431,7 +521,7 @@ meld_byte MeldInterpretVM::updateRuleState(meld_byte rid) {
     int i;
     /** A rule is ready if all included predicates are present in the database */
     for (i = 0; i < RULE_NUM_INCLPREDS(rid); ++i) {
-        if (TUPLES[RULE_INCLPRED_ID(rid, i)].length == 0)
+        if (TUPLES[RULE_INCLPRED_ID(rid, i)] == NULL || TUPLES[RULE_INCLPRED_ID(rid, i)]->length == 0)
             return INACTIVE_RULE;
     }
 
@@ -443,13 +533,16 @@ meld_byte MeldInterpretVM::updateRuleState(meld_byte rid) {
 void MeldInterpretVM::tuple_handle(tuple_t tuple, int isNew, Register *registers) {
     tuple_type type = TUPLE_TYPE(tuple);
     assert (type < NUM_TYPES);
+    nbChanges++;
+#ifdef MELD_PROFILE
+    (isNew > 0 ? profile.derived : profile.retracted)[type]++;
+#endif
     tuple_do_handle(type, tuple, isNew, registers);
 }
 
 /** VM initialization routine */
 void MeldInterpretVM::vm_init(void) {
     init_all_consts();
-    init_fields();
 }
 
 /** Called upon block init (block.bb)
@@ -458,16 +551,17 @@ void MeldInterpretVM::vm_init(void) {
 void MeldInterpretVM::vm_alloc(void) {
 
     // init stuff
-    tuples = (tuple_queue*)calloc(NUM_TYPES, sizeof(tuple_queue));
+    tuples = (tuple_queue**)calloc(NUM_TYPES, sizeof(tuple_queue*));
     newTuples = (tuple_queue*)calloc(1, sizeof(tuple_queue));
-    newStratTuples = (tuple_pqueue*)calloc(1, sizeof(tuple_pqueue));
-    delayedTuples = (tuple_pqueue*)calloc(1, sizeof(tuple_pqueue));
+    delayedTuples = NULL;
     receivedTuples = (tuple_queue*)calloc(host->getNbInterfaces(), sizeof(tuple_queue));
+    indexes.resize(NUM_TYPES);
+#ifdef MELD_PROFILE
+    profile.resize(NUM_RULES, NUM_TYPES);
+#endif
 
     assert(tuples!=NULL);
     assert(newTuples!=NULL);
-    assert(newStratTuples!=NULL);
-    assert(delayedTuples!=NULL);
 }
 
 void MeldInterpretVM::__myassert(string file, int line, string exp) {
@@ -511,36 +605,261 @@ void MeldInterpretVM::setColor(meld_byte color){
 }
 
 void MeldInterpretVM::setLED(meld_byte r, meld_byte g, meld_byte b, meld_byte intensity){
-    BaseSimulator::getScheduler()->schedule(new SetColorEvent(BaseSimulator::getScheduler()->now(), host , (float)r/255, (float)g/255, (float)b/255, (float)intensity/255));
+    schedule(new SetColorEvent(BaseSimulator::getScheduler()->now(), host , (float)r/255, (float)g/255, (float)b/255, (float)intensity/255));
 }
 
 void MeldInterpretVM::moveTo(meld_int x, meld_int y, meld_int z) {
     enqueue_at((meld_int)host->position.pt[0], (meld_int)host->position.pt[1],
                (meld_int)host->position.pt[2], -1);
-    BaseSimulator::getScheduler()->schedule(new TranslationStartEvent(BaseSimulator::getScheduler()->now(),
-                                                                      host, Vector3D(x, y, z)));
+    schedule(new TranslationStartEvent(BaseSimulator::getScheduler()->now(), host, Vector3D(x, y, z)));
+}
+
+void MeldInterpretVM::schedule(Event *ev) {
+    nbChanges++;
+    if (buffering)
+        outbox.push_back(ev);
+    else
+        BaseSimulator::getScheduler()->schedule(ev);
+}
+
+void MeldInterpretVM::setHasWork(bool work) {
+    hasWork = work;
+    if (work && busyIndex < 0)
+        enterBusyVMs();
+    else if (!work && busyIndex >= 0)
+        leaveBusyVMs();
+}
+
+void MeldInterpretVM::enterBusyVMs() {
+    busyIndex = busyVMs.size();
+    busyVMs.push_back(this);
+    nbBusyVMs++;
+}
+
+void MeldInterpretVM::leaveBusyVMs() {
+    /** Move the last VM to the position of this one */
+    MeldInterpretVM *last = busyVMs.back();
+    busyVMs[busyIndex] = last;
+    last->busyIndex = busyIndex;
+    busyVMs.pop_back();
+    busyIndex = -1;
+    nbBusyVMs--;
 }
 
 bool MeldInterpretVM::equilibrium() {
-    map<int, MeldInterpretVM*>::iterator it;
-    for(it = vmMap.begin(); it != vmMap.end(); it++) {
-        MeldInterpretVM *vm = it->second;
-        BaseSimulator::BuildingBlock *buildb = vm->host;
-        if (buildb->getState() < BaseSimulator::BuildingBlock::ALIVE) {
-            continue;
-        }
-        if (vm->hasWork) {
+    /** The blocks are not notified when they stop or are removed: a busy VM of a
+     * block which is no longer alive leaves busyVMs when it is met here, so that
+     * each one is only examined once, until it has work again */
+    while (nbBusyVMs.load() > 0) {
+        MeldInterpretVM *vm = busyVMs.back();
+        if (vm->host->getState() >= BaseSimulator::BuildingBlock::ALIVE)
             return false;
-        }
+        vm->leaveBusyVMs();
     }
     return true;
 }
 
+void MeldInterpretVM::wakeUp(BaseSimulator::BuildingBlock *block) {
+    MeldInterpretVM *vm = getVM(block->blockId);
+    if (vm != NULL)
+        vm->setHasWork(true);
+}
+
+/** Below this number of VMs per thread, a pass costs less than waking up the workers */
+static const size_t minVMsPerThread = 16;
+
+/** Worker threads of processAll, started by the first parallel pass and kept for the next ones.
+ * The VMs of a pass are taken one by one by the workers and by the calling thread */
+class MeldPassPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start, done;
+    std::vector<MeldInterpretVM*> *batch = NULL;
+    std::atomic<size_t> next{0};
+    /* Number of the current pass, and number of workers which have not finished it */
+    unsigned int generation = 0, running = 0;
+    bool stopping = false;
+
+    void work() {
+        for (size_t i = next++; i < batch->size(); i = next++)
+            (*batch)[i]->processOneRule();
+    }
+
+    void loop(unsigned int seen) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            start.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--running == 0)
+                done.notify_one();
+        }
+    }
+
+    void resize(size_t nbWorkers) {
+        if (nbWorkers == workers.size())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for (std::thread &t : workers)
+            t.join();
+        workers.clear();
+        stopping = false;
+        for (size_t t = 0; t < nbWorkers; t++)
+            workers.emplace_back(&MeldPassPool::loop, this, generation);
+    }
+
+public:
+    ~MeldPassPool() {
+        resize(0);
+    }
+
+    /* Runs processOneRule on the VMs of vms, on threads threads including the calling one */
+    void run(std::vector<MeldInterpretVM*> &vms, unsigned int threads) {
+        resize(threads - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch = &vms;
+            next = 0;
+            running = workers.size();
+            generation++;
+        }
+        start.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return running == 0; });
+    }
+};
+static MeldPassPool passPool;
+
+size_t MeldInterpretVM::processAll() {
+    /** Busy VMs of blocks which are no longer alive leave busyVMs */
+    std::vector<MeldInterpretVM*> batch;
+    for (size_t i = 0; i < busyVMs.size();) {
+        MeldInterpretVM *vm = busyVMs[i];
+        if (vm->host->getState() >= BaseSimulator::BuildingBlock::ALIVE) {
+            batch.push_back(vm);
+            i++;
+        } else {
+            vm->leaveBusyVMs();
+        }
+    }
+    std::sort(batch.begin(), batch.end(), [](MeldInterpretVM *a, MeldInterpretVM *b) {
+        return a->blockId < b->blockId;
+    });
+
+    unsigned int threads = nbThreads ? nbThreads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<size_t>(threads, std::max<size_t>(1, batch.size() / minVMsPerThread));
+    if (threads == 1) {
+        for (MeldInterpretVM *vm : batch) {
+            vm->processOneRule();
+            vm->setHasWork(vm->isWaiting());
+        }
+        return batch.size();
+    }
+
+    /** A VM only modifies its own database and queues, and draws from the random generator of
+     * its block: the VMs are independent during a pass. Only the events they create go to the
+     * shared scheduler, they are buffered and scheduled once all VMs are done */
+    for (MeldInterpretVM *vm : batch)
+        vm->buffering = true;
+
+    passPool.run(batch, threads);
+
+    /** Events of the same date are consumed in scheduling order, which is here the block ID
+     * order of a sequential pass. busyVMs is shared, it is only updated here */
+    for (MeldInterpretVM *vm : batch) {
+        vm->setHasWork(vm->isWaiting());
+        vm->buffering = false;
+        for (Event *ev : vm->outbox)
+            BaseSimulator::getScheduler()->schedule(ev);
+        vm->outbox.clear();
+    }
+    return batch.size();
+}
+
+#ifdef MELD_ARENA_CHECKS
+/** Counts the live blocks of a queue: entries, tuples and aggregate record queues */
+static void referenceQueue(tuple_queue *queue, bool isAgg, std::set<void*> &referenced) {
+    for (tuple_entry *entry = queue->head; entry != NULL; entry = entry->next) {
+        referenced.insert(entry);
+        referenced.insert(entry->tuple);
+        if (isAgg && entry->records.agg_queue != NULL) {
+            referenced.insert(entry->records.agg_queue);
+            referenceQueue(entry->records.agg_queue, false, referenced);
+        }
+    }
+}
+
+/** Counts the live blocks of a delayed or stratified tuples queue: entries and tuples */
+template<typename Q> static void referencePQueue(const Q &queue, std::set<void*> &referenced) {
+    queue.for_each([&referenced](tuple_pentry *entry) {
+        referenced.insert(entry);
+        referenced.insert(entry->tuple);
+    });
+}
+
+void MeldInterpretVM::checkArenas() {
+    std::set<void*> referenced;
+    for (MeldInterpretVM *vm : vms) {
+        if (vm == NULL)
+            continue;
+        for (int i = 0; i < NUM_TYPES; i++) {
+            if (vm->tuples[i] == NULL)
+                continue;
+            referenced.insert(vm->tuples[i]);
+            referenceQueue(vm->tuples[i], TYPE_IS_AGG(i), referenced);
+        }
+        referenceQueue(vm->newTuples, false, referenced);
+        for (int i = 0; i < vm->host->getNbInterfaces(); i++)
+            referenceQueue(&vm->receivedTuples[i], false, referenced);
+        referencePQueue(vm->newStratTuples, referenced);
+        if (vm->delayedTuples != NULL)
+            referencePQueue(*vm->delayedTuples, referenced);
+    }
+
+    uint64_t nbReferenced = 0;
+    for (void *p : referenced) {
+        if (MeldArena::isLive(p))
+            nbReferenced++;
+    }
+    MeldArena::printReport(nbReferenced);
+}
+#endif
+
+#ifdef MELD_PROFILE
+void MeldInterpretVM::printProfile() {
+    MeldProfile total;
+    total.resize(NUM_RULES, NUM_TYPES);
+    total.add(retiredProfile);
+    for (MeldInterpretVM *vm : vms) {
+        if (vm != NULL)
+            total.add(vm->profile);
+    }
+    total.print(rule_names, nb_rule_names, tuple_names, nb_tuple_names);
+}
+#endif
+
 void MeldInterpretVM::setConfiguration(string path, bool d){
     debugging = d;
     if(!configured){
         configured = true;
-        readProgram(path);
+        if (path.size() > 3 && path.compare(path.size() - 3, 3, ".so") == 0)
+            readProgramPlugin(path);
+        else if (path.size() > 4 && path.compare(path.size() - 4, 4, MELD_IMAGE_EXT) == 0)
+            readProgramImage(path);
+        else
+            readProgram(path);
+        /** Argument sizes and offsets only depend on the program, they are shared by all VMs */
+        init_fields();
+        predecode();
     }
 }
 
@@ -601,6 +920,7 @@ void MeldInterpretVM::readProgram(string path){
         multi = 1;
     }
     meld_prog = outProg;
+    meld_prog_size = byteCount + 1;
 
     //Reading tuple_names
     int countingTuple = characterCount(tupleString, ',');
@@ -614,10 +934,140 @@ void MeldInterpretVM::readProgram(string path){
         i++;
     }
     tuple_names = outTuple;
+    nb_tuple_names = countingTuple;
+
+    //Reading rule_names, which may contain commas: the names are delimited by their quotes
+    std::vector<char*> outRules;
+    pos = ruleString.find("\"");
+    while (pos != (int)string::npos) {
+        int end = ruleString.find("\"", pos + 1);
+        if (end == (int)string::npos)
+            break;
+        outRules.push_back(strdup(ruleString.substr(pos + 1, end - pos - 1).c_str()));
+        pos = ruleString.find("\"", end + 1);
+    }
+    if (!outRules.empty()) {
+        rule_names = (char**)malloc(outRules.size() * sizeof(char*));
+        std::copy(outRules.begin(), outRules.end(), rule_names);
+    }
+    nb_rule_names = outRules.empty() ? 1 : outRules.size();
 
     OUTPUT << "Program has been loaded" << endl;
 }
 
+void MeldInterpretVM::readProgramImage(string path){
+    if (!programImage.load(path)) {
+        cerr << "error: " << path << " is not a valid Meld program image" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    meld_prog = programImage.getProgram();
+    meld_prog_size = programImage.getProgramSize();
+    tuple_names = programImage.getTupleNames();
+    nb_tuple_names = programImage.getNbTupleNames();
+    rule_names = programImage.getRuleNames();
+    nb_rule_names = programImage.getNbRuleNames();
+
+    OUTPUT << "Program has been loaded from image" << endl;
+}
+
+void MeldInterpretVM::writeProgramImage(string path){
+    if (meld_prog_size == 0) {
+        cerr << "error: only a program read from a .bb file can be converted to an image" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (nb_tuple_names < (size_t)NUM_TYPES || nb_rule_names < (size_t)NUM_RULES) {
+        cerr << "warning: the program names " << nb_tuple_names << " of " << (int)NUM_TYPES
+             << " predicates and " << nb_rule_names << " of " << (int)NUM_RULES << " rules" << endl;
+    }
+    if (!MeldProgramImage::write(path, meld_prog, meld_prog_size, tuple_names, nb_tuple_names,
+                                 rule_names, nb_rule_names)) {
+        cerr << "error: cannot write Meld program image " << path << endl;
+        exit(EXIT_FAILURE);
+    }
+    OUTPUT << "Program image written to " << path << endl;
+}
+
+void MeldInterpretVM::readProgramPlugin(string path){
+    /** The library is never closed: meld_prog and the names point into it */
+    void *plugin = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (plugin == NULL) {
+        cerr << "error: cannot load Meld program " << path << ": " << dlerror() << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    meld_prog = (const unsigned char*)dlsym(plugin, "meld_prog");
+    tuple_names = (char**)dlsym(plugin, "tuple_names");
+    char **names = (char**)dlsym(plugin, "rule_names");
+    if (meld_prog == NULL || tuple_names == NULL || names == NULL) {
+        cerr << "error: " << path << " is not a Meld program plugin"
+             << " (meld_prog, tuple_names or rule_names not found)" << endl;
+        exit(EXIT_FAILURE);
+    }
+    rule_names = names;
+    /** The names are the arrays of the .bb file, with one entry per predicate and rule */
+    nb_tuple_names = NUM_TYPES;
+    nb_rule_names = NUM_RULES;
+    /** Optional, only programs calling external functions define them */
+    program_extern_functs = (extern_funct_type*)dlsym(plugin, "extern_functs");
+    program_extern_functs_args = (int*)dlsym(plugin, "extern_functs_args");
+    /** Defined by the plugins of meldProgramPlugin.sh, needed to check their native code */
+    const unsigned int *size = (const unsigned int*)dlsym(plugin, "meld_prog_size");
+    if (size != NULL)
+        meld_prog_size = *size;
+
+    OUTPUT << "Program has been loaded from plugin" << endl;
+    loadNativeCode(plugin, path);
+}
+
+void MeldInterpretVM::readNativeCode(string path){
+    /** Never closed either, the VMs keep pointers to its functions */
+    void *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL) {
+        cerr << "error: cannot load Meld native code " << path << ": " << dlerror() << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!loadNativeCode(library, path)) {
+        cerr << "error: " << path << " holds no Meld native code (meld_native_code not found)" << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool MeldInterpretVM::loadNativeCode(void *library, const string &path){
+    const MeldNativeEntry *code = (const MeldNativeEntry*)dlsym(library, "meld_native_code");
+    if (code == NULL)
+        return false;
+
+    const uint32_t *version = (const uint32_t*)dlsym(library, "meld_native_version");
+    const uint32_t *size = (const uint32_t*)dlsym(library, "meld_native_program_size");
+    const uint64_t *hash = (const uint64_t*)dlsym(library, "meld_native_program_hash");
+    if (version == NULL || size == NULL || hash == NULL || *version != MELD_NATIVE_VERSION) {
+        cerr << "error: the Meld native code of " << path
+             << " was generated for another version of the VM" << endl;
+        exit(EXIT_FAILURE);
+    }
+    /** Offsets and field layouts are only valid for the bytecode the code was generated from */
+    if (meld_prog_size == 0 || *size != meld_prog_size
+        || *hash != hash_bytes(meld_prog, meld_prog_size)) {
+        cerr << "error: the Meld native code of " << path
+             << " was generated from another program" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    nativeCode.assign(meld_prog_size, NULL);
+    size_t nbFunctions = 0;
+    for (; code->function != NULL; code++, nbFunctions++) {
+        if (code->offset >= meld_prog_size) {
+            cerr << "error: the Meld native code of " << path << " is corrupted" << endl;
+            exit(EXIT_FAILURE);
+        }
+        nativeCode[code->offset] = code->function;
+    }
+
+    OUTPUT << "Native code of the program has been loaded (" << nbFunctions << " functions)" << endl;
+    return true;
+}
+
 int MeldInterpretVM::characterCount(string in, char character){
     int nFind = -1;
     int nCount = 0;
@@ -658,6 +1108,17 @@ inline void* MeldInterpretVM::eval_field (tuple_t tuple, const unsigned char **p
 
     return GET_TUPLE_FIELD(tuple, field_num);
 }
+/** Same as eval_field for field operand number 'operand' of the instruction, with its offset
+ * resolved by predecode if it has been.
+ */
+inline void* MeldInterpretVM::eval_decoded_field (tuple_t tuple, const unsigned char **pc,
+                                                  const decoded_fields *decoded, int operand) {
+    if (decoded == NULL || decoded->size[operand] == 0)
+        return eval_field(tuple, pc);
+
+    (*pc) += 2;
+    return (unsigned char*)tuple + decoded->offset[operand];
+}
 /** Returns the address of register number 'value'
  * and increment pc past the reg byte.
  */
@@ -834,6 +1295,31 @@ inline void MeldInterpretVM::execute_send_delay (const unsigned char *pc, Regist
     }
 }
 
+/** Returns the value of the match of an ITER instruction at pc
+ * and increments pc past it.
+ */
+Register* MeldInterpretVM::iter_match_value(const unsigned char **pc, Register *reg) {
+    const unsigned char value_type = ITER_MATCH_VAL(*pc);
+
+    if (val_is_int (value_type)) {
+        *pc += 2;
+        return (Register *)eval_int(pc);
+    } else if (val_is_float (value_type)) {
+        *pc += 2;
+        return (Register *)eval_float(pc);
+    } else if (val_is_field (value_type)) {
+        *pc += 2;
+        meld_byte reg_index = FETCH(*pc+1);
+        tuple_t tpl = (tuple_t)reg[reg_index];
+        return (Register *)eval_field(tpl, pc);
+    }
+
+    /** Don't know what to do */
+    fprintf (stderr, "Value type %d not supported yet - don't know what to do.\n", value_type);
+    assert (0);
+    exit (2);
+}
+
 /** Iterate through the database to find a match with tuple read from byte code
  * If there are matches, process the inside of the ITER with all matches sequentially.
  */
@@ -846,19 +1332,46 @@ int MeldInterpretVM::execute_iter (const unsigned char *pc, Register *reg, int i
     /** Reg in which match will be stored during execution*/
     meld_byte reg_store_index = FETCH(pc+10);
 
-    /** produce a random ordering for all tuples of the appropriate type */
-    tuple_entry *entry = TUPLES[type].head;
+    /** With an equality filter on the first argument, only the tuples
+     * under its key in the index can match */
+    std::vector<tuple_entry*> *candidates = NULL;
+    bool indexed = false;
+
+    if (index_first_arg(type)) {
+        const unsigned char *tmppc = pc + PERS_ITER_BASE;
+
+        for (k = 0; k < ITER_NUM_ARGS(pc); ++k) {
+            const unsigned char fieldnum = ITER_MATCH_FIELD(tmppc);
+            Register *val = iter_match_value(&tmppc, reg);
 
-    length = queue_length(&TUPLES[ITER_TYPE(pc)]);
+            if (fieldnum == 0) {
+                candidates = index_find(get_index(type)->byFirstArg,
+                                        hash_bytes(val, TYPE_ARG_SIZE(type, 0)));
+                indexed = true;
+                break;
+            }
+        }
+    }
+
+    /** produce a random ordering for all candidate tuples of the appropriate type */
+    tuple_entry *entry = TUPLES[type] != NULL ? TUPLES[type]->head : NULL;
+
+    if (indexed)
+        length = candidates != NULL ? candidates->size() : 0;
+    else
+        length = TUPLES[type] != NULL ? TUPLES[type]->length : 0;
     list = (void**)malloc(sizeof(tuple_t) * length);
 
     for (i = 0; i < length; i++) {
         unsigned int j = host->getRandomUint() % (i+1);
 
         list[i] = list[j];
-        list[j] = entry->tuple;
-
-        entry = entry->next;
+        if (indexed) {
+            list[j] = (*candidates)[i]->tuple;
+        } else {
+            list[j] = entry->tuple;
+            entry = entry->next;
+        }
     }
 
 #ifdef DEBUG_INSTRS
@@ -885,30 +1398,10 @@ int MeldInterpretVM::execute_iter (const unsigned char *pc, Register *reg, int i
         /** check to see if it matches */
         for (k = 0; k < num_args; ++k) {
             const unsigned char fieldnum = ITER_MATCH_FIELD(tmppc);
-            const unsigned char fieldtype = TYPE_ARG_TYPE(type, fieldnum);
             const unsigned char type_size = TYPE_ARG_SIZE(type, fieldnum);
-            const unsigned char value_type = ITER_MATCH_VAL(tmppc);
 
             Register *field = GET_TUPLE_FIELD(next_tuple, fieldnum);
-            Register *val;
-
-            if (val_is_int (value_type)) {
-                tmppc += 2;
-                val = (Register *)eval_int(&tmppc);
-            } else if (val_is_float (value_type)) {
-                tmppc += 2;
-                val = (Register *)eval_float(&tmppc);
-            } else if (val_is_field (value_type)) {
-                tmppc += 2;
-                meld_byte reg_index = FETCH(tmppc+1);
-                tuple_t tpl = (tuple_t)reg[reg_index];
-                val = (Register *)eval_field(tpl, &tmppc);
-            }  else {
-                /** Don't know what to do */
-                fprintf (stderr, "Type %d not supported yet - don't know what to do.\n", fieldtype);
-                assert (0);
-                exit (2);
-            }
+            Register *val = iter_match_value(&tmppc, reg);
 
             matched = matched && (memcmp(field, val, type_size) == 0);
         }
@@ -1015,7 +1508,7 @@ inline void MeldInterpretVM::execute_remove (const unsigned char *pc, Register *
                 getBlockId(), reg_remove, tuple_names[type], size);
 #endif
 
-        tuple_handle(memcpy(malloc(size),MELD_CONVERT_REG_TO_PTR(reg[reg_remove]), size), -1, reg);
+        tuple_handle(memcpy(ALLOC_TUPLE(size),MELD_CONVERT_REG_TO_PTR(reg[reg_remove]), size), -1, reg);
         reg[REMOVE_REG(pc)] = 0;
     }
 }
@@ -1023,7 +1516,8 @@ inline void MeldInterpretVM::execute_remove (const unsigned char *pc, Register *
 /** ************* MOVE INSTRUCTIONS FUNCTIONS ************* */
 
 /** Moves an int to a tuple field */
-inline void MeldInterpretVM::execute_mvintfield (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvintfield (const unsigned char *pc, Register *reg,
+                                                  const decoded_fields *decoded) {
     ++pc;
 
     Register *src = (Register*)eval_int (&pc);
@@ -1031,9 +1525,8 @@ inline void MeldInterpretVM::execute_mvintfield (const unsigned char *pc, Regist
     meld_byte field_num = FETCH(pc);
 
     tuple_t dst_tuple = (tuple_t)reg[reg_index];
-    tuple_type type = TUPLE_TYPE(dst_tuple);
 
-    Register *dst = (Register*)eval_field (dst_tuple, &pc);
+    Register *dst = (Register*)eval_decoded_field (dst_tuple, &pc, decoded, 0);
 
 
 #ifdef DEBUG_INSTRS
@@ -1041,7 +1534,8 @@ inline void MeldInterpretVM::execute_mvintfield (const unsigned char *pc, Regist
             getBlockId(), MELD_INT(src), reg_index, field_num);
 #endif
 
-    size_t size = TYPE_ARG_SIZE(type, field_num);
+    size_t size = decoded && decoded->size[0] ? decoded->size[0]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(dst_tuple), field_num);
 
     memcpy(dst, src, size);
 }
@@ -1080,7 +1574,8 @@ inline void MeldInterpretVM::execute_mvfloatreg (const unsigned char *pc, Regist
 }
 
 /** Moves pointer to a float to a tuple field */
-inline void MeldInterpretVM::execute_mvfloatfield (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvfloatfield (const unsigned char *pc, Register *reg,
+                                                    const decoded_fields *decoded) {
     ++pc;
 
     Register *src = (Register*)eval_float (&pc);
@@ -1088,9 +1583,8 @@ inline void MeldInterpretVM::execute_mvfloatfield (const unsigned char *pc, Regi
     meld_byte field_num = FETCH(pc);
 
     tuple_t dst_tuple = (tuple_t)reg[reg_index];
-    tuple_type type = TUPLE_TYPE(dst_tuple);
 
-    Register *dst = (Register*)eval_field (dst_tuple, &pc);
+    Register *dst = (Register*)eval_decoded_field (dst_tuple, &pc, decoded, 0);
 
 
 #ifdef DEBUG_INSTRS
@@ -1098,19 +1592,21 @@ inline void MeldInterpretVM::execute_mvfloatfield (const unsigned char *pc, Regi
             getBlockId(), MELD_FLOAT(src), reg_index, field_num);
 #endif
 
-    size_t size = TYPE_ARG_SIZE(type, field_num);
+    size_t size = decoded && decoded->size[0] ? decoded->size[0]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(dst_tuple), field_num);
 
     memcpy(dst, src, size);
 }
 
 /** Moves pointer to a tuple field to a register */
-inline void MeldInterpretVM::execute_mvfieldreg (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvfieldreg (const unsigned char *pc, Register *reg,
+                                                  const decoded_fields *decoded) {
     ++pc;
     meld_byte field_reg = FETCH(pc+1);
     meld_byte field_num = FETCH(pc);
 
     tuple_t tpl = (tuple_t)reg[field_reg];
-    Register *src = (Register*)eval_field (tpl, &pc);
+    Register *src = (Register*)eval_decoded_field (tpl, &pc, decoded, 0);
 
     meld_byte reg_index = FETCH(pc);
     Register *dst = (Register*)eval_reg (reg_index, &pc, reg);
@@ -1119,15 +1615,15 @@ inline void MeldInterpretVM::execute_mvfieldreg (const unsigned char *pc, Regist
     printf ("--%d--\t MOVE FIELD %d.%d TO reg %d\n",
             getBlockId(), field_reg, field_num,
             reg_index);
-#else
-    (void)field_num;
 #endif
-    size_t size = TYPE_ARG_SIZE(TUPLE_TYPE(tpl), field_num);
+    size_t size = decoded && decoded->size[0] ? decoded->size[0]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(tpl), field_num);
     memcpy(dst, src, size);
 }
 
 /** Moves value pointed at by a register to a field */
-inline void MeldInterpretVM::execute_mvregfield (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvregfield (const unsigned char *pc, Register *reg,
+                                                  const decoded_fields *decoded) {
     ++pc;
 
     meld_byte reg_index = FETCH(pc);
@@ -1137,34 +1633,34 @@ inline void MeldInterpretVM::execute_mvregfield (const unsigned char *pc, Regist
     meld_byte field_num = FETCH(pc);
 
     tuple_t field_tpl = (tuple_t)reg[field_reg];
-    tuple_type type = TUPLE_TYPE(field_tpl);
-    Register *dst = (Register*)eval_field (field_tpl, &pc);
+    Register *dst = (Register*)eval_decoded_field (field_tpl, &pc, decoded, 0);
 
 #ifdef DEBUG_INSTRS
     printf ("--%d--\t MOVE REG %d TO FIELD %d.%d\n",
             getBlockId(), reg_index, field_reg, field_num);
 #endif
 
-    size_t size = TYPE_ARG_SIZE(type, field_num);
+    size_t size = decoded && decoded->size[0] ? decoded->size[0]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(field_tpl), field_num);
 
     memcpy(dst, src, size);
 }
 
 /** Moves content of a tuple field to another */
-inline void MeldInterpretVM::execute_mvfieldfield (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvfieldfield (const unsigned char *pc, Register *reg,
+                                                    const decoded_fields *decoded) {
     ++pc;
     meld_byte src_field_reg = FETCH(pc+1);
     meld_byte src_field_num = FETCH(pc);
 
     tuple_t src_field_tpl = (tuple_t)reg[src_field_reg];
-    Register *src = (Register*)eval_field (src_field_tpl, &pc);
+    Register *src = (Register*)eval_decoded_field (src_field_tpl, &pc, decoded, 0);
 
     meld_byte dst_field_reg = FETCH(pc+1);
     meld_byte dst_field_num = FETCH(pc);
 
     tuple_t dst_field_tpl = (tuple_t)reg[dst_field_reg];
-    tuple_type type = TUPLE_TYPE(dst_field_tpl);
-    Register *dst = (Register*)eval_field (dst_field_tpl, &pc);
+    Register *dst = (Register*)eval_decoded_field (dst_field_tpl, &pc, decoded, 1);
 
 #ifdef DEBUG_INSTRS
     printf ("--%d--\t MOVE FIELD %d.%d TO FIELD %d.%d\n",
@@ -1174,13 +1670,15 @@ inline void MeldInterpretVM::execute_mvfieldfield (const unsigned char *pc, Regi
     (void) src_field_num;
 #endif
 
-    size_t size = TYPE_ARG_SIZE(type, dst_field_num);
+    size_t size = decoded && decoded->size[1] ? decoded->size[1]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(dst_field_tpl), dst_field_num);
 
     memcpy(dst, src, size);
 }
 
 /** Moves blockId to a tuple field */
-inline void MeldInterpretVM::execute_mvhostfield (const unsigned char *pc, Register *reg) {
+inline void MeldInterpretVM::execute_mvhostfield (const unsigned char *pc, Register *reg,
+                                                   const decoded_fields *decoded) {
     ++pc;
 
     Register *src = (Register*)EVAL_HOST;
@@ -1189,15 +1687,15 @@ inline void MeldInterpretVM::execute_mvhostfield (const unsigned char *pc, Regis
     meld_byte field_num = FETCH(pc);
 
     tuple_t field_tpl = (tuple_t)reg[field_reg];
-    tuple_type type = TUPLE_TYPE(field_tpl);
-    Register *dst = (Register*)eval_field (field_tpl, &pc);
+    Register *dst = (Register*)eval_decoded_field (field_tpl, &pc, decoded, 0);
 
 #ifdef DEBUG_INSTRS
     printf ("--%d--\t MOVE HOST TO FIELD %d.%d\n",
             getBlockId(), field_reg, field_num);
 #endif
 
-    size_t size = TYPE_ARG_SIZE(type, field_num);
+    size_t size = decoded && decoded->size[0] ? decoded->size[0]
+        : TYPE_ARG_SIZE(TUPLE_TYPE(field_tpl), field_num);
 
     memcpy(dst, src, size);
 }
@@ -1738,6 +2236,7 @@ void MeldInterpretVM::queue_push_tuple(tuple_queue *queue, tuple_entry *entry) {
         queue->tail = entry;
     }
     else {
+        entry->prev = queue->tail;
         queue->tail->next = entry;
         queue->tail = entry;
     }
@@ -1752,6 +2251,8 @@ tuple_t MeldInterpretVM::queue_pop_tuple(tuple_queue *_queue) {
 
         if (_queue->head == NULL)
             _queue->tail = NULL;
+        else
+            _queue->head->prev = NULL;
     }
 
     return entry;
@@ -1762,26 +2263,30 @@ tuple_t MeldInterpretVM::queue_dequeue_pos(tuple_queue *_queue, tuple_entry **po
     tuple_entry *next = (*pos)->next;
     _queue->length--;
 
-    if (entry == _queue->tail) {
-        if(entry == _queue->head)
-            _queue->tail = NULL;
-        else
-            _queue->tail = (tuple_entry *)pos; /** previous */
-    }
+    if (entry == _queue->tail)
+        _queue->tail = entry->prev;
+    else
+        next->prev = entry->prev;
 
     *pos = next;
 
     tuple_t tuple = entry->tuple;
-    free(entry);
+    arena.release(entry, sizeof(tuple_entry));
 
     return tuple;
 }
 
+/** Removes entry from queue in constant time, returns its tuple */
+tuple_t MeldInterpretVM::queue_remove(tuple_queue *queue, tuple_entry *entry) {
+    return queue_dequeue_pos(queue, entry->prev != NULL ? &entry->prev->next : &queue->head);
+}
+
 tuple_entry* MeldInterpretVM::queue_enqueue(tuple_queue *_queue, tuple_t tuple, record_type isNew) {
-    tuple_entry *entry = (tuple_entry*)malloc(sizeof(tuple_entry));
+    tuple_entry *entry = (tuple_entry*)arena.allocate(sizeof(tuple_entry));
     entry->tuple = tuple;
     entry->records = isNew;
     entry->next = NULL;
+    entry->prev = NULL;
     queue_push_tuple(_queue, entry);
     _queue->length++;
     return entry;
@@ -1796,39 +2301,279 @@ tuple_t MeldInterpretVM::queue_dequeue(tuple_queue *queue, int *isNew) {
     if(isNew)
         *isNew = entry->records.count;
 
-    free(entry);
+    arena.release(entry, sizeof(tuple_entry));
 
     return tuple;
 }
 
-tuple_pentry* MeldInterpretVM::p_dequeue(tuple_pqueue *q) {
-    tuple_pentry *ret = q->queue;
+/** ************* DATABASE INDEX FUNCTIONS ************* */
 
-    if(q->queue != NULL)
-        q->queue = q->queue->next;
+/** Key of a tuple in the byTuple index: all of its bytes, but the aggregated field
+ * of aggregates, which is recomputed in place */
+uint64_t MeldInterpretVM::tuple_key(tuple_type type, tuple_t tuple) {
+    if (TYPE_IS_AGG(type) && !TYPE_IS_LINEAR(type)) {
+        unsigned char field_aggregate = AGG_FIELD(TYPE_AGGREGATE(type));
+        size_t sizeBegin = TYPE_FIELD_SIZE + TYPE_ARG_OFFSET(type, field_aggregate);
+        size_t sizeOffset = sizeBegin + TYPE_ARG_SIZE(type, field_aggregate);
 
-    return ret;
+        return hash_bytes((char*)tuple + sizeOffset, TYPE_SIZE(type) - sizeOffset,
+                          hash_bytes(tuple, sizeBegin));
+    }
+
+    return hash_bytes(tuple, TYPE_SIZE(type));
+}
+
+/** Returns true if tuples of type are indexed on their first argument,
+ * which must exist and not be an aggregated field */
+bool MeldInterpretVM::index_first_arg(tuple_type type) {
+    if (TYPE_NUMARGS(type) == 0)
+        return false;
+
+    return !(TYPE_IS_AGG(type) && !TYPE_IS_LINEAR(type)
+             && AGG_FIELD(TYPE_AGGREGATE(type)) == 0);
+}
+
+tuple_index* MeldInterpretVM::get_index(tuple_type type) {
+    if (!indexes[type])
+        indexes[type].reset(new tuple_index());
+
+    return indexes[type].get();
+}
+
+/** Adds a database entry to the indexes of its type */
+void MeldInterpretVM::index_insert(tuple_type type, tuple_entry *entry) {
+    tuple_index *index = get_index(type);
+
+    index->byTuple[tuple_key(type, entry->tuple)].push_back(entry);
+    if (index_first_arg(type))
+        index->byFirstArg[hash_bytes(GET_TUPLE_FIELD(entry->tuple, 0),
+                                     TYPE_ARG_SIZE(type, 0))].push_back(entry);
+}
+
+static void index_erase(tuple_hash_index &index, uint64_t key, tuple_entry *entry) {
+    tuple_hash_index::iterator it = index.find(key);
+    assert(it != index.end());
+
+    std::vector<tuple_entry*> &entries = it->second;
+    entries.erase(std::find(entries.begin(), entries.end(), entry));
+    if (entries.empty())
+        index.erase(it);
 }
 
-void MeldInterpretVM::p_enqueue(tuple_pqueue *queue, Time priority, tuple_t tuple,
-                                NodeID rt, record_type isNew) {
-    tuple_pentry *entry = (tuple_pentry*)malloc(sizeof(tuple_pentry));
+/** Removes a database entry from the indexes of its type, before it is dequeued */
+void MeldInterpretVM::index_remove(tuple_type type, tuple_entry *entry) {
+    tuple_index *index = get_index(type);
+
+    index_erase(index->byTuple, tuple_key(type, entry->tuple), entry);
+    if (index_first_arg(type))
+        index_erase(index->byFirstArg, hash_bytes(GET_TUPLE_FIELD(entry->tuple, 0),
+                                                  TYPE_ARG_SIZE(type, 0)), entry);
+}
+
+/** Returns the record of an aggregate equal to tuple, NULL if there is none */
+tuple_entry* MeldInterpretVM::record_find(tuple_type type, tuple_t tuple) {
+    std::vector<tuple_entry*> *candidates = index_find(get_index(type)->byRecord,
+                                                       hash_bytes(tuple, TYPE_SIZE(type)));
+
+    for (size_t c = 0; candidates != NULL && c < candidates->size(); c++) {
+        if (memcmp((*candidates)[c]->tuple, tuple, TYPE_SIZE(type)) == 0)
+            return (*candidates)[c];
+    }
+
+    return NULL;
+}
+
+/** Returns the entries of key in index, in database order, or NULL if there is none.
+ * Entries sharing a hash do not necessarily match, they must still be compared. */
+std::vector<tuple_entry*>* MeldInterpretVM::index_find(tuple_hash_index &index, uint64_t key) {
+    tuple_hash_index::iterator it = index.find(key);
+
+    return it != index.end() ? &it->second : NULL;
+}
+
+tuple_pentry* MeldInterpretVM::p_alloc(Time priority, tuple_t tuple, NodeID rt, record_type isNew) {
+    tuple_pentry *entry = (tuple_pentry*)arena.allocate(sizeof(tuple_pentry));
 
     entry->tuple = tuple;
     entry->records = isNew;
     entry->priority = priority;
     entry->rt = rt;
+    entry->next = NULL;
+
+    return entry;
+}
 
+/** ************* DELAYED AND STRATIFIED TUPLES QUEUES ************* */
+
+void tuple_wheel::push(tuple_pentry *entry) {
+    size++;
+    insert(entry);
+}
+
+tuple_pentry *tuple_wheel::pop_expired(Time date) {
+    if (date >= current)
+        advance(date);
+
+    tuple_pentry *entry = expired;
+    if (entry == NULL)
+        return NULL;
+
+    expired = entry->next;
+    if (expired == NULL)
+        expired_tail = NULL;
+    entry->next = NULL;
+    size--;
+    return entry;
+}
+
+/** Inserts entry after the entries of the same or an earlier date */
+void tuple_wheel::insert_sorted(tuple_pentry **list, tuple_pentry *entry) {
     tuple_pentry **spot;
-    for (spot = &(queue->queue);
-         *spot != NULL &&
-             (*spot)->priority <= priority;
-         spot = &((*spot)->next));
+    for (spot = list; *spot != NULL && (*spot)->priority <= entry->priority; spot = &((*spot)->next));
 
     entry->next = *spot;
     *spot = entry;
 }
 
+void tuple_wheel::insert(tuple_pentry *entry) {
+    if (entry->priority < current) {
+        /** Pushed late, behind the date the wheel has been advanced to */
+        insert_sorted(&expired, entry);
+        if (entry->next == NULL)
+            expired_tail = entry;
+        return;
+    }
+
+    /** The level is given by the highest bits in which the date differs from current */
+    uint64_t diff = entry->priority ^ current;
+    int level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / SLOT_BITS;
+    if (level >= LEVELS) {
+        insert_sorted(&overflow, entry);
+        return;
+    }
+
+    int slot = (entry->priority >> (level * SLOT_BITS)) & (SLOTS - 1);
+    tuple_pentry *&last = slots[level][slot];
+    if (last == NULL) {
+        entry->next = entry;
+    } else {
+        entry->next = last->next;
+        last->next = entry;
+    }
+    last = entry;
+    occupied[level] |= (uint64_t)1 << slot;
+}
+
+tuple_pentry *tuple_wheel::take_slot(int level, int slot) {
+    tuple_pentry *last = slots[level][slot];
+    tuple_pentry *first = last->next;
+
+    last->next = NULL;
+    slots[level][slot] = NULL;
+    occupied[level] &= ~((uint64_t)1 << slot);
+    return first;
+}
+
+void tuple_wheel::advance(Time date) {
+    while (current <= date && size > 0) {
+        /** Entries of level 0 are due at the date of their slot, in the block of SLOTS ms of current */
+        int index = current & (SLOTS - 1);
+        uint64_t due = occupied[0] & (~(uint64_t)0 << index);
+        if (due != 0) {
+            int slot = __builtin_ctzll(due);
+            Time slotDate = (current & ~(Time)(SLOTS - 1)) | slot;
+            if (slotDate > date)
+                break;
+
+            tuple_pentry *first = take_slot(0, slot);
+            tuple_pentry *last = first;
+            while (last->next != NULL)
+                last = last->next;
+            if (expired_tail == NULL)
+                expired = first;
+            else
+                expired_tail->next = first;
+            expired_tail = last;
+
+            current = slotDate + 1;
+            if ((current & (SLOTS - 1)) != 0)
+                continue;
+        } else {
+            /** Jump to the next date at which the entries of a slot of an upper level, or of the
+             * overflow, have to be moved down. The slot of current is empty at every level. */
+            Time next = 0;
+            int nextLevel = -1;
+            for (int level = 1; level < LEVELS && nextLevel < 0; level++) {
+                int shift = level * SLOT_BITS;
+                int index = (current >> shift) & (SLOTS - 1);
+                uint64_t pending = index == SLOTS - 1 ? 0 : occupied[level] & (~(uint64_t)0 << (index + 1));
+                if (pending != 0) {
+                    next = ((current >> (shift + SLOT_BITS)) << (shift + SLOT_BITS))
+                        | ((Time)__builtin_ctzll(pending) << shift);
+                    nextLevel = level;
+                }
+            }
+            if (nextLevel < 0 && overflow != NULL) {
+                next = ((current >> (LEVELS * SLOT_BITS)) + 1) << (LEVELS * SLOT_BITS);
+                nextLevel = LEVELS;
+            }
+            /** current may reach date + 1, but not cross the start of a block with pending entries */
+            if (nextLevel < 0 || next > date + 1)
+                break;
+            current = next;
+        }
+
+        /** current starts a new block: move down the entries of the slot of current at the
+         * highest level it starts a block of, the slots of the levels below are empty */
+        int level = 1;
+        while (level < LEVELS && ((current >> (level * SLOT_BITS)) & (SLOTS - 1)) == 0)
+            level++;
+        tuple_pentry *entry;
+        if (level == LEVELS) {
+            entry = overflow;
+            overflow = NULL;
+        } else {
+            int slot = (current >> (level * SLOT_BITS)) & (SLOTS - 1);
+            entry = slots[level][slot] != NULL ? take_slot(level, slot) : NULL;
+        }
+        while (entry != NULL) {
+            tuple_pentry *next = entry->next;
+            insert(entry);
+            entry = next;
+        }
+    }
+
+    if (current <= date)
+        current = date + 1;
+}
+
+void tuple_strata::push(tuple_pentry *entry) {
+    entry->next = NULL;
+
+    /** Buckets are few, the lowest rounds are at the back */
+    size_t b = buckets.size();
+    while (b > 0 && buckets[b - 1].round < entry->priority)
+        b--;
+
+    if (b > 0 && buckets[b - 1].round == entry->priority) {
+        buckets[b - 1].tail->next = entry;
+        buckets[b - 1].tail = entry;
+    } else {
+        buckets.insert(buckets.begin() + b, bucket { entry->priority, entry, entry });
+    }
+}
+
+tuple_pentry *tuple_strata::pop() {
+    bucket &lowest = buckets.back();
+    tuple_pentry *entry = lowest.head;
+
+    lowest.head = entry->next;
+    if (lowest.head == NULL)
+        buckets.pop_back();
+    entry->next = NULL;
+    return entry;
+}
+
 /** ************* VM INITIALIZATION FUNCTIONS ************* */
 
 static int type;
@@ -1893,6 +2638,656 @@ void MeldInterpretVM::init_fields(void) {
     }
 }
 
+/** ************* PRE-DECODING ************* */
+
+/** Tuple type held by each register before an instruction, -1 if it depends on the execution */
+typedef std::array<tuple_type, 32> reg_types;
+
+/** State of predecode at an instruction */
+struct predecode_state {
+    bool reached = false;
+    /** Offset of the iteration whose body contains the instruction, -1 outside of any */
+    int loop = -1;
+    reg_types types;
+};
+
+/** Stores the positions of the field operands of a field move instruction in fields,
+ * returns their number, 0 for other instructions */
+static int field_operands(const unsigned char *pc, const unsigned char *fields[2]) {
+    switch (FETCH(pc)) {
+    case MVINTFIELD_INSTR:
+        fields[0] = pc + 5;
+        return 1;
+    case MVFIELDFIELD_INSTR:
+    case MVFIELDFIELDR_INSTR:
+        fields[0] = pc + 1;
+        fields[1] = pc + 3;
+        return 2;
+    case MVFIELDREG_INSTR:
+    case MVHOSTFIELD_INSTR:
+        fields[0] = pc + 1;
+        return 1;
+    case MVREGFIELD_INSTR:
+        fields[0] = pc + 2;
+        return 1;
+    case MVFLOATFIELD_INSTR:
+        fields[0] = pc + 9;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+void MeldInterpretVM::predecode(void) {
+    std::vector<predecode_state> states;
+    std::vector<size_t> pending;
+    bool failed = false;
+    reg_types unknown;
+    unknown.fill(-1);
+
+    /** Merges types into the state of the instruction at offset, which is examined again if its
+     * state changed. Code shared by different iteration bodies is not supported */
+    auto reach = [&](size_t offset, const reg_types &types, int loop) {
+        if (meld_prog_size > 0 && offset >= meld_prog_size) {
+            failed = true;
+            return;
+        }
+        if (offset >= states.size())
+            states.resize(offset + 1);
+        predecode_state &s = states[offset];
+        if (!s.reached) {
+            s.reached = true;
+            s.loop = loop;
+            s.types = types;
+            pending.push_back(offset);
+            return;
+        }
+        if (s.loop != loop) {
+            failed = true;
+            return;
+        }
+        bool changed = false;
+        for (int r = 0; r < 32; r++) {
+            if (s.types[r] != -1 && s.types[r] != types[r]) {
+                s.types[r] = -1;
+                changed = true;
+            }
+        }
+        if (changed)
+            pending.push_back(offset);
+    };
+
+    /** The tuple of a predicate is in register 0 when its code runs, see process_bytecode */
+    for (tuple_type i = 0; i < NUM_TYPES; i++) {
+        reg_types types = unknown;
+        types[0] = i;
+        reach(TYPE_START(i) - meld_prog, types, -1);
+    }
+    for (int i = 0; i < NUM_RULES; i++)
+        reach(RULE_START(i) - meld_prog, unknown, -1);
+
+    while (!pending.empty() && !failed) {
+        const size_t offset = pending.back();
+        pending.pop_back();
+        const unsigned char *pc = meld_prog + offset;
+        reg_types types = states[offset].types;
+        const int loop = states[offset].loop;
+        /** Size of the instruction if execution goes on with the next one, 0 otherwise */
+        size_t next = 0;
+
+        switch (FETCH(pc)) {
+        case RETURN_INSTR:
+        case NEXT_INSTR:
+        case END_LINEAR_INSTR:
+        case RETURN_LINEAR_INSTR:
+        case RETURN_DERIVED_INSTR:
+            /** The next match of the iteration runs its body with the registers left by this one */
+            if (loop >= 0) {
+                const unsigned char *iter = meld_prog + loop;
+                types[VAL_REG(FETCH(iter+10))] = ITER_TYPE(iter);
+                reach(loop + ITER_INNER_JUMP(iter), types, loop);
+            }
+            break;
+
+        case PERS_ITER_INSTR:
+        case LINEAR_ITER_INSTR: {
+            reg_types inner = types;
+            inner[VAL_REG(FETCH(pc+10))] = ITER_TYPE(pc);
+            reach(offset + ITER_INNER_JUMP(pc), inner, offset);
+            /** The body may have changed any register, or not run at all */
+            reach(offset + ITER_OUTER_JUMP(pc), unknown, loop);
+            break;
+        }
+
+        case RESET_LINEAR_INSTR:
+            reach(offset + RESET_LINEAR_BASE, types, -1);
+            reach(offset + RESET_LINEAR_JUMP(pc), unknown, loop);
+            break;
+
+        case IF_INSTR:
+            reach(offset + IF_JUMP(pc+2), types, loop);
+            next = IF_BASE;
+            break;
+
+        case IF_ELSE_INSTR:
+            reach(offset + IF_JUMP(pc+2), types, loop);
+            next = IF_ELSE_BASE;
+            break;
+
+        case JUMP_INSTR:
+            reach(offset + 1 + JUMP_BASE + IF_JUMP(pc+1), types, loop);
+            break;
+
+        case ALLOC_INSTR:
+            types[VAL_REG(FETCH(pc+2))] = FETCH(pc+1);
+            next = ALLOC_BASE;
+            break;
+
+        case MVREGREG_INSTR:
+            types[VAL_REG(FETCH(pc+2))] = types[VAL_REG(FETCH(pc+1))];
+            next = MVREGREG_BASE;
+            break;
+
+        /** Instructions writing a value which is not a tuple to a register */
+        case NOT_INSTR:
+            types[VAL_REG(FETCH(pc+2))] = -1;
+            next = NOT_BASE;
+            break;
+        case MVINTREG_INSTR:
+            types[VAL_REG(FETCH(pc+5))] = -1;
+            next = MVINTREG_BASE;
+            break;
+        case MVFIELDREG_INSTR:
+            types[VAL_REG(FETCH(pc+3))] = -1;
+            next = MVFIELDREG_BASE;
+            break;
+        case MVFLOATREG_INSTR:
+            types[VAL_REG(FETCH(pc+9))] = -1;
+            next = MVFLOATREG_BASE;
+            break;
+        case MVHOSTREG_INSTR:
+            types[VAL_REG(FETCH(pc+1))] = -1;
+            next = MVHOSTREG_BASE;
+            break;
+        case ADDRNOTEQUAL_INSTR: case ADDREQUAL_INSTR: case INTMINUS_INSTR: case INTEQUAL_INSTR:
+        case INTNOTEQUAL_INSTR: case INTPLUS_INSTR: case INTLESSER_INSTR: case INTGREATEREQUAL_INSTR:
+        case BOOLOR_INSTR: case INTLESSEREQUAL_INSTR: case INTGREATER_INSTR: case INTMUL_INSTR:
+        case INTDIV_INSTR: case FLOATPLUS_INSTR: case FLOATMINUS_INSTR: case FLOATMUL_INSTR:
+        case FLOATDIV_INSTR: case FLOATEQUAL_INSTR: case FLOATNOTEQUAL_INSTR: case FLOATLESSER_INSTR:
+        case FLOATLESSEREQUAL_INSTR: case FLOATGREATER_INSTR: case FLOATGREATEREQUAL_INSTR:
+        case BOOLEQUAL_INSTR: case BOOLNOTEQUAL_INSTR: case INTMOD_INSTR:
+            types[VAL_REG(FETCH(pc+3))] = -1;
+            next = OP_BASE;
+            break;
+
+        /** Instructions leaving the registers unchanged */
+        case RULE_INSTR:
+            next = RULE_BASE;
+            break;
+        case RULE_DONE_INSTR:
+            next = RULE_DONE_BASE;
+            break;
+        case MVINTFIELD_INSTR:
+            next = MVINTFIELD_BASE;
+            break;
+        case MVFIELDFIELD_INSTR:
+        case MVFIELDFIELDR_INSTR:
+            next = MVFIELDFIELD_BASE;
+            break;
+        case MVPTRREG_INSTR:
+            next = MVPTRREG_BASE;
+            break;
+        case MVREGFIELD_INSTR:
+            next = MVREGFIELD_BASE;
+            break;
+        case MVHOSTFIELD_INSTR:
+            next = MVHOSTFIELD_BASE;
+            break;
+        case MVFLOATFIELD_INSTR:
+            next = MVFLOATFIELD_BASE;
+            break;
+        case ADDLINEAR_INSTR:
+        case ADDPERS_INSTR:
+            next = ADDPERS_BASE;
+            break;
+
+        /** Instructions which may handle tuples, running their code with the same registers */
+        case SEND_INSTR:
+            types = unknown;
+            next = SEND_BASE;
+            break;
+        case SEND_DELAY_INSTR:
+            types = unknown;
+            next = SEND_DELAY_BASE;
+            break;
+        case CALL1_INSTR:
+            types = unknown;
+            next = CALL1_BASE;
+            break;
+        case RUNACTION_INSTR:
+            types = unknown;
+            next = RUNACTION_BASE;
+            break;
+        case UPDATE_INSTR:
+            types = unknown;
+            next = UPDATE_BASE;
+            break;
+        case REMOVE_INSTR:
+            types = unknown;
+            next = REMOVE_BASE;
+            break;
+
+        default:
+            /** Not implemented by process_bytecode, which stops the VM there */
+            break;
+        }
+
+        if (next > 0)
+            reach(offset + next, types, loop);
+    }
+
+    /** Without a complete analysis, the field operands are decoded during execution */
+    decodedFields.clear();
+    if (failed)
+        return;
+
+    decodedFields.resize(states.size(), decoded_fields());
+    for (size_t offset = 0; offset < states.size(); offset++) {
+        const unsigned char *fields[2];
+        const int nbFields = states[offset].reached ? field_operands(meld_prog + offset, fields) : 0;
+
+        for (int k = 0; k < nbFields; k++) {
+            const meld_byte field_num = VAL_FIELD_NUM(fields[k]);
+            const meld_byte field_reg = FETCH(fields[k]+1);
+            if (field_reg >= 32)
+                continue;
+            const tuple_type type = states[offset].types[field_reg];
+            if (type < 0 || type >= NUM_TYPES || field_num >= TYPE_NUMARGS(type)
+                || TYPE_FIELD_SIZE + TYPE_ARG_OFFSET(type, field_num) > 0xff)
+                continue;
+            decodedFields[offset].offset[k] = TYPE_FIELD_SIZE + TYPE_ARG_OFFSET(type, field_num);
+            decodedFields[offset].size[k] = TYPE_ARG_SIZE(type, field_num);
+        }
+    }
+}
+
+/** ************* NATIVE CODE ************* */
+
+/** Mnemonics of the binary operations, with the C++ expression computing their result from the
+ * values of their operands a and b, as in the execute_ functions */
+struct native_operation {
+    meld_byte opcode;
+    const char *name;
+    const char *value; /** meld_native_ function reading the operands */
+    const char *op;
+};
+
+static const native_operation native_operations[] = {
+    { ADDRNOTEQUAL_INSTR, "ADDRNOTEQUAL", "meld_native_node_id", "!=" },
+    { ADDREQUAL_INSTR, "ADDREQUAL", "meld_native_node_id", "==" },
+    { INTMINUS_INSTR, "INTMINUS", "meld_native_int", "-" },
+    { INTEQUAL_INSTR, "INTEQUAL", "meld_native_int", "==" },
+    { INTNOTEQUAL_INSTR, "INTNOTEQUAL", "meld_native_int", "!=" },
+    { INTPLUS_INSTR, "INTPLUS", "meld_native_int", "+" },
+    { INTLESSER_INSTR, "INTLESSER", "meld_native_int", "<" },
+    { INTGREATEREQUAL_INSTR, "INTGREATEREQUAL", "meld_native_int", ">=" },
+    { BOOLOR_INSTR, "BOOLOR", "meld_native_bool", "|" },
+    { INTLESSEREQUAL_INSTR, "INTLESSEREQUAL", "meld_native_int", "<=" },
+    { INTGREATER_INSTR, "INTGREATER", "meld_native_int", ">" },
+    { INTMUL_INSTR, "INTMUL", "meld_native_int", "*" },
+    { INTDIV_INSTR, "INTDIV", "meld_native_int", "/" },
+    { INTMOD_INSTR, "INTMOD", "meld_native_int", "%" },
+    { FLOATPLUS_INSTR, "FLOATPLUS", "meld_native_float", "+" },
+    { FLOATMINUS_INSTR, "FLOATMINUS", "meld_native_float", "-" },
+    { FLOATMUL_INSTR, "FLOATMUL", "meld_native_float", "*" },
+    { FLOATDIV_INSTR, "FLOATDIV", "meld_native_float", "/" },
+    { FLOATEQUAL_INSTR, "FLOATEQUAL", "meld_native_float", "==" },
+    { FLOATNOTEQUAL_INSTR, "FLOATNOTEQUAL", "meld_native_float", "!=" },
+    { FLOATLESSER_INSTR, "FLOATLESSER", "meld_native_float", "<" },
+    { FLOATLESSEREQUAL_INSTR, "FLOATLESSEREQUAL", "meld_native_float", "<=" },
+    { FLOATGREATER_INSTR, "FLOATGREATER", "meld_native_float", ">" },
+    { FLOATGREATEREQUAL_INSTR, "FLOATGREATEREQUAL", "meld_native_float", ">=" },
+    { BOOLEQUAL_INSTR, "BOOLEQUAL", "meld_native_bool", "==" },
+    { BOOLNOTEQUAL_INSTR, "BOOLNOTEQUAL", "meld_native_bool", "!=" },
+};
+
+/** Instructions run by the VM for the native code (see execute_native), with their size */
+struct native_step {
+    meld_byte opcode;
+    const char *name;
+    size_t size;
+};
+
+static const native_step native_steps[] = {
+    { SEND_INSTR, "SEND", SEND_BASE },
+    { SEND_DELAY_INSTR, "SEND_DELAY", SEND_DELAY_BASE },
+    { ALLOC_INSTR, "ALLOC", ALLOC_BASE },
+    { ADDLINEAR_INSTR, "ADDLINEAR", ADDLINEAR_BASE },
+    { ADDPERS_INSTR, "ADDPERS", ADDPERS_BASE },
+    { RUNACTION_INSTR, "RUNACTION", RUNACTION_BASE },
+    { REMOVE_INSTR, "REMOVE", REMOVE_BASE },
+    { MVHOSTFIELD_INSTR, "MVHOSTFIELD", MVHOSTFIELD_BASE },
+    { MVHOSTREG_INSTR, "MVHOSTREG", MVHOSTREG_BASE },
+};
+
+/** Initializer of a C array holding the size bytes at pc */
+static string native_bytes(const unsigned char *pc, size_t size) {
+    ostringstream out;
+    out << "{";
+    for (size_t i = 0; i < size; i++)
+        out << (i ? ", " : " ") << (int)pc[i];
+    out << " }";
+    return out.str();
+}
+
+void MeldInterpretVM::writeNativeCode(string path){
+    if (meld_prog_size == 0) {
+        cerr << "error: native code can only be generated for a program whose size is known"
+             << " (.bb file, program image or plugin of meldProgramPlugin.sh)" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /** Entry points of process_bytecode: code of the predicates and rules, bodies of the
+     * iterations and of RESET_LINEAR, each one is compiled to a function */
+    std::map<size_t, string> entries;
+    std::vector<size_t> pending;
+    auto addEntry = [&](size_t offset, const string &description) {
+        if (entries.insert(std::make_pair(offset, description)).second)
+            pending.push_back(offset);
+    };
+    for (tuple_type i = 0; i < NUM_TYPES; i++)
+        addEntry(TYPE_START(i) - meld_prog, "code of predicate "
+                 + ((size_t)i < nb_tuple_names ? string(tuple_names[i]) : to_string(i)));
+    for (int i = 0; i < NUM_RULES; i++)
+        addEntry(RULE_START(i) - meld_prog, "code of rule " + to_string(i));
+
+    ostringstream functions;
+    std::vector<size_t> compiled;
+    size_t nbInterpreted = 0;
+    while (!pending.empty()) {
+        const size_t entry = pending.back();
+        pending.pop_back();
+
+        /** Statements of each reachable instruction, instruction executed after it if it does not
+         * return, and targets of the conditional jumps */
+        std::map<size_t, string> code;
+        std::map<size_t, size_t> successors;
+        std::set<size_t> labels;
+        std::vector<size_t> reachable(1, entry);
+        std::vector<std::pair<size_t, string>> bodies;
+        bool supported = true;
+
+        while (!reachable.empty() && supported) {
+            const size_t offset = reachable.back();
+            reachable.pop_back();
+            if (code.count(offset))
+                continue;
+            if (offset >= meld_prog_size) {
+                supported = false;
+                break;
+            }
+
+            const unsigned char *pc = meld_prog + offset;
+            const decoded_fields *decoded = decodedAt(pc);
+            ostringstream s;
+            /** Size of the instruction if execution goes on with the next one */
+            size_t size = 0;
+            /** Instruction executed next otherwise, for the instructions which do not return */
+            size_t successor = 0;
+            bool hasSuccessor = false;
+            auto goTo = [&](size_t target) {
+                successor = target;
+                hasSuccessor = true;
+            };
+            auto jump = [&](size_t target) {
+                labels.insert(target);
+                reachable.push_back(target);
+                return "goto L" + to_string(target) + ";";
+            };
+            const string step = "ctx->execute(ctx->vm, ctx->prog + " + to_string(offset)
+                + ", tuple, isNew, isLinear, reg);";
+            /** Registers as in eval_reg, tuples of the field operands as in the execute_ functions */
+            auto r = [&](size_t i) { return "reg[" + to_string(VAL_REG(pc[i])) + "]"; };
+            auto field = [&](size_t i, int operand) {
+                return "MELD_NATIVE_FIELD(reg, " + to_string(pc[i]) + ", "
+                    + to_string(decoded->offset[operand]) + ")";
+            };
+            auto isDecoded = [&](int nbOperands) {
+                return decoded != NULL && decoded->size[0] != 0
+                    && (nbOperands == 1 || decoded->size[1] != 0);
+            };
+            /** Constant operands are copied as read by memcpy, which may go past their end */
+            auto hasBytes = [&](size_t from, size_t count) {
+                return offset + from + count <= meld_prog_size;
+            };
+
+            switch (FETCH(pc)) {
+            case RETURN_INSTR:
+                s << "return 0; /* RETURN */";
+                break;
+            case NEXT_INSTR:
+                s << "return 1; /* NEXT */";
+                break;
+            case END_LINEAR_INSTR:
+            case RETURN_LINEAR_INSTR:
+                s << "return 2; /* RETURN_LINEAR */";
+                break;
+            case RETURN_DERIVED_INSTR:
+                s << "return 3; /* RETURN_DERIVED */";
+                break;
+
+            case PERS_ITER_INSTR:
+            case LINEAR_ITER_INSTR: {
+                /** As DECIDE_NEXT_ITER */
+                const size_t body = offset + ITER_INNER_JUMP(pc);
+                bodies.push_back(std::make_pair(body, "body of the iteration at " + to_string(offset)));
+                s << "{ /* ITER " << ((size_t)ITER_TYPE(pc) < nb_tuple_names
+                                      ? string(tuple_names[ITER_TYPE(pc)]) : to_string(ITER_TYPE(pc)))
+                  << " */\n"
+                  << "        const int ret = " << step << "\n"
+                  << "        if (ret == 2 || (ret == 3 && isLinear) || ret == 0)\n"
+                  << "            return ret;\n"
+                  << "    }";
+                goTo(offset + ITER_OUTER_JUMP(pc));
+                break;
+            }
+            case RESET_LINEAR_INSTR:
+                bodies.push_back(std::make_pair(offset + RESET_LINEAR_BASE,
+                                                "linear code of RESET_LINEAR at " + to_string(offset)));
+                s << step << " /* RESET_LINEAR */";
+                goTo(offset + RESET_LINEAR_JUMP(pc));
+                break;
+
+            case RULE_INSTR:
+                s << "/* RULE " << (int)pc[1] << " */";
+                size = RULE_BASE;
+                break;
+            case RULE_DONE_INSTR:
+                s << "/* RULE_DONE */";
+                size = RULE_DONE_BASE;
+                break;
+            case MVPTRREG_INSTR:
+                s << "/* MVPTRREG */";
+                size = MVPTRREG_BASE;
+                break;
+
+            case IF_INSTR:
+            case IF_ELSE_INSTR:
+                s << "if (!(unsigned char)" << r(1) << ") " << jump(offset + IF_JUMP(pc+2))
+                  << " /* IF */";
+                size = FETCH(pc) == IF_INSTR ? IF_BASE : IF_ELSE_BASE;
+                break;
+            case JUMP_INSTR:
+                s << "/* JUMP */";
+                goTo(offset + 1 + JUMP_BASE + IF_JUMP(pc+1));
+                break;
+
+            case NOT_INSTR:
+                s << r(2) << " = meld_native_bool(&" << r(1) << ") > 0 ? 0 : 1; /* NOT */";
+                size = NOT_BASE;
+                break;
+            case MVREGREG_INSTR:
+                s << r(2) << " = " << r(1) << "; /* MVREGREG */";
+                size = MVREGREG_BASE;
+                break;
+            case MVINTREG_INSTR:
+            case MVFLOATREG_INSTR: {
+                const bool isInt = FETCH(pc) == MVINTREG_INSTR;
+                const size_t dst = isInt ? 5 : 9;
+                if (!hasBytes(1, sizeof(Register))) {
+                    supported = false;
+                    break;
+                }
+                Register value;
+                memcpy(&value, pc + 1, sizeof(Register));
+                s << r(dst) << " = (uintptr_t)0x" << hex << (unsigned long long)value << dec
+                  << "ULL; /* " << (isInt ? "MVINTREG " : "MVFLOATREG ");
+                if (isInt)
+                    s << MELD_INT(pc + 1);
+                else
+                    s << MELD_FLOAT(pc + 1);
+                s << " */";
+                size = isInt ? MVINTREG_BASE : MVFLOATREG_BASE;
+                break;
+            }
+
+            case MVFIELDREG_INSTR:
+                size = MVFIELDREG_BASE;
+                if (!isDecoded(1))
+                    break;
+                s << "memcpy(&" << r(3) << ", " << field(2, 0) << ", " << (int)decoded->size[0]
+                  << "); /* MVFIELDREG */";
+                break;
+            case MVREGFIELD_INSTR:
+                size = MVREGFIELD_BASE;
+                if (!isDecoded(1))
+                    break;
+                s << "memcpy(" << field(3, 0) << ", &" << r(1) << ", " << (int)decoded->size[0]
+                  << "); /* MVREGFIELD */";
+                break;
+            case MVFIELDFIELD_INSTR:
+            case MVFIELDFIELDR_INSTR:
+                size = MVFIELDFIELD_BASE;
+                if (!isDecoded(2))
+                    break;
+                s << "memcpy(" << field(4, 1) << ", " << field(2, 0) << ", "
+                  << (int)decoded->size[1] << "); /* MVFIELDFIELD */";
+                break;
+            case MVINTFIELD_INSTR:
+            case MVFLOATFIELD_INSTR: {
+                const bool isInt = FETCH(pc) == MVINTFIELD_INSTR;
+                size = isInt ? MVINTFIELD_BASE : MVFLOATFIELD_BASE;
+                if (!isDecoded(1) || !hasBytes(1, decoded->size[0]))
+                    break;
+                s << "{ static const unsigned char k[] = " << native_bytes(pc + 1, decoded->size[0])
+                  << "; memcpy(" << field(isInt ? 6 : 10, 0) << ", k, " << (int)decoded->size[0]
+                  << "); } /* " << (isInt ? "MVINTFIELD" : "MVFLOATFIELD") << " */";
+                break;
+            }
+
+            case CALL1_INSTR:
+                size = CALL1_BASE;
+                /** Only node2int is implemented by execute_call1 */
+                if (pc[1] == NODE2INT_FUNC)
+                    s << r(2) << " = meld_native_node_id(&" << r(5) << "); /* CALL1 node2int */";
+                break;
+            case UPDATE_INSTR:
+                s << "if ((state & 0x0f) == " << PROCESS_ITER << ") " << step << " /* UPDATE */";
+                size = UPDATE_BASE;
+                break;
+
+            default: {
+                const meld_byte opcode = FETCH(pc);
+                for (const native_operation &op : native_operations) {
+                    if (op.opcode == opcode) {
+                        s << r(3) << " = (uintptr_t)(" << op.value << "(&" << r(1) << ") " << op.op
+                          << " " << op.value << "(&" << r(2) << ")); /* " << op.name << " */";
+                        size = OP_BASE;
+                    }
+                }
+                for (const native_step &st : native_steps) {
+                    if (st.opcode == opcode) {
+                        s << step << " /* " << st.name << " */";
+                        size = st.size;
+                    }
+                }
+                /** Not implemented by process_bytecode, which stops the VM there */
+                if (size == 0)
+                    supported = false;
+                break;
+            }
+            }
+
+            /** Field moves not resolved by predecode are run by the VM */
+            if (supported && size > 0 && s.str().empty())
+                s << step << " /* field move */";
+            code[offset] = s.str();
+            if (size > 0)
+                goTo(offset + size);
+            if (hasSuccessor) {
+                successors[offset] = successor;
+                reachable.push_back(successor);
+            }
+        }
+
+        for (const std::pair<size_t, string> &body : bodies)
+            addEntry(body.first, body.second);
+        if (!supported) {
+            nbInterpreted++;
+            continue;
+        }
+
+        /** Instructions in program order, the first one executed is the entry */
+        if (code.begin()->first != entry)
+            labels.insert(entry);
+        for (auto it = code.begin(); it != code.end(); ++it) {
+            auto following = std::next(it);
+            if (successors.count(it->first)
+                && (following == code.end() || following->first != successors[it->first]))
+                labels.insert(successors[it->first]);
+        }
+        functions << "/* " << entries[entry] << " */\n"
+                  << "static int meld_native_" << entry << "(const MeldNativeContext *ctx, void *tuple,"
+                  << " int isNew, int isLinear,\n"
+                  << "        uintptr_t *reg, unsigned char state) {\n"
+                  << "    (void)ctx; (void)tuple; (void)isNew; (void)isLinear; (void)reg; (void)state;\n";
+        if (code.begin()->first != entry)
+            functions << "    goto L" << entry << ";\n";
+        for (auto it = code.begin(); it != code.end(); ++it) {
+            if (labels.count(it->first))
+                functions << "L" << it->first << ":\n";
+            functions << "    " << it->second << "\n";
+            auto following = std::next(it);
+            if (successors.count(it->first)
+                && (following == code.end() || following->first != successors[it->first]))
+                functions << "    goto L" << successors[it->first] << ";\n";
+        }
+        functions << "}\n\n";
+        compiled.push_back(entry);
+    }
+
+    ofstream out(path.c_str());
+    out << "/* Native code of a Meld program, generated by MeldInterpretVM::writeNativeCode */\n"
+        << "#include \"meld/meldInterpretNative.h\"\n\n"
+        << functions.str()
+        << "extern \"C\" {\n"
+        << "const uint32_t meld_native_version = " << MELD_NATIVE_VERSION << ";\n"
+        << "const uint32_t meld_native_program_size = " << meld_prog_size << ";\n"
+        << "const uint64_t meld_native_program_hash = 0x" << hex
+        << (unsigned long long)hash_bytes(meld_prog, meld_prog_size) << dec << "ULL;\n"
+        << "const MeldNativeEntry meld_native_code[] = {\n";
+    std::sort(compiled.begin(), compiled.end());
+    for (size_t entry : compiled)
+        out << "    { " << entry << ", meld_native_" << entry << " },\n";
+    out << "    { 0, 0 }\n};\n}\n";
+    if (!out.good()) {
+        cerr << "error: cannot write Meld native code " << path << endl;
+        exit(EXIT_FAILURE);
+    }
+    OUTPUT << "Native code of " << compiled.size() << " entry points written to " << path
+           << ", " << nbInterpreted << " left to the interpreter" << endl;
+}
+
 /** Get TYPE id for useful types */
 void MeldInterpretVM::init_consts() {
     tuple_type i;
@@ -1906,60 +3301,61 @@ void MeldInterpretVM::init_consts() {
 
 /** ************* AGGREGATE RELATED FUNCTIONS ************* */
 
-inline bool MeldInterpretVM::aggregate_accumulate(int agg_type, void *acc, void *obj, int count) {
+void tuple_aggregate::update(const void *value, int oldCount, int newCount) {
+    int delta = std::max(newCount, 0) - std::max(oldCount, 0);
+
     switch (agg_type) {
-    case AGG_SET_UNION_INT:
-    case AGG_SET_UNION_FLOAT:
-        assert(false);
-        return false;
+    case AGG_SUM_INT:
+        sum_int += MELD_INT(value) * delta;
+        return;
 
-    case AGG_FIRST:
-        return false;
+    case AGG_SUM_FLOAT:
+        sum_float += MELD_FLOAT(value) * (meld_float)delta;
+        return;
 
     case AGG_MAX_INT:
-        if (MELD_INT(obj) > MELD_INT(acc)) {
-            MELD_INT(acc) = MELD_INT(obj);
-            return true;
-        } else
-            return false;
-
     case AGG_MIN_INT:
-        if (MELD_INT(obj) < MELD_INT(acc)) {
-            MELD_INT(acc) = MELD_INT(obj);
-            return true;
-        } else
-            return false;
-
-    case AGG_SUM_INT:
-        MELD_INT(acc) += MELD_INT(obj) * count;
-        return false;
-
     case AGG_MAX_FLOAT:
-        if(MELD_FLOAT(obj) > MELD_FLOAT(acc)) {
-            MELD_FLOAT(acc) = MELD_FLOAT(obj);
-            return true;
-        } else
-            return false;
+    case AGG_MIN_FLOAT: {
+        /** only the presence of a record matters, not its count */
+        meld_float v = (agg_type == AGG_MAX_INT || agg_type == AGG_MIN_INT) ?
+            (meld_float)MELD_INT(value) : MELD_FLOAT(value);
+        if (oldCount <= 0 && newCount > 0)
+            values.insert(v);
+        else if (oldCount > 0 && newCount <= 0)
+            values.erase(values.find(v));
+        return;
+    }
 
-    case AGG_MIN_FLOAT:
-        if(MELD_FLOAT(obj) < MELD_FLOAT(acc)) {
-            MELD_FLOAT(acc) = MELD_FLOAT(obj);
-            return true;
-        } else
-            return false;
+    default:
+        /** AGG_FIRST is the value of the first record */
+        return;
+    }
+}
 
+void tuple_aggregate::get(void *acc) const {
+    switch (agg_type) {
+    case AGG_SUM_INT:
+        MELD_INT(acc) = sum_int;
+        return;
     case AGG_SUM_FLOAT:
-        MELD_FLOAT(acc) += MELD_FLOAT(obj) * (meld_float)count;
-        return false;
-
-    case AGG_SUM_LIST_INT:
-    case AGG_SUM_LIST_FLOAT:
-        assert(false);
-        return false;
+        MELD_FLOAT(acc) = sum_float;
+        return;
+    case AGG_MAX_INT:
+        MELD_INT(acc) = (meld_int)*values.rbegin();
+        return;
+    case AGG_MIN_INT:
+        MELD_INT(acc) = (meld_int)*values.begin();
+        return;
+    case AGG_MAX_FLOAT:
+        MELD_FLOAT(acc) = *values.rbegin();
+        return;
+    case AGG_MIN_FLOAT:
+        MELD_FLOAT(acc) = *values.begin();
+        return;
     }
 
     assert(0);
-    while(1);
 }
 
 inline bool MeldInterpretVM::aggregate_changed(int agg_type, void *v1, void *v2) {
@@ -2053,35 +3449,26 @@ inline void MeldInterpretVM::aggregate_free(tuple_t tuple, unsigned char field_a
 inline void MeldInterpretVM::aggregate_recalc(tuple_entry *agg, Register *reg, bool first_run) {
     tuple_type type = TUPLE_TYPE(agg->tuple);
 
-    tuple_entry *cur;
-
     int agg_type = AGG_AGG(TYPE_AGGREGATE(type));
     int agg_field = AGG_FIELD(TYPE_AGGREGATE(type));
-    tuple_queue *agg_queue = agg->records.agg_queue;
+    tuple_aggregate *agg_queue = static_cast<tuple_aggregate*>(agg->records.agg_queue);
     tuple_entry *agg_list = agg_queue->head;
     tuple_t tuple = agg_list->tuple;
 
-    void* start = GET_TUPLE_FIELD(tuple, agg_field);
-
     /** make copy */
     size_t size = TYPE_ARG_SIZE(type, agg_field);
-    void* accumulator = malloc(size);
+    void* accumulator = arena.allocate(size);
 
-    aggregate_seed(agg_type, accumulator, start, agg_list->records.count, size);
+    if (agg_type == AGG_FIRST)
+        aggregate_seed(agg_type, accumulator, GET_TUPLE_FIELD(tuple, agg_field),
+                       agg_list->records.count, size);
+    else
+        agg_queue->get(accumulator);
 
-    /** calculate offsets to copy right side to aggregated tuple */
+    /** calculate offsets to copy right side to aggregated tuple, the records of an aggregate
+     * only differ by their aggregated field */
     size_t size_offset = TYPE_FIELD_SIZE + TYPE_ARG_OFFSET(type, agg_field) + TYPE_ARG_SIZE(type, agg_field);
     size_t total_copy = TYPE_SIZE(type) - size_offset;
-    tuple_t target_tuple = NULL;
-
-    if (total_copy > 0)
-        target_tuple = tuple;
-
-    for (cur = agg_list->next; cur != NULL; cur = cur->next) {
-        if(aggregate_accumulate(agg_type, accumulator,
-                                GET_TUPLE_FIELD(cur->tuple, agg_field), cur->records.count))
-            target_tuple = cur->tuple;
-    }
 
     void *acc_area = GET_TUPLE_FIELD(agg->tuple, agg_field);
 
@@ -2091,12 +3478,12 @@ inline void MeldInterpretVM::aggregate_recalc(tuple_entry *agg, Register *reg, b
         process_bytecode(agg->tuple, TYPE_START(type), -1, NOT_LINEAR, reg, PROCESS_TUPLE);
         aggregate_free(agg->tuple, agg_field, agg_type);
         memcpy(acc_area, accumulator, size);
-        if (total_copy > 0) /** copy right side from target tuple */
-            memcpy(((unsigned char *)agg->tuple) + size_offset, ((unsigned char *)target_tuple) + size_offset, total_copy);
+        if (total_copy > 0) /** copy right side from a record */
+            memcpy(((unsigned char *)agg->tuple) + size_offset, ((unsigned char *)tuple) + size_offset, total_copy);
         process_bytecode(agg->tuple, TYPE_START(type), 1, NOT_LINEAR, reg, PROCESS_TUPLE);
     }
 
-    free(accumulator);
+    arena.release(accumulator, size);
 }
 
 /** ************* PROCESSING FUNCTIONS ************* */
@@ -2135,12 +3522,12 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
     }
 
     if (!TYPE_IS_AGG(type) || TYPE_IS_LINEAR(type)) {
-        tuple_queue *queue = &TUPLES[type];
-        tuple_entry** current;
-        tuple_entry* cur;
+        tuple_queue *queue = get_tuples(type);
+        std::vector<tuple_entry*> *candidates = index_find(get_index(type)->byTuple,
+                                                           tuple_key(type, tuple));
 
-        for (current = &queue->head; *current != NULL; current = &(*current)->next) {
-            cur = *current;
+        for (size_t c = 0; candidates != NULL && c < candidates->size(); c++) {
+            tuple_entry *cur = (*candidates)[c];
             if (memcmp(cur->tuple, tuple, TYPE_SIZE(type)) == 0) {
                 cur->records.count += isNew;
 
@@ -2152,7 +3539,8 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
 #ifdef DEBUG_INSTRS
                     fprintf(stdout, "\x1b[1;32m--%d--\tDelete Iter success for  %s\x1b[0m\n", getBlockId(), tuple_names[type]);
 #endif
-                    FREE_TUPLE(queue_dequeue_pos(queue, current));
+                    index_remove(type, cur);
+                    FREE_TUPLE(queue_remove(queue, cur));
                     /** Also free retraction fact */
                     FREE_TUPLE(tuple);
 
@@ -2176,7 +3564,7 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
             return;
         }
 
-        queue_enqueue(queue, tuple, (record_type) isNew);
+        index_insert(type, queue_enqueue(queue, tuple, (record_type) isNew));
 
         process_bytecode(tuple, TYPE_START(TUPLE_TYPE(tuple)), isNew, TYPE_IS_LINEAR(TUPLE_TYPE(tuple)), reg, PROCESS_TUPLE);
         return;
@@ -2185,14 +3573,12 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
     unsigned char type_aggregate = TYPE_AGGREGATE(type);
     unsigned char field_aggregate = AGG_FIELD(type_aggregate);
 
-    tuple_entry **current;
-    tuple_entry *cur;
-    tuple_queue *queue = &(TUPLES[type]);
+    tuple_queue *queue = get_tuples(type);
+    std::vector<tuple_entry*> *candidates = index_find(get_index(type)->byTuple,
+                                                       tuple_key(type, tuple));
 
-    for (current = &queue->head;
-         (*current) != NULL;
-         current = &(*current)->next) {
-        cur = *current;
+    for (size_t c = 0; candidates != NULL && c < candidates->size(); c++) {
+        tuple_entry *cur = (*candidates)[c];
 
         size_t sizeBegin = TYPE_FIELD_SIZE + TYPE_ARG_OFFSET(type, field_aggregate);
         char *start = (char*)(cur->tuple);
@@ -2205,7 +3591,8 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
 
         if (memcmp(start + sizeOffset, (char*)tuple + sizeOffset, sizeEnd))
             continue;
-        tuple_queue *agg_queue = cur->records.agg_queue;
+        tuple_aggregate *agg_queue = static_cast<tuple_aggregate*>(cur->records.agg_queue);
+        void *value = GET_TUPLE_FIELD(tuple, field_aggregate);
 
         /** AGG_FIRST aggregate optimization */
         if(AGG_AGG(type_aggregate) == AGG_FIRST
@@ -2215,45 +3602,43 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
             return;
         }
 
-        tuple_entry** current2;
-        tuple_entry* cur2;
-
-        for (current2 = &agg_queue->head;
-             *current2 != NULL;
-             current2 = &(*current2)->next) {
-            cur2 = *current2;
+        tuple_entry *cur2 = record_find(type, tuple);
 
-            if (memcmp(cur2->tuple, tuple, TYPE_SIZE(type)) == 0) {
-                cur2->records.count += isNew;
+        if (cur2 != NULL) {
+            int count = cur2->records.count;
+            cur2->records.count += isNew;
+            agg_queue->update(value, count, cur2->records.count);
 
-                if (cur2->records.count <= 0) {
-                    // remove it
-                    FREE_TUPLE(queue_dequeue_pos(agg_queue, current2));
+            if (cur2->records.count <= 0) {
+                // remove it
+                index_erase(get_index(type)->byRecord, hash_bytes(tuple, TYPE_SIZE(type)), cur2);
+                FREE_TUPLE(queue_remove(agg_queue, cur2));
 
-                    if (queue_is_empty(agg_queue)) {
-                        /** aggregate is removed */
-                        void *aggTuple = queue_dequeue_pos(queue, current);
+                if (queue_is_empty(agg_queue)) {
+                    /** aggregate is removed */
+                    index_remove(type, cur);
+                    void *aggTuple = queue_remove(queue, cur);
 
-                        /** delete queue */
-                        free(agg_queue);
+                    /** delete queue */
+                    agg_queue->~tuple_aggregate();
+                    arena.release(agg_queue, sizeof(tuple_aggregate));
 
-                        process_bytecode(aggTuple, TYPE_START(TUPLE_TYPE(aggTuple)),
-                                         -1, NOT_LINEAR, reg, PROCESS_TUPLE);
-                        aggregate_free(aggTuple, field_aggregate, AGG_AGG(type_aggregate));
-                        FREE_TUPLE(aggTuple);
-                    } else
-                        aggregate_recalc(cur, reg, false);
+                    process_bytecode(aggTuple, TYPE_START(TUPLE_TYPE(aggTuple)),
+                                     -1, NOT_LINEAR, reg, PROCESS_TUPLE);
+                    aggregate_free(aggTuple, field_aggregate, AGG_AGG(type_aggregate));
+                    FREE_TUPLE(aggTuple);
                 } else
                     aggregate_recalc(cur, reg, false);
+            } else
+                aggregate_recalc(cur, reg, false);
 #ifdef DEBUG_INSTRS
-                fprintf(stdout,
-                        "\x1b[1;32m--%d--\tAgg delete Iter success for %s\x1b[0m\n",
-                        getBlockId(), tuple_names[type]);
+            fprintf(stdout,
+                    "\x1b[1;32m--%d--\tAgg delete Iter success for %s\x1b[0m\n",
+                    getBlockId(), tuple_names[type]);
 #endif
 
-                FREE_TUPLE(tuple);
-                return;
-            }
+            FREE_TUPLE(tuple);
+            return;
         }
 
         // if deleting, return
@@ -2268,7 +3653,9 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
             return;
         }
 
-        queue_enqueue(agg_queue, tuple, (record_type) isNew);
+        agg_queue->update(value, 0, isNew);
+        get_index(type)->byRecord[hash_bytes(tuple, TYPE_SIZE(type))].push_back(
+            queue_enqueue(agg_queue, tuple, (record_type) isNew));
         aggregate_recalc(cur, reg, false);
 
         return;
@@ -2285,12 +3672,14 @@ void MeldInterpretVM::tuple_do_handle(tuple_type type, tuple_t tuple, int isNew,
     memcpy(tuple_cpy, tuple, TYPE_SIZE(type));
 
     /** create aggregate queue */
-    tuple_queue *agg_queue = (tuple_queue*)malloc(sizeof(tuple_queue));
+    tuple_aggregate *agg_queue = new (arena.allocate(sizeof(tuple_aggregate)))
+        tuple_aggregate(AGG_AGG(type_aggregate));
 
-    queue_init(agg_queue);
-
-    queue_enqueue(agg_queue, tuple, (record_type) isNew);
-    tuple_entry *entry = queue_enqueue(&TUPLES[type], tuple_cpy, (record_type)agg_queue);
+    agg_queue->update(GET_TUPLE_FIELD(tuple, field_aggregate), 0, isNew);
+    get_index(type)->byRecord[hash_bytes(tuple, TYPE_SIZE(type))].push_back(
+        queue_enqueue(agg_queue, tuple, (record_type) isNew));
+    tuple_entry *entry = queue_enqueue(get_tuples(type), tuple_cpy, (record_type)(tuple_queue*)agg_queue);
+    index_insert(type, entry);
 
     aggregate_recalc(entry, reg, true);
     process_bytecode(tuple, TYPE_START(type), isNew, NOT_LINEAR, reg, PROCESS_TUPLE);
@@ -2492,8 +3881,91 @@ MeldInterpretVM::print_bytecode(const unsigned char *pc) {
 }
 #endif
 
+/**
+ * Instruction dispatch of process_bytecode. With GCC and Clang, each instruction jumps directly to
+ *  the code of the next one through a table of label addresses (computed goto), which saves the
+ *  bound check and the shared indirect jump of the switch and predicts better, and the field
+ *  operands resolved by predecode are used. The switch, which decodes every operand in place, is
+ *  always compiled: it is used with other compilers, when DEBUG_INSTRS traces every instruction,
+ *  by default if MELD_SWITCH_DISPATCH is defined, and when switchDispatch is set.
+ */
+#if defined(__GNUC__) && !defined(DEBUG_INSTRS)
+#define MELD_COMPUTED_GOTO
+#endif
+
+#if defined(MELD_COMPUTED_GOTO) && !defined(MELD_SWITCH_DISPATCH)
+bool MeldInterpretVM::switchDispatch = false;
+#else
+bool MeldInterpretVM::switchDispatch = true;
+#endif
+
+/** With MELD_PROFILE, every dispatched instruction is counted */
+#ifdef MELD_PROFILE
+#define PROFILE_INSTR() (profile.instructions++)
+#else
+#define PROFILE_INSTR() ((void)0)
+#endif
+
+/** Each instruction is both a case of the switch and a target of the computed goto */
+#ifdef MELD_COMPUTED_GOTO
+#define INSTR(op) case op: instr_##op
+#define INSTR_DEFAULT default: instr_default
+#define DISPATCH() do {                                                 \
+        if (threaded) {                                                 \
+            PROFILE_INSTR();                                            \
+            goto *dispatchTable[*(const unsigned char*)pc];             \
+        }                                                               \
+        goto eval_loop;                                                 \
+    } while (0)
+#else
+#define INSTR(op) case op
+#define INSTR_DEFAULT default
+#define DISPATCH() goto eval_loop
+#endif
+
+/** Field operands of the instruction at pc resolved by predecode, for the threaded dispatch only */
+#define DECODED_FIELDS(pc) (threaded ? decodedAt(pc) : NULL)
+
+/** Opcodes implemented by process_bytecode */
+#define MELD_DISPATCHED_INSTRS(X) X(RETURN_INSTR) X(NEXT_INSTR) X(PERS_ITER_INSTR) \
+    X(LINEAR_ITER_INSTR) X(NOT_INSTR) X(SEND_INSTR) X(RESET_LINEAR_INSTR) X(END_LINEAR_INSTR) \
+    X(RULE_INSTR) X(RULE_DONE_INSTR) X(SEND_DELAY_INSTR) X(RETURN_LINEAR_INSTR) \
+    X(RETURN_DERIVED_INSTR) X(MVINTFIELD_INSTR) X(MVINTREG_INSTR) X(MVFIELDFIELD_INSTR) \
+    X(MVFIELDREG_INSTR) X(MVPTRREG_INSTR) X(MVFIELDFIELDR_INSTR) X(MVREGFIELD_INSTR) \
+    X(MVHOSTFIELD_INSTR) X(MVFLOATFIELD_INSTR) X(MVFLOATREG_INSTR) X(MVHOSTREG_INSTR) \
+    X(ADDRNOTEQUAL_INSTR) X(ADDREQUAL_INSTR) X(INTMINUS_INSTR) X(INTEQUAL_INSTR) \
+    X(INTNOTEQUAL_INSTR) X(INTPLUS_INSTR) X(INTLESSER_INSTR) X(INTGREATEREQUAL_INSTR) \
+    X(ALLOC_INSTR) X(BOOLOR_INSTR) X(INTLESSEREQUAL_INSTR) X(INTGREATER_INSTR) X(INTMUL_INSTR) \
+    X(INTDIV_INSTR) X(FLOATPLUS_INSTR) X(FLOATMINUS_INSTR) X(FLOATMUL_INSTR) X(FLOATDIV_INSTR) \
+    X(FLOATEQUAL_INSTR) X(FLOATNOTEQUAL_INSTR) X(FLOATLESSER_INSTR) X(FLOATLESSEREQUAL_INSTR) \
+    X(FLOATGREATER_INSTR) X(FLOATGREATEREQUAL_INSTR) X(MVREGREG_INSTR) X(BOOLEQUAL_INSTR) \
+    X(BOOLNOTEQUAL_INSTR) X(IF_INSTR) X(CALL1_INSTR) X(ADDLINEAR_INSTR) X(ADDPERS_INSTR) \
+    X(RUNACTION_INSTR) X(UPDATE_INSTR) X(REMOVE_INSTR) X(IF_ELSE_INSTR) X(JUMP_INSTR) \
+    X(INTMOD_INSTR)
+
 int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, int isNew, int isLinear,
                                        Register *reg, meld_byte state) {
+#ifndef DEBUG_INSTRS
+    /** Code compiled by writeNativeCode, traced instructions are always interpreted */
+    if (nativeDispatch) {
+        const size_t offset = pc - meld_prog;
+        if (offset < nativeCode.size() && nativeCode[offset] != NULL) {
+            if (state == PROCESS_TUPLE)
+                moveTupleToReg (0, tuple, reg);
+            return nativeCode[offset](&nativeContext, tuple, isNew, isLinear, reg, state);
+        }
+    }
+#endif
+#ifdef MELD_COMPUTED_GOTO
+    if (!switchDispatch)
+        return run_bytecode<true>(tuple, pc, isNew, isLinear, reg, state);
+#endif
+    return run_bytecode<false>(tuple, pc, isNew, isLinear, reg, state);
+}
+
+template<bool threaded>
+int MeldInterpretVM::run_bytecode (tuple_t tuple, const unsigned char *pc, int isNew, int isLinear,
+                                   Register *reg, meld_byte state) {
 #ifdef DEBUG_INSTRS
 
     /** if (PROCESS_TYPE(state) == PROCESS_TUPLE) { */
@@ -2531,16 +4003,40 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
     /** Only if process_bytecode not called by iter, */
     /** because otherwise the tuple is already in a register */
 
+#ifdef MELD_COMPUTED_GOTO
+    /** Address of the code of each opcode, unknown opcodes go to instr_default */
+    static void *dispatchTable[256];
+    /** Filled once, by the first of the threads of processAll to get here */
+    static std::atomic<bool> dispatchReady(false);
+    if (threaded && !dispatchReady.load(std::memory_order_acquire)) {
+        static std::mutex dispatchMutex;
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        if (!dispatchReady.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 256; i++)
+                dispatchTable[i] = &&instr_default;
+#define SET_DISPATCH_TARGET(op) dispatchTable[op] = &&instr_##op;
+            MELD_DISPATCHED_INSTRS(SET_DISPATCH_TARGET)
+#undef SET_DISPATCH_TARGET
+            dispatchReady.store(true, std::memory_order_release);
+        }
+    }
+#endif
+
     for (;;) {
     eval_loop:
+        PROFILE_INSTR();
 #ifdef DEBUG_INSTRS
 #ifdef LOG_DEBUG
         print_bytecode(pc);
 #endif
 #endif
 
+#ifdef MELD_COMPUTED_GOTO
+        if (threaded)
+            goto *dispatchTable[*(const unsigned char*)pc];
+#endif
         switch (*(const unsigned char*)pc) {
-        case RETURN_INSTR: {	/** 0x0 */
+        INSTR(RETURN_INSTR): {	/** 0x0 */
 #ifdef DEBUG_INSTRS
             if (!(PROCESS_TYPE(state) == PROCESS_RULE
                   && RULE_ISPERSISTENT(RULE_NUMBER(state))) )
@@ -2549,7 +4045,7 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
             return RET_RET;
         }
 
-        case NEXT_INSTR: {	/** 0x1 */
+        INSTR(NEXT_INSTR): {	/** 0x1 */
 #ifdef DEBUG_INSTRS
             printf ("--%d--\t NEXT\n", getBlockId());
 #endif
@@ -2563,46 +4059,46 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
                 return RET_DERIVED;             \
             if(ret == RET_RET)                  \
                 return RET_RET;                 \
-            pc = npc; goto eval_loop;
+            pc = npc; DISPATCH();
 
-        case PERS_ITER_INSTR: {	/** 0x02 */
+        INSTR(PERS_ITER_INSTR): {	/** 0x02 */
             const meld_byte *npc = pc + ITER_OUTER_JUMP(pc);
             const int ret = execute_iter (pc, reg, isNew, isLinear);
             DECIDE_NEXT_ITER();
         }
 
-        case LINEAR_ITER_INSTR: {	/** 0x05 */
+        INSTR(LINEAR_ITER_INSTR): {	/** 0x05 */
             const meld_byte *npc = pc + ITER_OUTER_JUMP(pc);
             const int ret = execute_iter (pc, reg, isNew, isLinear);
             DECIDE_NEXT_ITER();
         }
 
-        case NOT_INSTR: {	/** 0x07 */
+        INSTR(NOT_INSTR): {	/** 0x07 */
             const meld_byte *npc = pc + NOT_BASE;
             execute_not (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case SEND_INSTR: {	/** 0x08 */
+        INSTR(SEND_INSTR): {	/** 0x08 */
             const meld_byte *npc = pc + SEND_BASE;
             execute_send (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case RESET_LINEAR_INSTR: { /** 0x0e */
+        INSTR(RESET_LINEAR_INSTR): { /** 0x0e */
             int ret = process_bytecode(tuple, pc + RESET_LINEAR_BASE, isNew, NOT_LINEAR, reg, PROCESS_ITER);
             (void)ret;
             pc += RESET_LINEAR_JUMP(pc);
-            goto eval_loop;
+            DISPATCH();
         }
             break;
 
-        case END_LINEAR_INSTR: /** 0x0f */
+        INSTR(END_LINEAR_INSTR): /** 0x0f */
             return RET_LINEAR;
 
-        case RULE_INSTR: {	/** 0x10 */
+        INSTR(RULE_INSTR): {	/** 0x10 */
             const meld_byte *npc = pc + RULE_BASE;
 #ifdef DEBUG_INSTRS
             meld_byte rule_number = FETCH(++pc);
@@ -2610,318 +4106,318 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
                     rule_number);
 #endif
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case RULE_DONE_INSTR: {	/** 0x11 */
+        INSTR(RULE_DONE_INSTR): {	/** 0x11 */
 #ifdef DEBUG_INSTRS
             printf ("--%d--\t RULE DONE\n", getBlockId());
 #endif
             const meld_byte *npc = pc + RULE_DONE_BASE;
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case SEND_DELAY_INSTR: {	/** 0x15 */
+        INSTR(SEND_DELAY_INSTR): {	/** 0x15 */
             const meld_byte *npc = pc + SEND_DELAY_BASE;
             execute_send_delay (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case RETURN_LINEAR_INSTR: {		/** 0xd0 */
+        INSTR(RETURN_LINEAR_INSTR): {		/** 0xd0 */
 #ifdef DEBUG_INSTRS
             printf ("--%d--\tRETURN LINEAR\n", getBlockId());
 #endif
             return RET_LINEAR;
         }
 
-        case RETURN_DERIVED_INSTR: {		/** 0xf0 */
+        INSTR(RETURN_DERIVED_INSTR): {		/** 0xf0 */
 #ifdef DEBUG_INSTRS
             printf ("--%d--\tRETURN DERIVED\n", getBlockId());
 #endif
             return RET_DERIVED;
         }
 
-        case MVINTFIELD_INSTR: {	/** 0x1e */
+        INSTR(MVINTFIELD_INSTR): {	/** 0x1e */
             const meld_byte *npc = pc + MVINTFIELD_BASE;
-            execute_mvintfield (pc, reg);
+            execute_mvintfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVINTREG_INSTR: {	/** 0x1f */
+        INSTR(MVINTREG_INSTR): {	/** 0x1f */
             const meld_byte *npc = pc + MVINTREG_BASE;
             execute_mvintreg (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVFIELDFIELD_INSTR: {	/** 0x21 */
+        INSTR(MVFIELDFIELD_INSTR): {	/** 0x21 */
             const meld_byte *npc = pc + MVFIELDFIELD_BASE;
-            execute_mvfieldfield (pc, reg);
+            execute_mvfieldfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVFIELDREG_INSTR: {	/** 0x22 */
+        INSTR(MVFIELDREG_INSTR): {	/** 0x22 */
             const meld_byte *npc = pc + MVFIELDREG_BASE;
-            execute_mvfieldreg (pc, reg);
+            execute_mvfieldreg (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVPTRREG_INSTR: {	/** 0x23 */
+        INSTR(MVPTRREG_INSTR): {	/** 0x23 */
             const meld_byte *npc = pc + MVPTRREG_BASE;
 #ifdef DEBUG_INSTRS
             printf ("--%d--\tMOVE PTR TO REG -- Do nothing\n", getBlockId());
 #endif
             /** TODO: Do something if used elsewhere than axiom derivation */
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
 
-        case MVFIELDFIELDR_INSTR: { /** 0x25 */
+        INSTR(MVFIELDFIELDR_INSTR): { /** 0x25 */
             const meld_byte *npc = pc + MVFIELDFIELD_BASE;
-            execute_mvfieldfield (pc, reg);
+            execute_mvfieldfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVREGFIELD_INSTR: {	/** 0x26 */
+        INSTR(MVREGFIELD_INSTR): {	/** 0x26 */
             const meld_byte *npc = pc + MVREGFIELD_BASE;
-            execute_mvregfield (pc, reg);
+            execute_mvregfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case MVHOSTFIELD_INSTR: {	/** 0x28 */
+        INSTR(MVHOSTFIELD_INSTR): {	/** 0x28 */
             const meld_byte *npc = pc + MVHOSTFIELD_BASE;
-            execute_mvhostfield (pc, reg);
+            execute_mvhostfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case MVFLOATFIELD_INSTR: {	/** 0x2d */
+        INSTR(MVFLOATFIELD_INSTR): {	/** 0x2d */
             const meld_byte *npc = pc + MVFLOATFIELD_BASE;
-            execute_mvfloatfield (pc, reg);
+            execute_mvfloatfield (pc, reg, DECODED_FIELDS(pc));
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case MVFLOATREG_INSTR: {	/** 0x2e */
+        INSTR(MVFLOATREG_INSTR): {	/** 0x2e */
             const meld_byte *npc = pc + MVFLOATREG_BASE;
             execute_mvfloatreg (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case MVHOSTREG_INSTR: {	/** 0x37 */
+        INSTR(MVHOSTREG_INSTR): {	/** 0x37 */
             const meld_byte *npc = pc + MVHOSTREG_BASE;
             execute_mvhostreg (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case ADDRNOTEQUAL_INSTR: {	/** 0x38 */
+        INSTR(ADDRNOTEQUAL_INSTR): {	/** 0x38 */
             const meld_byte *npc = pc + OP_BASE;
             execute_addrnotequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case ADDREQUAL_INSTR: {	/** 0x39 */
+        INSTR(ADDREQUAL_INSTR): {	/** 0x39 */
             const meld_byte *npc = pc + OP_BASE;
             execute_addrequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTMINUS_INSTR: {	/** 0x3a */
+        INSTR(INTMINUS_INSTR): {	/** 0x3a */
             const meld_byte *npc = pc + OP_BASE;
             execute_intminus (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTEQUAL_INSTR: {	/** 0x3b */
+        INSTR(INTEQUAL_INSTR): {	/** 0x3b */
             const meld_byte *npc = pc + OP_BASE;
             execute_intequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTNOTEQUAL_INSTR: {	/** 0x3c */
+        INSTR(INTNOTEQUAL_INSTR): {	/** 0x3c */
             const meld_byte *npc = pc + OP_BASE;
             execute_intnotequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTPLUS_INSTR: {	/** 0x3d */
+        INSTR(INTPLUS_INSTR): {	/** 0x3d */
             const meld_byte *npc = pc + OP_BASE;
             execute_intplus (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTLESSER_INSTR: {	/** 0x3e */
+        INSTR(INTLESSER_INSTR): {	/** 0x3e */
             const meld_byte *npc = pc + OP_BASE;
             execute_intlesser (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTGREATEREQUAL_INSTR: {	/** 0x3f */
+        INSTR(INTGREATEREQUAL_INSTR): {	/** 0x3f */
             const meld_byte *npc = pc + OP_BASE;
             execute_intgreaterequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case ALLOC_INSTR: {	/** 0x40 */
+        INSTR(ALLOC_INSTR): {	/** 0x40 */
             const meld_byte *npc = pc + ALLOC_BASE;
             execute_alloc (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case BOOLOR_INSTR: {	/** 0x41 */
+        INSTR(BOOLOR_INSTR): {	/** 0x41 */
             const meld_byte *npc = pc + OP_BASE;
             execute_boolor (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTLESSEREQUAL_INSTR: {	/** 0x42 */
+        INSTR(INTLESSEREQUAL_INSTR): {	/** 0x42 */
             const meld_byte *npc = pc + OP_BASE;
             execute_intlesserequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTGREATER_INSTR: {	/** 0x43 */
+        INSTR(INTGREATER_INSTR): {	/** 0x43 */
             const meld_byte *npc = pc + OP_BASE;
             execute_intgreater (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTMUL_INSTR: {	/** 0x44 */
+        INSTR(INTMUL_INSTR): {	/** 0x44 */
             const meld_byte *npc = pc + OP_BASE;
             execute_intmul (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTDIV_INSTR: {	/** 0x45 */
+        INSTR(INTDIV_INSTR): {	/** 0x45 */
             const meld_byte *npc = pc + OP_BASE;
             execute_intdiv (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATPLUS_INSTR: {	/** 0x46 */
+        INSTR(FLOATPLUS_INSTR): {	/** 0x46 */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatplus (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATMINUS_INSTR: {	/** 0x47 */
+        INSTR(FLOATMINUS_INSTR): {	/** 0x47 */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatminus (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATMUL_INSTR: {	/** 0x48 */
+        INSTR(FLOATMUL_INSTR): {	/** 0x48 */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatmul (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATDIV_INSTR: {	/** 0x49 */
+        INSTR(FLOATDIV_INSTR): {	/** 0x49 */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatdiv (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATEQUAL_INSTR: {	/** 0x4a */
+        INSTR(FLOATEQUAL_INSTR): {	/** 0x4a */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATNOTEQUAL_INSTR: {	/** 0x4b */
+        INSTR(FLOATNOTEQUAL_INSTR): {	/** 0x4b */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatnotequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATLESSER_INSTR: {	/** 0x4c */
+        INSTR(FLOATLESSER_INSTR): {	/** 0x4c */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatlesser (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATLESSEREQUAL_INSTR: {	/** 0x4d */
+        INSTR(FLOATLESSEREQUAL_INSTR): {	/** 0x4d */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatlesserequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATGREATER_INSTR: {	/** 0x4e */
+        INSTR(FLOATGREATER_INSTR): {	/** 0x4e */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatgreater (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case FLOATGREATEREQUAL_INSTR: {	/** 0x4f */
+        INSTR(FLOATGREATEREQUAL_INSTR): {	/** 0x4f */
             const meld_byte *npc = pc + OP_BASE;
             execute_floatgreaterequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case MVREGREG_INSTR: {	/** 0x50 */
+        INSTR(MVREGREG_INSTR): {	/** 0x50 */
             const meld_byte *npc = pc + MVREGREG_BASE;
             execute_mvregreg (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case BOOLEQUAL_INSTR: {	/** 0x51 */
+        INSTR(BOOLEQUAL_INSTR): {	/** 0x51 */
             const meld_byte *npc = pc + OP_BASE;
             execute_boolequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
-        case BOOLNOTEQUAL_INSTR: {	/** 0x51 */
+        INSTR(BOOLNOTEQUAL_INSTR): {	/** 0x51 */
             const meld_byte *npc = pc + OP_BASE;;
             execute_boolnotequal (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case IF_INSTR: {	/** 0x60 */
+        INSTR(IF_INSTR): {	/** 0x60 */
             const meld_byte *npc = pc + IF_BASE;
             meld_byte *base = (meld_byte*)pc;
             ++pc;
@@ -2935,7 +4431,7 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
 #endif
 
                 pc = base + IF_JUMP(pc);
-                goto eval_loop;
+                DISPATCH();
             }
             /** else process if content */
 #ifdef DEBUG_INSTRS
@@ -2943,57 +4439,57 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
                     getBlockId(), reg_index);
 #endif
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case CALL1_INSTR: {	/** 0x69 */
+        INSTR(CALL1_INSTR): {	/** 0x69 */
             const meld_byte *npc = pc + CALL1_BASE;
             execute_call1 (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case ADDLINEAR_INSTR: {	/** 0x77 */
+        INSTR(ADDLINEAR_INSTR): {	/** 0x77 */
             const meld_byte *npc = pc + ADDLINEAR_BASE;
             execute_addtuple (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case ADDPERS_INSTR: {	/** 0x78 */
+        INSTR(ADDPERS_INSTR): {	/** 0x78 */
             const meld_byte *npc = pc + ADDPERS_BASE;
             execute_addtuple (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case RUNACTION_INSTR: {	/** 0x79 */
+        INSTR(RUNACTION_INSTR): {	/** 0x79 */
             const meld_byte *npc = pc + RUNACTION_BASE;
             execute_run_action (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case UPDATE_INSTR: {	/** 0x7b */
+        INSTR(UPDATE_INSTR): {	/** 0x7b */
             const meld_byte *npc = pc + UPDATE_BASE;
             if (PROCESS_TYPE(state) == PROCESS_ITER)
                 execute_update (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case REMOVE_INSTR: {	/** 0x80 */
+        INSTR(REMOVE_INSTR): {	/** 0x80 */
             const meld_byte *npc = pc + REMOVE_BASE;
             execute_remove (pc, reg, isNew);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
             /** NOT TESTED */
             /** CAUTION: I have no way to ensure that it is the correct way to handle
              * this instruction at this moment, please review this when you encounter it.
              */
-        case IF_ELSE_INSTR: {	/** 0x81 */
+        INSTR(IF_ELSE_INSTR): {	/** 0x81 */
             const meld_byte *npc = pc + IF_ELSE_BASE;
             meld_byte *base = (meld_byte*)pc;
             ++pc;
@@ -3008,7 +4504,7 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
 #endif
 
                 pc = base + IF_JUMP(pc);
-                goto eval_loop;
+                DISPATCH();
             } else {
                 /** Else, process if until a jump instruction is encountered
                  * (it seems...)
@@ -3019,28 +4515,28 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
 #endif
 
                 pc = npc;
-                goto eval_loop;
+                DISPATCH();
             }
         }
 
             /** NOT TESTED */
-        case JUMP_INSTR: {
+        INSTR(JUMP_INSTR): {
             ++pc;
 #ifdef DEBUG_INSTRS
             printf ("--%d--\t JUMP TO\n", getBlockId());
 #endif
             pc += JUMP_BASE + IF_JUMP(pc);
-            goto eval_loop;
+            DISPATCH();
         }
 
-        case INTMOD_INSTR: {	/** 0x7d */
+        INSTR(INTMOD_INSTR): {	/** 0x7d */
             const meld_byte *npc = pc + OP_BASE;
             execute_intmod (pc, reg);
             pc = npc;
-            goto eval_loop;
+            DISPATCH();
         }
 
-        default:
+        INSTR_DEFAULT:
             printf ("--%d--\t "
                     "INSTRUCTION NOT IMPLEMENTED YET: %#x %#x %#x %#x %#x\n",
                     getBlockId(),
@@ -3053,6 +4549,74 @@ int MeldInterpretVM::process_bytecode (tuple_t tuple, const unsigned char *pc, i
     }
 }
 
+int MeldInterpretVM::execute_native (void *vm, const unsigned char *pc, void *tuple, int isNew,
+                                     int isLinear, Register *reg) {
+    MeldInterpretVM *self = (MeldInterpretVM*)vm;
+
+    switch (FETCH(pc)) {
+    case PERS_ITER_INSTR:
+    case LINEAR_ITER_INSTR:
+        return self->execute_iter (pc, reg, isNew, isLinear);
+    case RESET_LINEAR_INSTR:
+        self->process_bytecode(tuple, pc + RESET_LINEAR_BASE, isNew, NOT_LINEAR, reg, PROCESS_ITER);
+        break;
+    case SEND_INSTR:
+        self->execute_send (pc, reg, isNew);
+        break;
+    case SEND_DELAY_INSTR:
+        self->execute_send_delay (pc, reg, isNew);
+        break;
+    case ALLOC_INSTR:
+        self->execute_alloc (pc, reg);
+        break;
+    case ADDLINEAR_INSTR:
+    case ADDPERS_INSTR:
+        self->execute_addtuple (pc, reg, isNew);
+        break;
+    case RUNACTION_INSTR:
+        self->execute_run_action (pc, reg, isNew);
+        break;
+    case UPDATE_INSTR:
+        self->execute_update (pc, reg);
+        break;
+    case REMOVE_INSTR:
+        self->execute_remove (pc, reg, isNew);
+        break;
+    case CALL1_INSTR:
+        self->execute_call1 (pc, reg);
+        break;
+    case MVHOSTFIELD_INSTR:
+        self->execute_mvhostfield (pc, reg, decodedAt(pc));
+        break;
+    case MVHOSTREG_INSTR:
+        self->execute_mvhostreg (pc, reg);
+        break;
+    /** Field moves whose tuple type is only known during execution */
+    case MVINTFIELD_INSTR:
+        self->execute_mvintfield (pc, reg, NULL);
+        break;
+    case MVFIELDFIELD_INSTR:
+    case MVFIELDFIELDR_INSTR:
+        self->execute_mvfieldfield (pc, reg, NULL);
+        break;
+    case MVFIELDREG_INSTR:
+        self->execute_mvfieldreg (pc, reg, NULL);
+        break;
+    case MVREGFIELD_INSTR:
+        self->execute_mvregfield (pc, reg, NULL);
+        break;
+    case MVFLOATFIELD_INSTR:
+        self->execute_mvfloatfield (pc, reg, NULL);
+        break;
+    default:
+        fprintf(stderr, "--%d--\t Error: instruction %#x cannot be run for the native code\n",
+                self->getBlockId(), (unsigned char)*pc);
+        exit(-2);
+    }
+
+    return RET_NO_RET;
+}
+
 #define MAX_STRING_SIZE 200
 /** Prints a tuple */
 void MeldInterpretVM::tuple_print(tuple_t tuple, FILE *fp) {
@@ -3117,7 +4681,7 @@ void MeldInterpretVM::facts_dump(void) {
 
     for (i = 0; i < NUM_TYPES; i++) {
         // don't print fact types that don't exist
-        if (TUPLES[i].head == NULL)
+        if (TUPLES[i] == NULL || TUPLES[i]->head == NULL)
             continue;
 
         // don't print artificial tuple types
@@ -3135,7 +4699,7 @@ void MeldInterpretVM::facts_dump(void) {
         fprintf(stderr, "%s\n",str);
 #endif
         tuple_entry *tupleEntry;
-        for (tupleEntry = TUPLES[i].head; tupleEntry != NULL; tupleEntry = tupleEntry->next) {
+        for (tupleEntry = TUPLES[i]->head; tupleEntry != NULL; tupleEntry = tupleEntry->next) {
             sprintf(str,"  ");
             tuple_print(tupleEntry->tuple, stderr);
             if (TYPE_IS_AGG(i)) {
@@ -3223,12 +4787,12 @@ void MeldInterpretVM::databaseConsistencyChecker() {
     meld_byte neighborTCount = 0;
     meld_byte vacantTCount = 0;
     for (i = 0; i < NUM_TYPES; i++) {
-        if (TUPLES[i].head == NULL)
+        if (TUPLES[i] == NULL || TUPLES[i]->head == NULL)
             continue;
 
         meld_byte tupleCount = 0;
         tuple_entry *tupleEntry;
-        for (tupleEntry = TUPLES[i].head;
+        for (tupleEntry = TUPLES[i]->head;
              tupleEntry != NULL;
              tupleEntry = tupleEntry->next) {
             if (i == TYPE_NEIGHBOR)
@@ -7,9 +7,16 @@
 #include <sys/timeb.h>
 #include <memory>
 #include <map>
+#include <set>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 
 #include "../utils/color.h"
 #include "../base/buildingBlock.h"
+#include "meldInterpretArena.h"
+#include "meldInterpretProfile.h"
+#include "meldInterpretNative.h"
 
 #include <sys/timeb.h>
 
@@ -17,9 +24,9 @@
 Definitions of all the data structures and types used by the VM.
 *******************************************************************************/
 
-/* allocation for tuples */
-#define ALLOC_TUPLE(x) malloc(x)
-#define FREE_TUPLE(x) free(x)
+/* allocation for tuples, from the arena of the VM */
+#define ALLOC_TUPLE(x) arena.allocate(x)
+#define FREE_TUPLE(x) tuple_free(x)
 
 /* Meld Types */
 typedef void* tuple_t;
@@ -35,7 +42,7 @@ typedef uint16_t Uid;
 /* Meld Structures */
 
 typedef struct _tuple_entry tuple_entry;
-typedef struct _tuple_queue { tuple_entry *head = NULL; tuple_entry *tail = NULL; unsigned char length ;} tuple_queue;
+typedef struct _tuple_queue { tuple_entry *head = NULL; tuple_entry *tail = NULL; unsigned int length ;} tuple_queue;
 
 class record_type{
 public:
@@ -55,9 +62,127 @@ class record_type{
     }
 };
 
-struct _tuple_entry { struct _tuple_entry *next; record_type records; void *tuple;};
+struct _tuple_entry { struct _tuple_entry *next; record_type records; void *tuple; struct _tuple_entry *prev;};
 typedef struct _tuple_pentry { Time priority; struct _tuple_pentry *next; record_type records; void *tuple; NodeID rt;} tuple_pentry;
-typedef struct {struct _tuple_pentry *queue;} tuple_pqueue;
+
+namespace MeldInterpret {
+
+/* Delayed tuples, by due date (priority, in ms), as a hierarchical timer wheel: LEVELS wheels of
+ * SLOTS slots, level l holding the entries which differ from the current date in bits
+ * [l*SLOT_BITS, (l+1)*SLOT_BITS) and above. Entries are pushed in O(1) and moved down one level
+ * at a time as the date advances, due entries are popped by date, in push order for equal dates.
+ * Dates beyond the last level are kept in a sorted overflow list. */
+class tuple_wheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 6;
+
+    tuple_wheel(Time date) : current(date) {}
+
+    inline bool empty() const { return size == 0; }
+    /* Adds entry, due at entry->priority */
+    void push(tuple_pentry *entry);
+    /* Removes and returns the first entry due at date, NULL if there is none */
+    tuple_pentry *pop_expired(Time date);
+    /* Calls f on every entry, in no particular order */
+    template<typename F> void for_each(F f) const {
+        for (tuple_pentry *entry = expired; entry != NULL; entry = entry->next)
+            f(entry);
+        for (tuple_pentry *entry = overflow; entry != NULL; entry = entry->next)
+            f(entry);
+        for (int l = 0; l < LEVELS; l++) {
+            for (int s = 0; s < SLOTS; s++) {
+                if (slots[l][s] == NULL)
+                    continue;
+                tuple_pentry *entry = slots[l][s];
+                do {
+                    entry = entry->next;
+                    f(entry);
+                } while (entry != slots[l][s]);
+            }
+        }
+    }
+
+private:
+    /* Every entry due before current is in expired */
+    Time current;
+    unsigned int size = 0;
+    /* Due entries, by date */
+    tuple_pentry *expired = NULL, *expired_tail = NULL;
+    /* Sorted entries beyond the last level */
+    tuple_pentry *overflow = NULL;
+    /* Slots, as circular lists pointing to their last entry */
+    tuple_pentry *slots[LEVELS][SLOTS] = {};
+    /* Bitmap of the non empty slots of each level */
+    uint64_t occupied[LEVELS] = {};
+
+    static void insert_sorted(tuple_pentry **list, tuple_pentry *entry);
+    /* Puts entry at its place for the current date */
+    void insert(tuple_pentry *entry);
+    /* Removes the entries of a slot, in push order, as a NULL terminated list */
+    tuple_pentry *take_slot(int level, int slot);
+    /* Moves the entries due at date or before to expired */
+    void advance(Time date);
+};
+
+/* Stratified tuples, by stratification round: one FIFO bucket per round with pending tuples,
+ * by decreasing round so that the lowest round is popped from the back */
+class tuple_strata {
+public:
+    inline bool empty() const { return buckets.empty(); }
+    /* Adds entry to the bucket of round entry->priority */
+    void push(tuple_pentry *entry);
+    /* Removes and returns the first entry of the lowest round */
+    tuple_pentry *pop();
+    /* Calls f on every entry, by round */
+    template<typename F> void for_each(F f) const {
+        for (size_t b = buckets.size(); b-- > 0;) {
+            for (tuple_pentry *entry = buckets[b].head; entry != NULL; entry = entry->next)
+                f(entry);
+        }
+    }
+
+private:
+    struct bucket { Time round; tuple_pentry *head; tuple_pentry *tail; };
+    std::vector<bucket> buckets;
+};
+
+/* Records of an aggregate (the tuples it aggregates, with their count) and the state of its
+ * value, maintained record by record: the running sums, and the ordered values of the records for
+ * min and max under deletions. The value is then obtained in O(1), and a record change costs O(1)
+ * for sums and O(log n) for min and max, instead of a scan of all the records. */
+class tuple_aggregate : public tuple_queue {
+public:
+    tuple_aggregate(int agg_type) : agg_type(agg_type) { length = 0; }
+
+    /* Accounts for the count of a record of aggregated field value going from oldCount to
+     * newCount, a count of 0 or less meaning that the record is added or removed */
+    void update(const void *value, int oldCount, int newCount);
+    /* Writes the value of a min, max or sum aggregate with records into acc */
+    void get(void *acc) const;
+
+private:
+    int agg_type;
+    meld_int sum_int = 0;
+    meld_float sum_float = 0;
+    /* Values of the records, meld_int values are exact as meld_float */
+    std::multiset<meld_float> values;
+};
+
+}
+
+/* Hash index of the tuples of a predicate, the entries of a key are in database order */
+typedef std::unordered_map<uint64_t, std::vector<tuple_entry*>> tuple_hash_index;
+/* Indexes of the tuples of a predicate in the database:
+ * byTuple finds duplicates (keyed on the whole tuple, but the aggregated field),
+ * byFirstArg serves the iterations with an equality filter on the first argument,
+ * byRecord finds the records of the aggregates (keyed on the whole tuple) */
+typedef struct { tuple_hash_index byTuple; tuple_hash_index byFirstArg; tuple_hash_index byRecord; } tuple_index;
+/* Field operands of a move instruction resolved when the program is loaded: offset of each field
+ * in its tuple (type byte included) and size of the field, 0 if the tuple type is only known
+ * during execution */
+typedef struct { unsigned char offset[2]; unsigned char size[2]; } decoded_fields;
 
 // enum portReferences { DOWN, NORTH, EAST, SOUTH, WEST, UP, NUM_PORTS };
 
@@ -622,18 +747,65 @@ class MeldInterpretVM {
 
     int numNeighbors;
     int waiting;
+    /* Number of tuples enqueued, handled or sent and of events scheduled by this VM, tells
+     * processOneRule whether a rule body has changed anything */
+    unsigned int nbChanges;
     static bool debugging;
     static bool configured;
     bool firstStart;
 
+    /* True if this VM has pending work */
+    bool hasWork;
+    /* Position of this VM in busyVMs, -1 if it is not in it */
+    int busyIndex;
+    /* VMs with pending work, in no particular order */
+    static std::vector<MeldInterpretVM*> busyVMs;
+    /* Size of busyVMs, readable from any thread */
+    static std::atomic<unsigned int> nbBusyVMs;
+
+    void enterBusyVMs();
+    void leaveBusyVMs();
+
+    /* Field operands resolved by predecode, indexed by instruction offset in meld_prog */
+    static std::vector<decoded_fields> decodedFields;
+    /* Resolved field operands of the instruction at pc, NULL past the code reached by predecode */
+    static inline const decoded_fields* decodedAt(const unsigned char *pc) {
+        size_t offset = pc - meld_prog;
+        return offset < decodedFields.size() ? &decodedFields[offset] : NULL;
+    }
+    /* Body of process_bytecode, with the computed goto dispatch and the resolved field operands
+     * if threaded, with the switch dispatch and operands decoded in place otherwise */
+    template<bool threaded>
+    int run_bytecode(tuple_t tuple, const unsigned char *pc, int isNew, int isLinear,
+                     Register *reg, meld_byte state);
+
+    /* Native code loaded by readNativeCode or with a program plugin, indexed by offset in
+     * meld_prog, NULL for the code which is interpreted */
+    static std::vector<MeldNativeFunction> nativeCode;
+    /* Context of the native code run by this VM */
+    MeldNativeContext nativeContext;
+    /* Runs the instruction at pc for the native code of vm, see MeldNativeContext::execute */
+    static int execute_native(void *vm, const unsigned char *pc, void *tuple, int isNew,
+                              int isLinear, Register *reg);
+    /* Fills nativeCode from the symbols of library, returns false if it has no native code and
+     * exits if its code was generated from another program */
+    static bool loadNativeCode(void *library, const string &path);
+
+    /* True while processAll runs this VM on a worker thread, its events are then kept in outbox */
+    bool buffering;
+    std::vector<Event*> outbox;
+    /* Schedules ev, or keeps it in outbox while buffering */
+    void schedule(Event *ev);
+
 public:
-    static map<int, MeldInterpretVM*> vmMap;
+    /* VMs indexed by block ID, NULL for IDs without a VM */
+    static std::vector<MeldInterpretVM*> vms;
     static const unsigned char * meld_prog;
     static char **tuple_names;
     static char **rule_names;
 
     Time currentLocalDate;
-    bool hasWork, polling, deterministicSet;
+    bool polling, deterministicSet;
     NodeID *neighbors;
     tuple_type TYPE_INIT;
     tuple_type TYPE_EDGE;
@@ -653,11 +825,59 @@ class MeldInterpretVM {
     ~MeldInterpretVM();
     void processOneRule();
     bool isWaiting();
+    /* Returns true if no VM of an alive block has pending work, in amortized constant time */
     static bool equilibrium();
+    /* Number of threads of processAll, 0 for all cores */
+    static unsigned int nbThreads;
+    /* Runs processOneRule once on the busy VMs of alive blocks, in block ID order, on nbThreads
+     * threads of a pool kept between passes, or on the calling thread for small passes. The
+     * events scheduled by the VMs are buffered and given to the scheduler in block ID order,
+     * so that the simulation does not depend on the number of threads. A VM which has found
+     * nothing to do leaves the busy VMs. Called by the scheduler until equilibrium before time
+     * moves on. Returns the number of VMs run */
+    static size_t processAll();
+    /* Marks the VM of block as busy, after an event of the block which may have given it work:
+     * received tuple, due delayed tuple, neighbor change... */
+    static void wakeUp(BaseSimulator::BuildingBlock *block);
+    /* Returns the VM of block id, NULL if there is none */
+    static inline MeldInterpretVM* getVM(NodeID id) {
+        return id < vms.size() ? vms[id] : NULL;
+    }
+    inline bool getHasWork() { return hasWork; }
+    void setHasWork(bool work);
+#ifdef MELD_ARENA_CHECKS
+    /* Prints the arena statistics and counts the blocks leaked by all VMs */
+    static void checkArenas();
+#endif
+#ifdef MELD_PROFILE
+    /* Prints the execution profile of all the VMs of the run, destroyed ones included */
+    static void printProfile();
+#endif
     inline static bool isInDebuggingMode() { return debugging; };
     static void setConfiguration(string path, bool d);
     static void readProgram(string path);
+    /* Loads the bytecode and names of a program packaged as a shared library by
+     *  utilities/meldProgramPlugin.sh, with its native code if the library holds it */
+    static void readProgramPlugin(string path);
+    /* Maps a program image (MELD_IMAGE_EXT), shared read-only by all VMs */
+    static void readProgramImage(string path);
+    /* Writes the loaded program as a program image, with --convert-program */
+    static void writeProgramImage(string path);
+    /* Translates the code of the loaded program to C++ functions (see meldInterpretNative.h), with
+     * --convert-program <file>.cpp */
+    static void writeNativeCode(string path);
+    /* Loads the native code of the loaded program, written by writeNativeCode and compiled into a
+     * shared library */
+    static void readNativeCode(string path);
     static int characterCount(string in, char character);
+    /* Resolves the field operands of the loaded program whose tuple type does not depend on the
+     * execution, by following the types of the tuples in the registers through the bytecode */
+    static void predecode();
+    /* True to run the bytecode with the switch dispatch, set by default with MELD_SWITCH_DISPATCH
+     * or when the compiler has no computed goto */
+    static bool switchDispatch;
+    /* True to run the native code of the program when it is loaded, false to interpret all of it */
+    static bool nativeDispatch;
 
     meld_byte updateRuleState(meld_byte rid);
     Time myGetTime();
@@ -692,6 +912,9 @@ class MeldInterpretVM {
     NodeID getGUID();
     extern_funct_type *extern_functs;
     int *extern_functs_args;
+    /* External functions of a program plugin, NULL for a program read from a .bb file */
+    static extern_funct_type *program_extern_functs;
+    static int *program_extern_functs_args;
     static unsigned char * arguments;
 
     void print_newTuples ();
@@ -700,12 +923,21 @@ class MeldInterpretVM {
     NodeID getBlockId();
     /* ************* TUPLE HANDLING FUNCTIONS  ************* */
 
-    /* Queue for tuples to send with delay */
-    tuple_pqueue *delayedTuples;
-    /* Contains a queue for each type, this is essentially the database */
-    tuple_queue *tuples;
+    /* Allocator of the tuples and queue entries of this VM */
+    MeldArena arena;
+#ifdef MELD_PROFILE
+    /* Execution counters of this VM */
+    MeldProfile profile;
+#endif
+    /* Queue for tuples to send with delay, allocated with the first one */
+    tuple_wheel *delayedTuples;
+    /* Contains a queue for each type, this is essentially the database.
+     * A queue is allocated with the first fact of its type, NULL before */
+    tuple_queue **tuples;
+    /* Hash indexes of the database, for each type, allocated on first use */
+    std::vector<std::unique_ptr<tuple_index>> indexes;
     /* Where stratified tuples are enqueued for execution  */
-    tuple_pqueue *newStratTuples;
+    tuple_strata newStratTuples;
     /* Where non-stratified tuples are enqueued for execution */
     tuple_queue *newTuples;
     /* Received tuples are enqueued both to a normal queue
@@ -735,6 +967,11 @@ class MeldInterpretVM {
             return tuple;
         }
 
+    inline void tuple_free(tuple_t tuple)
+        {
+            arena.release(tuple, TYPE_SIZE(TUPLE_TYPE(tuple)));
+        }
+
     void tuple_do_handle(tuple_type type,	void *tuple, int isNew, Register *reg);
     void tuple_print(tuple_t tuple, FILE *fp);
 
@@ -749,7 +986,7 @@ class MeldInterpretVM {
     int process_bytecode(tuple_t tuple, const unsigned char *pc, int isNew, int isLinear,
                          Register *reg, meld_byte state);
 
-    void init_fields(void);
+    static void init_fields(void);
     void init_consts(void);
 
     void facts_dump(void);
@@ -762,6 +999,8 @@ class MeldInterpretVM {
     meld_byte val_is_int(const meld_byte x);
     meld_byte val_is_field(const meld_byte x);
     void * eval_field (tuple_t tuple, const unsigned char **pc);
+    void * eval_decoded_field (tuple_t tuple, const unsigned char **pc,
+                               const decoded_fields *decoded, int operand);
     int execute_iter (const unsigned char *pc, Register *reg, int isNew, int isLinear);
     void execute_run_action (const unsigned char *pc, Register *reg, int isNew);
     void * eval_reg(const unsigned char value, const unsigned char **pc, Register *reg);
@@ -776,14 +1015,14 @@ class MeldInterpretVM {
     void execute_call1 (const unsigned char *pc, Register *reg);
     void execute_run_action0 (tuple_t action_tuple, tuple_type type, int isNew);
     void execute_remove (const unsigned char *pc, Register *reg, int isNew);
-    void execute_mvintfield (const unsigned char *pc, Register *reg);
+    void execute_mvintfield (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
     void execute_mvintreg (const unsigned char *pc, Register *reg);
     void execute_mvfloatreg (const unsigned char *pc, Register *reg);
-    void execute_mvfloatfield (const unsigned char *pc, Register *reg);
-    void execute_mvfieldreg (const unsigned char *pc, Register *reg);
-    void execute_mvfieldfield (const unsigned char *pc, Register *reg);
-    void execute_mvregfield (const unsigned char *pc, Register *reg);
-    void execute_mvhostfield (const unsigned char *pc, Register *reg);
+    void execute_mvfloatfield (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
+    void execute_mvfieldreg (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
+    void execute_mvfieldfield (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
+    void execute_mvregfield (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
+    void execute_mvhostfield (const unsigned char *pc, Register *reg, const decoded_fields *decoded);
     void execute_mvhostreg (const unsigned char *pc, Register *reg);
     void execute_mvregreg (const unsigned char *pc, Register *reg);
     void execute_not (const unsigned char *pc, Register *reg);
@@ -813,13 +1052,23 @@ class MeldInterpretVM {
     void execute_floatlesserequal (const unsigned char *pc, Register *reg);
     void execute_floatgreater (const unsigned char *pc, Register *reg);
     void execute_floatgreaterequal (const unsigned char *pc, Register *reg);
-    bool aggregate_accumulate(int agg_type, void *acc, void *obj, int count);
     bool aggregate_changed(int agg_type, void *v1, void *v2);
     void aggregate_seed(int agg_type, void *acc, void *start, int count, size_t size);
     void aggregate_free(tuple_t tuple, unsigned char field_aggregate, unsigned char type_aggregate);
     void aggregate_recalc(tuple_entry *agg, Register *reg, bool first_run);
     void databaseConsistencyChecker();
 
+    /* ************* DATABASE INDEX PROTOTYPES ************* */
+
+    uint64_t tuple_key(tuple_type type, tuple_t tuple);
+    bool index_first_arg(tuple_type type);
+    tuple_index *get_index(tuple_type type);
+    void index_insert(tuple_type type, tuple_entry *entry);
+    void index_remove(tuple_type type, tuple_entry *entry);
+    tuple_entry *record_find(tuple_type type, tuple_t tuple);
+    std::vector<tuple_entry*> *index_find(tuple_hash_index &index, uint64_t key);
+    Register *iter_match_value(const unsigned char **pc, Register *reg);
+
 
 
     /* ************* QUEUE MANAGEMENT PROTOTYPES ************* */
@@ -828,27 +1077,27 @@ class MeldInterpretVM {
     bool queue_is_empty(tuple_queue *queue);
     tuple_t queue_dequeue(tuple_queue *queue, int *isNew);
     tuple_t queue_dequeue_pos(tuple_queue *queue, tuple_entry **pos);
+    tuple_t queue_remove(tuple_queue *queue, tuple_entry *entry);
     tuple_t queue_pop_tuple(tuple_queue *queue);
     void queue_push_tuple(tuple_queue *queue, tuple_entry *entry);
 
+    /* Returns the database queue of type, allocated on first use */
+    inline tuple_queue *get_tuples(tuple_type type) {
+        if (tuples[type] == NULL) {
+            tuples[type] = (tuple_queue*)arena.allocate(sizeof(tuple_queue));
+            queue_init(tuples[type]);
+        }
+        return tuples[type];
+    }
+
     static inline void queue_init(tuple_queue *queue)
         {
             queue->head = NULL;
             queue->tail = NULL;
+            queue->length = 0;
         }
 
-    static inline bool p_empty(tuple_pqueue *q)
-        {
-            return q->queue == NULL;
-        }
-
-    static inline tuple_pentry* p_peek(tuple_pqueue *q)
-        {
-            return q->queue;
-        }
-
-    tuple_pentry *p_dequeue(tuple_pqueue *q);
-    void p_enqueue(tuple_pqueue *q, Time priority, tuple_t tuple, NodeID rt, record_type isNew);
+    tuple_pentry *p_alloc(Time priority, tuple_t tuple, NodeID rt, record_type isNew);
     int queue_length (tuple_queue *queue);
 };
 
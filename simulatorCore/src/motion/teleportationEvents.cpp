@@ -12,6 +12,7 @@
 #include "../base/world.h"
 //#include "../robots/catoms3D/catoms3DWorld.h"
 #include "../utils/utils.h"
+#include "../replay/traceExporter.h"
 
 using namespace BaseSimulator::utils;
 
@@ -47,6 +48,8 @@ void TeleportationStartEvent::consume() {
     Scheduler *scheduler = getScheduler();
     BuildingBlock *bb = concernedBlock;
     World::getWorld()->disconnectBlock(bb, false);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionStart(scheduler->now(), bb->blockId);
 
     Time t = scheduler->now() + ANIMATION_DELAY;
     if (getWorld()->lattice->isInGrid(finalPosition)) {
@@ -130,6 +133,8 @@ void TeleportationEndEvent::consume() {
         );
     StatsCollector::getInstance().incMotionCount();
     StatsIndividual::incMotionCount(bb->stats);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionEnd(date, bb->blockId);
 }
 
 const string TeleportationEndEvent::getEventName() {
@@ -9,6 +9,7 @@
 
 #include "../motion/translationEvents.h"
 #include "../base/world.h"
+#include "../replay/traceExporter.h"
 
 using namespace BaseSimulator::utils;
 
@@ -50,6 +51,8 @@ void TranslationStartEvent::consume() {
     BuildingBlock *bb = concernedBlock;
     World::getWorld()->disconnectBlock(bb, false);
     // bb->setColor(DARKGREY);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionStart(scheduler->now(), bb->blockId);
 
     Time t = scheduler->now() + ANIMATION_DELAY;
     Vector3D motionPosition = bb->getPositionVector();
@@ -190,6 +193,8 @@ void TranslationEndEvent::consume() {
     concernedBlock->blockCode->processLocalEvent(EventPtr(new TranslationEndEvent(date,bb)));
     StatsCollector::getInstance().incMotionCount();
     StatsIndividual::incMotionCount(bb->stats);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionEnd(date, bb->blockId);
 }
 
 const string TranslationEndEvent::getEventName() {
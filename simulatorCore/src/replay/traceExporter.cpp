@@ -0,0 +1,101 @@
+/**
+ * @file   traceExporter.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Timeline exporter in the Chrome Trace Event JSON format
+ */
+
+#include <iomanip>
+
+#include "traceExporter.h"
+#include "../events/scheduler.h"
+
+using namespace BaseSimulator;
+
+TraceExporter::TraceExporter() : buffer(bufferSize) {
+    cout << TermColor::BWhite
+         << "(trace) exporting simulation timeline to file: " << TermColor::Reset
+         << fileName << endl;
+
+    exportFile.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    exportFile.open(fileName, ios::out | ios::trunc);
+    if (not exportFile)
+        throw VisibleSimException("(error) TraceExporter: cannot open trace file " + fileName);
+
+    exportFile << fixed << setprecision(3) << "[";
+    const char *processNames[] = { "", "Simulated time", "Host time" };
+    for (Process pid : { SIMULATED_TIME, HOST_TIME }) {
+        beginEvent("M", pid, 0) << ", \"name\": \"process_name\", \"args\": { \"name\": \""
+                                << processNames[pid] << "\" } }";
+    }
+
+    origin = chrono::steady_clock::now();
+}
+
+ofstream& TraceExporter::beginEvent(const char *phase, Process pid, bID tid) {
+    uint8_t &named = namedTracks[tid];
+    if (not (named & (1 << pid))) {
+        named |= 1 << pid;
+        exportFile << (firstEvent ? "\n" : ",\n")
+                   << "{ \"ph\": \"M\", \"pid\": " << pid << ", \"tid\": " << tid
+                   << ", \"name\": \"thread_name\", \"args\": { \"name\": \"";
+        if (tid) exportFile << "Module #" << tid;
+        else exportFile << "Simulator";
+        exportFile << "\" } }";
+        firstEvent = false;
+    }
+
+    exportFile << (firstEvent ? "\n" : ",\n")
+               << "{ \"ph\": \"" << phase << "\", \"pid\": " << pid << ", \"tid\": " << tid;
+    firstEvent = false;
+    return exportFile;
+}
+
+ofstream& TraceExporter::writeSpan(Process pid, bID tid, const string &name, double ts, double dur,
+                                   uint64_t flow, bool flowOut) {
+    beginEvent("X", pid, tid) << ", \"name\": \"" << name << "\", \"ts\": " << ts
+                              << ", \"dur\": " << dur;
+    if (flow)
+        exportFile << ", \"bind_id\": \"0x" << hex << flow << dec << "\", \""
+                   << (flowOut ? "flow_out" : "flow_in") << "\": true";
+    return exportFile;
+}
+
+void TraceExporter::writeEvent(const EventPtr &pev, double start, double dur) {
+    BuildingBlock *bb = pev->getConcernedBlock();
+    writeSpan(HOST_TIME, bb ? bb->blockId : 0, pev->getEventName(), start, dur)
+        << ", \"args\": { \"id\": " << pev->id << ", \"date\": " << pev->date << " } }";
+}
+
+void TraceExporter::writeMessageSend(const Message &msg, bID sender) {
+    const string &name = "send " + messageName(msg);
+    writeSpan(SIMULATED_TIME, sender, name, getScheduler()->now(), 0,
+              flowId(msg, SIMULATED_TIME), true) << " }";
+    writeSpan(HOST_TIME, sender, name, hostTime(), 0, flowId(msg, HOST_TIME), true) << " }";
+}
+
+void TraceExporter::writeMessageReceive(const Message &msg, bID receiver, double start, double dur) {
+    const string &name = "receive " + messageName(msg);
+    writeSpan(SIMULATED_TIME, receiver, name, getScheduler()->now(), 0,
+              flowId(msg, SIMULATED_TIME), false) << " }";
+    writeSpan(HOST_TIME, receiver, name, start, dur, flowId(msg, HOST_TIME), false) << " }";
+}
+
+void TraceExporter::writeMotionStart(Time date, bID bid) {
+    motionStarts[bid] = date;
+}
+
+void TraceExporter::writeMotionEnd(Time date, bID bid) {
+    auto it = motionStarts.find(bid);
+    if (it == motionStarts.end()) return;
+
+    writeSpan(SIMULATED_TIME, bid, "motion", it->second, date - it->second) << " }";
+    motionStarts.erase(it);
+}
+
+void TraceExporter::endExport() {
+    if (not exportFile.is_open()) return;
+
+    exportFile << "\n]\n";
+    exportFile.close();
+}
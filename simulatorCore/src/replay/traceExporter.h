@@ -0,0 +1,171 @@
+/**
+ * @file   traceExporter.h
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Timeline exporter in the Chrome Trace Event JSON format
+ *
+ * The trace can be opened with chrome://tracing or https://ui.perfetto.dev and shows
+ *  two processes, each with one track (thread) per module:
+ *  - "Simulated time": timestamps are simulation dates. Motions are spans, message
+ *    sends and receives are zero-length slices linked by flow arrows.
+ *  - "Host time": timestamps are wall-clock times since scheduler start. Every consumed
+ *    event and message handler is a span, sends and receives are linked by flow arrows.
+ * Flows are identified by Message::id. The trace is streamed to disk through a fixed
+ *  size buffer, only per-module bookkeeping is kept in memory.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/tDefs.h"
+#include "../events/events.h"
+
+using namespace std;
+
+/**
+ * Exports consumed events, messages and motions to a Chrome Trace Event JSON file
+ * @note To be used as a singleton instance
+ */
+class TraceExporter {
+    static inline TraceExporter* singleton = nullptr; //!< the singleton instance
+    static inline bool enabled = false; //!< true if trace export has been requested
+    static inline string fileName = "trace.json"; //!< trace file name
+    static inline const size_t bufferSize = 1 << 20; //!< size of the output buffer, in bytes
+
+    //!< Trace processes, used as pid in the trace
+    enum Process { SIMULATED_TIME = 1, HOST_TIME = 2 };
+
+    vector<char> buffer; //!< output buffer of exportFile
+    ofstream exportFile; //!< trace file
+    bool firstEvent = true; //!< true until the first trace event has been written
+    chrono::steady_clock::time_point origin; //!< host time origin of the trace
+    unordered_map<bID, uint8_t> namedTracks; //!< bit p is set if the track of a module in process p is named
+    unordered_map<bID, Time> motionStarts; //!< start date of the ongoing motion of each module
+
+    /**
+     * Writes the separator and common fields of a new trace event,
+     *  and the metadata naming the track of the module if it is new
+     * @return the export file, to write the remaining fields and closing brace
+     */
+    ofstream& beginEvent(const char *phase, Process pid, bID tid);
+
+    /**
+     * Writes a complete event (span), without its closing brace
+     * @param flow if not 0, binds the span to a flow with this id
+     * @param flowOut true if flow starts at this span, false if it ends there
+     * @return the export file, to write additional fields and the closing brace
+     */
+    ofstream& writeSpan(Process pid, bID tid, const string &name, double ts, double dur,
+                        uint64_t flow = 0, bool flowOut = false);
+
+    //!< @return the flow id of a message in a process, flows must not be shared by processes
+    static inline uint64_t flowId(const Message &msg, Process pid) {
+        return 2 * msg.id + (pid == SIMULATED_TIME ? 1 : 2);
+    }
+
+    //!< @return the trace name of a message
+    static inline string messageName(const Message &msg) {
+        return "message " + to_string(msg.type);
+    }
+
+    TraceExporter();
+public:
+    TraceExporter(const TraceExporter&) = delete;
+    virtual ~TraceExporter() {}
+
+    /**
+     * Enables trace export
+     * @param fn trace file name, default file name is used if empty
+     * @attention must be called before the first getInstance() call
+     */
+    static inline void enable(const string &fn) {
+        enabled = true;
+        if (not fn.empty()) fileName = fn;
+    }
+
+    /**
+     * @return true if a trace is being exported for this instance of the simulation
+     */
+    static inline bool isTraceEnabled() { return enabled; }
+
+    /**
+     * Singleton getter, opens the trace file and sets host time origin on first call
+     * @return the singleton instance
+     */
+    static TraceExporter* getInstance() {
+        if (not singleton)
+            singleton = new TraceExporter();
+
+        return singleton;
+    }
+
+    //!< @return host time since the trace origin, in microseconds
+    inline double hostTime() const {
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - origin).count();
+    }
+
+    /**
+     * Writes the host time span of a consumed event on the track of its module
+     * @param pev consumed event
+     * @param start host time at which consumption started
+     * @param dur host duration of the consumption
+     */
+    void writeEvent(const EventPtr &pev, double start, double dur);
+
+    /**
+     * Writes the sending of a message, as the start of a flow ending at its reception
+     * @param msg sent message
+     * @param sender id of the sending module
+     */
+    void writeMessageSend(const Message &msg, bID sender);
+
+    /**
+     * Writes the handling of a received message, as the end of its flow
+     * @param msg received message
+     * @param receiver id of the receiving module
+     * @param start host time at which the handler started
+     * @param dur host duration of the handler
+     */
+    void writeMessageReceive(const Message &msg, bID receiver, double start, double dur);
+
+    //!< Records the start date of a motion of module bid
+    void writeMotionStart(Time date, bID bid);
+    //!< Writes the simulated time span of the motion of module bid ending at date
+    void writeMotionEnd(Time date, bID bid);
+
+    /**
+     * Terminates the JSON array and closes the trace file
+     * @note Is called at scheduler end
+     */
+    void endExport();
+
+    //!< Writes the host time span of an event consumed during the lifetime of the object
+    class EventScope {
+        const EventPtr &pev;
+        double start;
+    public:
+        EventScope(const EventPtr &ev) : pev(ev), start(enabled ? getInstance()->hostTime() : 0) {};
+        ~EventScope() {
+            if (enabled) getInstance()->writeEvent(pev, start, getInstance()->hostTime() - start);
+        };
+    };
+
+    //!< Writes the reception of a message handled during the lifetime of the object
+    class HandlerScope {
+        const MessagePtr &msg;
+        bID receiver;
+        double start;
+    public:
+        HandlerScope(const MessagePtr &m, bID r)
+            : msg(m), receiver(r), start(enabled ? getInstance()->hostTime() : 0) {};
+        ~HandlerScope() {
+            if (enabled)
+                getInstance()->writeMessageReceive(*msg, receiver, start,
+                                                   getInstance()->hostTime() - start);
+        };
+    };
+};
@@ -74,4 +74,10 @@ void Catoms3DSimulator::loadBlock(TiXmlElement *blockElt, bID blockId,
     world->getBlockById(blockId)->blockCode->parseUserBlockElements(blockElt);
 }
 
+void Catoms3DSimulator::loadObstacle(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos,
+                                     const Color &color, short orientation, bool master) {
+    // Obstacle modules are only simulated by Hexanodes, they are static obstacles here
+    world->addObstacle(pos, color);
+}
+
 } // Catoms3D namespace
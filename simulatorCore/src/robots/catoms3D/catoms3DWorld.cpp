@@ -220,8 +220,9 @@ void Catoms3DWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosi
         blockId = incrementBlockId();
 
     Catoms3DBlock *catom = new Catoms3DBlock(blockId,bcb);
-    buildingBlocksMap.insert(std::pair<int,BaseSimulator::BuildingBlock*>
-                             (catom->blockId, (BaseSimulator::BuildingBlock*)catom));
+    // IDs are mostly increasing, hint at the end of the map for constant time insertion
+    buildingBlocksMap.emplace_hint(buildingBlocksMap.end(),
+                                   catom->blockId, (BaseSimulator::BuildingBlock*)catom);
 
     // // FIXME: Adversarial start, randomly initiate start event
     // std::mt19937 rng;
@@ -229,7 +230,7 @@ void Catoms3DWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosi
     // std::uniform_int_distribution<std::mt19937::result_type> u500(0,500);
     // getScheduler()->schedule(new CodeStartEvent(getScheduler()->now() + u500(rng), catom));
     // getScheduler()->schedule(new CodeStartEvent(getScheduler()->now(), catom));
-    getScheduler()->schedule(new CodeStartEvent(getScheduler()->now() + 1000, catom));
+    bool deferred = scheduleCodeStart(catom, getScheduler()->now() + 1000);
 
     Catoms3DGlBlock *glBlock = new Catoms3DGlBlock(blockId);
     glBlock->setPosition(lattice->gridToWorldPosition(pos));
@@ -244,7 +245,7 @@ void Catoms3DWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosi
     lock();
     mapGlBlocks.insert(make_pair(blockId, glBlock));
     unlock();
-    linkBlock(pos);
+    if (not deferred) linkBlock(pos);
 }
 
 /**
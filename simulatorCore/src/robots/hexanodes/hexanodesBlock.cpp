@@ -121,9 +121,11 @@ void HexanodesBlock::setPositionAndOrientation(const Cell3DPosition &pos, uint8_
     orientationCode = code;
     position = pos;
 
-    cout << "setPositionAndOrientation:" << pos << endl;
     Matrix M=getMatrixFromPositionAndOrientation(pos,code);
+#ifdef DEBUG_WORLD_LOADING
+    cout << "setPositionAndOrientation:" << pos << endl;
     cout << M << endl;
+#endif
     getWorld()->updateGlData(this,M);
     getWorld()->updateGlData(this,position);
 
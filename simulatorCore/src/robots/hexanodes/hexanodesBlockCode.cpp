@@ -11,6 +11,8 @@
 #include <iostream>
 #include "../../comm/network.h"
 #include "../../utils/trace.h"
+#include "../../stats/eventProfiler.h"
+#include "../../replay/traceExporter.h"
 #include "hexanodesBlockCode.h"
 
 
@@ -43,6 +45,8 @@ void HexanodesBlockCode::processLocalEvent(EventPtr pev) {
             // search message id in eventFuncMap
             multimap<int,eventFunc>::iterator im = eventFuncMap.find(message->type);
             multimap<int,eventFunc2>::iterator im2 = eventFuncMap2.find(message->type);
+            BaseSimulator::utils::EventProfiler::MessageScope profile(message->type);
+            TraceExporter::HandlerScope trace(message, hostBlock->blockId);
             if (im!=eventFuncMap.end()) {
                 P2PNetworkInterface *recv_interface = message->destinationInterface;
                 (*im).second(this,message,recv_interface);
@@ -11,6 +11,7 @@
 #include "hexanodesMotionEvents.h"
 #include "../../base/world.h"
 #include "../../utils/utils.h"
+#include "../../replay/traceExporter.h"
 #include "hexanodesBlock.h"
 
 using namespace BaseSimulator::utils;
@@ -48,6 +49,8 @@ void HexanodesMotionStartEvent::consume() {
     Scheduler *scheduler = getScheduler();
     BuildingBlock *bb = concernedBlock;
     World::getWorld()->disconnectBlock(bb);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionStart(scheduler->now(), bb->blockId);
 
     Time t = scheduler->now() + ANIMATION_DELAY;
     if (getWorld()->lattice->isInGrid(finalPosition)) {
@@ -132,6 +135,8 @@ void HexanodesMotionEndEvent::consume() {
         );
     StatsCollector::getInstance().incMotionCount();
     StatsIndividual::incMotionCount(bb->stats);
+    if (TraceExporter::isTraceEnabled())
+        TraceExporter::getInstance()->writeMotionEnd(date, bb->blockId);
 }
 
 const string HexanodesMotionEndEvent::getEventName() {
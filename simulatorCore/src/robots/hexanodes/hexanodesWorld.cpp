@@ -195,11 +195,13 @@ void HexanodesWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPos
     else if (blockId == 0)
         blockId = incrementBlockId();
 
-    HexanodesBlock *module = new HexanodesBlock(blockId,bcb);
-    buildingBlocksMap.insert(std::pair<int,BaseSimulator::BuildingBlock*>
-                             (module->blockId, (BaseSimulator::BuildingBlock*)module));
+    HexanodesBlock *module = static_cast<HexanodesBlock*>(takePrefabricatedBlock(blockId));
+    if (not module) module = new HexanodesBlock(blockId,bcb);
+    // IDs are mostly increasing, hint at the end of the map for constant time insertion
+    buildingBlocksMap.emplace_hint(buildingBlocksMap.end(),
+                                   module->blockId, (BaseSimulator::BuildingBlock*)module);
 
-    getScheduler()->schedule(new CodeStartEvent(getScheduler()->now(), module));
+    bool deferred = scheduleCodeStart(module, getScheduler()->now());
 
     HexanodesGlBlock *glBlock = new HexanodesGlBlock(blockId);
     mapGlBlocks.insert(make_pair(blockId, glBlock));
@@ -210,8 +212,7 @@ void HexanodesWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPos
     module->setPositionAndOrientation(pos,orientation);
     lattice->insert(module, pos);
     glBlock->setPosition(lattice->gridToWorldPosition(pos));
-    linkBlock(pos);
-
+    if (not deferred) linkBlock(pos);
 }
 
 
@@ -219,7 +220,8 @@ void HexanodesWorld::addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPos
 
 void HexanodesWorld::addObstacle(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos, const Color &col, short orientation){
 
-    HexanodesBlock *module = new HexanodesBlock(blockId,bcb);
+    HexanodesBlock *module = static_cast<HexanodesBlock*>(takePrefabricatedBlock(blockId));
+    if (not module) module = new HexanodesBlock(blockId,bcb);
     buildingBlocksMap.insert(std::pair<int,BaseSimulator::BuildingBlock*>
                              (module->blockId, (BaseSimulator::BuildingBlock*)module));
 
@@ -443,8 +445,8 @@ void HexanodesWorld::disconnectBlock(BuildingBlock *block) {
             toBlock = fromBlock->connectedInterface;
 
             // Clear message queue
-            fromBlock->outgoingQueue.clear();
-            toBlock->outgoingQueue.clear();
+            fromBlock->clearOutgoingQueue();
+            toBlock->clearOutgoingQueue();
 
             // Notify respective codeBlocks
             block->removeNeighbor(fromBlock);
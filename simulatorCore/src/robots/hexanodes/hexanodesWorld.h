@@ -63,6 +63,10 @@ class HexanodesWorld : public BaseSimulator::World {
         return((HexanodesBlock*)World::getBlockById(bId));
     }
 
+    BaseSimulator::BuildingBlock *createBlock(bID blockId, BlockCodeBuilder bcb) override {
+        return new HexanodesBlock(blockId, bcb);
+    }
+
     virtual void addBlock(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos, const Color &col,
                           short orientation, bool master) override;
 
@@ -63,4 +63,10 @@ void SlidingCubesSimulator::loadBlock(TiXmlElement *blockElt, bID blockId, Block
     world->getBlockById(blockId)->blockCode->parseUserBlockElements(blockElt);
 }
 
+void SlidingCubesSimulator::loadObstacle(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos,
+                                         const Color &color, short orientation, bool master) {
+    // Obstacle modules are only simulated by Hexanodes, they are static obstacles here
+    world->addObstacle(pos, color);
+}
+
 } // SlidingCubes namespace
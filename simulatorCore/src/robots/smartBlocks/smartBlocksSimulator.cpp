@@ -63,4 +63,10 @@ void SmartBlocksSimulator::loadBlock(TiXmlElement *blockElt, bID blockId, BlockC
     world->getBlockById(blockId)->blockCode->parseUserBlockElements(blockElt);
 }
 
+void SmartBlocksSimulator::loadObstacle(bID blockId, BlockCodeBuilder bcb, const Cell3DPosition &pos,
+                                        const Color &color, short orientation, bool master) {
+    // Obstacle modules are only simulated by Hexanodes, they are static obstacles here
+    world->addObstacle(pos, color);
+}
+
 } // SmartBlocks namespace
@@ -1,5 +1,8 @@
-#include <map>
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <random>
+#include <thread>
 
 #include "configStat.h"
 #include "../events/scheduler.h"
@@ -8,23 +11,24 @@
 using namespace std;
 using namespace BaseSimulator;
 
-ConfigStat::ConfigStat(BaseSimulator::World *w) {
+ConfigStat::ConfigStat(BaseSimulator::World *w, int samples, unsigned int threads) {
     diameter = 0;
     radius = 0;
     size = 0;
+    nbSamples = samples;
+    nbThreads = threads;
     world = w;
-    distanceMatrix = NULL;
-    eccentricity = NULL;
-    closenessCentrality = NULL;
-    betweennessCentrality = NULL;
     compute();
 }
 
 void ConfigStat::deleteComputation() {
-    delete[] eccentricity; eccentricity = NULL;
-    delete[] closenessCentrality; closenessCentrality = NULL;
-    delete[] betweennessCentrality; betweennessCentrality = NULL;
-    delete distanceMatrix; distanceMatrix = NULL;
+    blocks.clear();
+    vertexOf.clear();
+    adjacencyOffsets.clear();
+    adjacency.clear();
+    eccentricity.clear();
+    closenessCentrality.clear();
+    betweennessCentrality.clear();
     center.clear();
     centroid.clear();
     betweennessCenter.clear();
@@ -32,14 +36,6 @@ void ConfigStat::deleteComputation() {
     radius = 0;
 }
 
-void ConfigStat::initComputation() {
-    size = world->getMap().size()+1;
-    distanceMatrix = new SquareMatrix(size);
-    eccentricity = new int[size];
-    closenessCentrality = new int[size];
-    betweennessCentrality = new int[size];
-}
-
 ConfigStat::~ConfigStat() {
     deleteComputation();
 }
@@ -64,67 +60,159 @@ list<BaseSimulator::BuildingBlock*>& ConfigStat::getBetweennessCenter() {
     return betweennessCenter;
 }
 
+int ConfigStat::getEccentricity(bID id) {
+    return eccentricity[vertexOf.at(id)];
+}
+
+double ConfigStat::getClosenessCentrality(bID id) {
+    return closenessCentrality[vertexOf.at(id)];
+}
+
+double ConfigStat::getBetweennessCentrality(bID id) {
+    return betweennessCentrality[vertexOf.at(id)];
+}
 
 void ConfigStat::compute() {
 
     deleteComputation();
-    initComputation();
 
-    computeDistanceMatrix();
+    buildAdjacencyLists();
+    computeMetrics();
     computeCenter();
     computeCentroid();
     computeBetweennessCenter();
 }
 
-void ConfigStat::computeDistanceMatrix() {
-    int size = distanceMatrix->getSize();
-    bool adjacencyMatrix[size][size];
-    int distTmp;
+void ConfigStat::buildAdjacencyLists() {
+    size = world->getMap().size();
+    blocks.reserve(size);
+    vertexOf.reserve(size);
+    for (const auto &it : world->getMap()) {
+        vertexOf[it.first] = blocks.size();
+        blocks.push_back(it.second);
+    }
 
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            adjacencyMatrix[i][j] = false;
-            distanceMatrix->set(i, j, INT_MAX);
+    adjacencyOffsets.resize(size + 1);
+    for (int v = 0; v < size; v++) {
+        adjacencyOffsets[v] = adjacency.size();
+        for (P2PNetworkInterface *ni : blocks[v]->getP2PNetworkInterfaces()) {
+            if (ni->connectedInterface) {
+                auto it = vertexOf.find(ni->connectedInterface->hostBlock->blockId);
+                if (it != vertexOf.end()) adjacency.push_back(it->second);
+            }
         }
+        // Several links between the same modules would be counted as several shortest paths
+        auto first = adjacency.begin() + adjacencyOffsets[v];
+        sort(first, adjacency.end());
+        adjacency.erase(unique(first, adjacency.end()), adjacency.end());
     }
+    adjacencyOffsets[size] = adjacency.size();
+}
 
-    map<bID, BuildingBlock*>::iterator bit;
-    for (bit = world->getMap().begin() ; bit != world->getMap().end() ; bit++) {
-        vector<P2PNetworkInterface*>::const_iterator niit;
-        for (niit = bit->second->getP2PNetworkInterfaces().begin(); niit != bit->second->getP2PNetworkInterfaces().end(); niit++) {
-            if ((*niit)->connectedInterface) {
-                adjacencyMatrix[bit->second->blockId][(*niit)->connectedInterface->hostBlock->blockId] = true;
-            }
+void ConfigStat::computeMetrics() {
+    eccentricity.assign(size, 0);
+    closenessCentrality.assign(size, 0);
+    betweennessCentrality.assign(size, 0);
+    if (size == 0) return;
+
+    // BFS sources: all modules, or a random subset of them in sampling mode
+    vector<int> sources(size);
+    for (int v = 0; v < size; v++) sources[v] = v;
+    if (nbSamples > 0 and nbSamples < size) {
+        mt19937 generator(0);
+        for (int i = 0; i < nbSamples; i++) {
+            uniform_int_distribution<int> dist(i, size - 1);
+            swap(sources[i], sources[dist(generator)]);
         }
+        sources.resize(nbSamples);
     }
+    const int nbSources = sources.size();
+
+    unsigned int threads = nbThreads ? nbThreads : max(1u, thread::hardware_concurrency());
+    threads = min<unsigned int>(threads, nbSources);
+
+    // Each thread accumulates the metrics of the sources it processes
+    struct Accumulator {
+        vector<int> eccentricity;
+        vector<double> closeness;
+        vector<double> betweenness;
+        bool disconnected = false;
+    };
+    vector<Accumulator> acc(threads);
+    atomic<int> nextSource(0);
 
-    bool changed = false;
-    for (int s = 1; s < size; s++) {
-        distanceMatrix->set(s,s,0);
-        for (int i = 1; i < size; i++ ) {
-            changed = false;
-            for (int u = 1; u < size; u++ ) {
-                for (int v = 1; v < size; v++) {
-                    if (adjacencyMatrix[u][v]) {
-                        //if (distance[s][v] != UINT_MAX) {
-                        if (distanceMatrix->get(s,u) != INT_MAX) {
-                            //distTmp = distance[s][u] + 1;
-                            distTmp = distanceMatrix->get(s,u) + 1;
-                            //if (distTmp < distance[s][v]) {
-                            //cout << "distTmp" <<
-                            if (distTmp < distanceMatrix->get(s,v)) {
-                                //cout << "set: " << s << "," << v << ": " << v << endl;
-                                distanceMatrix->set(s,v,distTmp);
-                                distanceMatrix->set(v,s,distTmp);
-                                changed = true;
-                                //distance[s][v] = distTmp;
-                            }
-                        }
+    auto worker = [&](Accumulator &a) {
+        a.eccentricity.assign(size, 0);
+        a.closeness.assign(size, 0);
+        a.betweenness.assign(size, 0);
+        vector<int> distance(size, -1);
+        vector<double> sigma(size, 0); // number of shortest paths from the source
+        vector<double> delta(size, 0); // dependency of the source on each vertex
+        vector<int> order; // vertices by non-decreasing distance, used as BFS queue
+        order.reserve(size);
+
+        int i;
+        while ((i = nextSource++) < nbSources) {
+            const int s = sources[i];
+            order.clear();
+            distance[s] = 0;
+            sigma[s] = 1;
+            order.push_back(s);
+            for (size_t head = 0; head < order.size(); head++) {
+                const int v = order[head];
+                for (int k = adjacencyOffsets[v]; k < adjacencyOffsets[v + 1]; k++) {
+                    const int w = adjacency[k];
+                    if (distance[w] < 0) {
+                        distance[w] = distance[v] + 1;
+                        sigma[w] = 0;
+                        order.push_back(w);
                     }
+                    if (distance[w] == distance[v] + 1) sigma[w] += sigma[v];
                 }
             }
-            if(!changed) break;
+            if ((int)order.size() < size) a.disconnected = true;
+
+            // Brandes' back-propagation of dependencies, in non-increasing distance order
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                const int w = *it;
+                for (int k = adjacencyOffsets[w]; k < adjacencyOffsets[w + 1]; k++) {
+                    const int v = adjacency[k];
+                    if (distance[v] == distance[w] - 1)
+                        delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+                }
+                if (w != s) a.betweenness[w] += delta[w];
+                a.eccentricity[w] = max(a.eccentricity[w], distance[w]);
+                a.closeness[w] += distance[w];
+            }
+
+            for (int v : order) {
+                distance[v] = -1;
+                delta[v] = 0;
+            }
         }
+    };
+
+    vector<thread> pool;
+    for (unsigned int t = 1; t < threads; t++) pool.emplace_back(worker, ref(acc[t]));
+    worker(acc[0]);
+    for (thread &t : pool) t.join();
+
+    bool disconnected = false;
+    for (const Accumulator &a : acc) {
+        for (int v = 0; v < size; v++) {
+            eccentricity[v] = max(eccentricity[v], a.eccentricity[v]);
+            closenessCentrality[v] += a.closeness[v];
+            betweennessCentrality[v] += a.betweenness[v];
+        }
+        disconnected |= a.disconnected;
+    }
+
+    // Each undirected path is counted from both of its ends
+    const double scale = (double)size / nbSources;
+    for (int v = 0; v < size; v++) {
+        if (disconnected) eccentricity[v] = INT_MAX;
+        closenessCentrality[v] *= scale;
+        betweennessCentrality[v] *= scale / 2;
     }
 }
 
@@ -132,58 +220,56 @@ void ConfigStat::computeCenter() {
     radius = INT_MAX;
     diameter = 0;
 
-    for (int i = 1; i < size; i++) {
-        eccentricity[i] = 0;
-        for (int j = 1; j < size; j++) {
-            eccentricity[i] = max(eccentricity[i],distanceMatrix->get(i,j));
-        }
+    for (int i = 0; i < size; i++) {
         radius = min(radius, eccentricity[i]);
         diameter = max(diameter, eccentricity[i]);
     }
 
-    for (int i = 1; i < size; i++) {
+    for (int i = 0; i < size; i++) {
         if (eccentricity[i] == radius) {
-            center.push_back(world->getBlockById(i));
+            center.push_back(blocks[i]);
         }
     }
 }
 
 void ConfigStat::computeCentroid() {
-    int minSum = INT_MAX;
-    int maxSum = 0;
+    if (size == 0) return;
+    double minSum = *min_element(closenessCentrality.begin(), closenessCentrality.end());
 
-    for (int i = 1; i < size; i++) {
-        closenessCentrality[i] = 0;
-        for (int j = 1; j < size; j++) {
-            closenessCentrality[i] += distanceMatrix->get(i,j);
-        }
-        minSum = min(closenessCentrality[i], minSum);
-        maxSum = max(closenessCentrality[i], maxSum);
-    }
-
-    for (int i = 1; i < size; i++) {
+    for (int i = 0; i < size; i++) {
         if (closenessCentrality[i] == minSum) {
-            centroid.push_back(world->getBlockById(i));
+            centroid.push_back(blocks[i]);
         }
     }
-
-    (void) maxSum;
 }
 
 void ConfigStat::computeBetweennessCenter() {
-    // TODO
+    if (size == 0) return;
+    double maxBetweenness = *max_element(betweennessCentrality.begin(), betweennessCentrality.end());
+
+    for (int i = 0; i < size; i++) {
+        if (betweennessCentrality[i] == maxBetweenness) {
+            betweennessCenter.push_back(blocks[i]);
+        }
+    }
 }
 
 void ConfigStat::print(string name, list<BaseSimulator::BuildingBlock*>& l) {
     cout << name <<":";
     for (list<BaseSimulator::BuildingBlock*>::iterator it=l.begin(); it != l.end(); it++) {
-        cout << ' ' << (*it)->blockId << "(eccentricity:" << eccentricity[(*it)->blockId]<< ", closeness centrality:" <<  closenessCentrality[(*it)->blockId] << ")";
+        int v = vertexOf[(*it)->blockId];
+        cout << ' ' << (*it)->blockId << "(eccentricity:" << eccentricity[v]
+             << ", closeness centrality:" << closenessCentrality[v]
+             << ", betweenness centrality:" << betweennessCentrality[v] << ")";
     }
     cout << endl;
 }
 
 void ConfigStat::print() {
-    cout << "Diameter: " << diameter << "," << "radius: " << radius << endl;
+    cout << "Diameter: " << diameter << "," << "radius: " << radius;
+    if (nbSamples > 0 and nbSamples < size)
+        cout << " (approximated from " << nbSamples << " sources)";
+    cout << endl;
     print("Center", center);
     print("Centroid", centroid);
     print("Betweenness", betweennessCenter);
@@ -1,5 +1,5 @@
 /*
- * clock.h
+ * configStat.h
  *
  *  Created on: 26 march 2015
  *      Author: andre
@@ -10,37 +10,44 @@
 
 #include <list>
 #include <string>
+#include <vector>
+#include <unordered_map>
 
 #include "../base/buildingBlock.h"
 #include "../base/world.h"
 
 using namespace std;
 
-class SquareMatrix {
-    int size;
-    int *distances;
-
-public:
-    SquareMatrix(int s) {size = s; distances = new int[size*size];}
-    ~SquareMatrix() {delete[] distances;}
-
-    int getSize() {return size;}
-    void set(int i, int j, int v) {distances[i*size + j] = v;}
-    int get(int i, int j) {return distances[i*size + j];}
-};
-
 /**
  * Config Stat Computation
+ *
+ * The connectivity graph of the modules is stored as adjacency lists (CSR) built from
+ *  P2PNetworkInterface links. Metrics are accumulated from one BFS per source module,
+ *  in O(n.(n+m)) time and O(n+m) memory per thread:
+ *  - eccentricity (maximum distance), giving diameter, radius and center,
+ *  - closeness centrality (sum of the distances), giving the centroid,
+ *  - betweenness centrality (Brandes' algorithm), giving the betweenness center.
+ * Sources are processed on several threads. In sampling mode, only nbSamples random
+ *  sources are used: eccentricities are lower bounds, sums of distances and betweenness
+ *  are extrapolated to all sources (Brandes & Pich, 2007).
+ * Modules that cannot reach all others have an INT_MAX eccentricity.
  */
 
 class ConfigStat {
 private:
     BaseSimulator::World *world;
-    int size;
-    SquareMatrix *distanceMatrix;
-    int *eccentricity; // maximum distance
-    int *closenessCentrality; // sum of the distances
-    int *betweennessCentrality;
+    int size; // number of modules
+    int nbSamples; // number of BFS sources, all modules if 0
+    unsigned int nbThreads; // number of threads, all cores if 0
+
+    vector<BaseSimulator::BuildingBlock*> blocks; // module of each vertex
+    unordered_map<bID,int> vertexOf; // vertex of each module
+    vector<int> adjacencyOffsets; // neighbors of vertex v are adjacency[adjacencyOffsets[v]..adjacencyOffsets[v+1]-1]
+    vector<int> adjacency;
+
+    vector<int> eccentricity; // maximum distance
+    vector<double> closenessCentrality; // sum of the distances
+    vector<double> betweennessCentrality;
     int diameter;
     int radius;
 
@@ -48,7 +55,8 @@ class ConfigStat {
     list<BaseSimulator::BuildingBlock*> centroid;
     list<BaseSimulator::BuildingBlock*> betweennessCenter;
 
-    void computeDistanceMatrix();
+    void buildAdjacencyLists();
+    void computeMetrics();
     void computeCenter();
     void computeCentroid();
     void computeBetweennessCenter();
@@ -56,11 +64,15 @@ class ConfigStat {
     void print(string name,list<BaseSimulator::BuildingBlock*>& l);
 
     void deleteComputation();
-    void initComputation();
 
 public:
 
-    ConfigStat(BaseSimulator::World *w);
+    /**
+     * @param w world whose configuration is analyzed
+     * @param samples number of random BFS sources for approximate metrics, 0 for exact metrics
+     * @param threads number of threads, 0 to use all cores
+     */
+    ConfigStat(BaseSimulator::World *w, int samples = 0, unsigned int threads = 0);
     ~ConfigStat();
 
     void compute();
@@ -71,6 +83,10 @@ class ConfigStat {
     list<BaseSimulator::BuildingBlock*>& getCentroid();
     list<BaseSimulator::BuildingBlock*>& getBetweennessCenter();
 
+    int getEccentricity(bID id);
+    double getClosenessCentrality(bID id);
+    double getBetweennessCentrality(bID id);
+
     void print();
 };
 
@@ -0,0 +1,167 @@
+/*! @file eventProfiler.cpp
+ * @brief Per-event-type and per-message-type profiling of the scheduler
+ * Implemented following the singleton design pattern.
+ */
+
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+
+#include "eventProfiler.h"
+#include "../utils/trace.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+namespace utils {
+
+bool EventProfiler::enable = false;
+string EventProfiler::jsonFileName = "";
+string EventProfiler::sortKey = "total";
+
+static const string sortKeys[] = { "name", "count", "total", "mean", "p50", "p95", "p99", "max" };
+
+bool EventProfiler::isSortKey(const string &key) {
+    return find(begin(sortKeys), end(sortKeys), key) != end(sortKeys);
+}
+
+void EventProfiler::recordEvent(const EventPtr &pev, uint64_t ticks) {
+    ProfileEntry &entry = events[pev->eventType];
+    if (entry.count == 0) entry.name = pev->getEventName();
+    entry.add(ticks);
+}
+
+void EventProfiler::recordMessage(int type, uint64_t ticks) {
+    ProfileEntry &entry = messages[type];
+    if (entry.count == 0) entry.name = "Message #" + to_string(type);
+    entry.add(ticks);
+}
+
+void EventProfiler::start() {
+    startTime = chrono::steady_clock::now();
+    startTicks = now();
+}
+
+void EventProfiler::stop() {
+    uint64_t stopTicks = now();
+    double elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - startTime).count();
+    if (elapsedUs > 0 and stopTicks > startTicks)
+        ticksPerUs = (stopTicks - startTicks) / elapsedUs;
+}
+
+/**
+ * @brief Sorts the entries of a profile according to EventProfiler::sortKey,
+ *  by decreasing value (or increasing name)
+ */
+static vector<pair<int, const ProfileEntry*>>
+sortedEntries(const unordered_map<int, ProfileEntry> &profile) {
+    vector<pair<int, const ProfileEntry*>> res;
+    for (const auto &it : profile) res.push_back({ it.first, &it.second });
+
+    const string &key = EventProfiler::sortKey;
+    auto value = [&key](const ProfileEntry *e) -> double {
+        if (key == "count") return e->count;
+        if (key == "mean") return (double)e->total / e->count;
+        if (key == "p50") return e->percentile(50);
+        if (key == "p95") return e->percentile(95);
+        if (key == "p99") return e->percentile(99);
+        if (key == "max") return e->max;
+        return e->total;
+    };
+
+    sort(res.begin(), res.end(), [&](const pair<int, const ProfileEntry*> &a,
+                                     const pair<int, const ProfileEntry*> &b) {
+        if (key == "name") return a.second->name < b.second->name;
+        double va = value(a.second), vb = value(b.second);
+        return va != vb ? va > vb : a.first < b.first;
+    });
+    return res;
+}
+
+//!< Prints a profile as a table, durations in microseconds
+static void printTable(ostream &out, const string &title,
+                       const unordered_map<int, ProfileEntry> &profile, double ticksPerUs) {
+    uint64_t total = 0;
+    for (const auto &it : profile) total += it.second.total;
+
+    out << TermColor::BWhite << title << " (sorted by " << EventProfiler::sortKey << ")" << endl;
+    out << left << setw(46) << "type" << right << setw(10) << "count" << setw(12) << "total(ms)"
+        << setw(8) << "%" << setw(11) << "mean(us)" << setw(11) << "p50(us)" << setw(11) << "p95(us)"
+        << setw(11) << "p99(us)" << setw(11) << "max(us)" << endl;
+    out << TermColor::BMagenta << fixed;
+    for (const auto &it : sortedEntries(profile)) {
+        const ProfileEntry &e = *it.second;
+        out << left << setw(46) << (e.name + " (" + to_string(it.first) + ")") << right
+            << setw(10) << e.count
+            << setw(12) << setprecision(3) << e.total / ticksPerUs / 1000
+            << setw(8) << setprecision(1) << (total ? 100.0 * e.total / total : 0)
+            << setprecision(2)
+            << setw(11) << e.total / ticksPerUs / e.count
+            << setw(11) << e.percentile(50) / ticksPerUs
+            << setw(11) << e.percentile(95) / ticksPerUs
+            << setw(11) << e.percentile(99) / ticksPerUs
+            << setw(11) << e.max / ticksPerUs << endl;
+    }
+    out << TermColor::Reset;
+}
+
+ostream& operator<<(ostream& out, const EventProfiler &ep) {
+    out << TermColor::BBlue;
+    out << endl << "=== EVENT PROFILE ===" << endl;
+    printTable(out, "Event consume time", ep.events, ep.ticksPerUs);
+    if (not ep.messages.empty())
+        printTable(out, "Message handler time", ep.messages, ep.ticksPerUs);
+    out << TermColor::Reset;
+    return out;
+}
+
+//!< Escapes a string for use as a JSON string value
+static string jsonEscape(const string &s) {
+    string res;
+    for (char c : s) {
+        if (c == '"' or c == '\\') res += '\\';
+        if ((unsigned char)c >= 0x20) res += c;
+    }
+    return res;
+}
+
+//!< Writes a profile as a JSON array, durations in microseconds
+static void writeJSONArray(ostream &out, const unordered_map<int, ProfileEntry> &profile,
+                           double ticksPerUs) {
+    out << "[";
+    bool first = true;
+    for (const auto &it : sortedEntries(profile)) {
+        const ProfileEntry &e = *it.second;
+        out << (first ? "\n" : ",\n")
+            << "    { \"type\": " << it.first
+            << ", \"name\": \"" << jsonEscape(e.name) << "\""
+            << ", \"count\": " << e.count
+            << ", \"totalUs\": " << e.total / ticksPerUs
+            << ", \"meanUs\": " << e.total / ticksPerUs / e.count
+            << ", \"p50Us\": " << e.percentile(50) / ticksPerUs
+            << ", \"p95Us\": " << e.percentile(95) / ticksPerUs
+            << ", \"p99Us\": " << e.percentile(99) / ticksPerUs
+            << ", \"maxUs\": " << e.max / ticksPerUs << " }";
+        first = false;
+    }
+    out << (first ? "]" : "\n  ]");
+}
+
+bool EventProfiler::writeJSON(const string &fileName) const {
+    ofstream fout(fileName);
+    if (not fout) return false;
+
+    fout << fixed << setprecision(3);
+    fout << "{\n  \"ticksPerUs\": " << ticksPerUs << ",\n  \"sortKey\": \"" << sortKey << "\",\n";
+    fout << "  \"events\": ";
+    writeJSONArray(fout, events, ticksPerUs);
+    fout << ",\n  \"messages\": ";
+    writeJSONArray(fout, messages, ticksPerUs);
+    fout << "\n}\n";
+
+    return fout.good();
+}
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
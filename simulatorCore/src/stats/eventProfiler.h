@@ -0,0 +1,115 @@
+/*! @file eventProfiler.h
+ * @brief Per-event-type and per-message-type profiling of the scheduler,
+ *  enabled from the command line (--profile). Consume and handler durations are
+ *  measured with the CPU cycle counter when available, and kept in LogHistograms
+ *  to report percentiles without storing samples.
+ * Implemented following the singleton design pattern.
+ */
+
+#ifndef EVENTPROFILER_H__
+#define EVENTPROFILER_H__
+
+#include <iostream>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../events/events.h"
+#include "logHistogram.h"
+
+namespace BaseSimulator {
+namespace utils {
+
+//!< Duration statistics of one event or message type, in ticks
+class ProfileEntry : public LogHistogram {
+public:
+    std::string name; //!< printable name of the profiled type
+};
+
+//!< Singleton-based event profiler
+//!< @attention Any access to EventProfiler must be done through the getInstance() function
+class EventProfiler {
+public:
+    static bool enable; //!< Activation flag: true if event profiling is enabled
+    static std::string jsonFileName; //!< JSON output file, no JSON output if empty
+    static std::string sortKey; //!< table column used for sorting: name, count, total, mean, p50, p95, p99 or max
+
+    //<! @brief Used to get the singleton instance of EventProfiler.
+    //<! @return singleton instance of EventProfiler
+    static EventProfiler& getInstance() {
+        static EventProfiler instance;
+        return instance;
+    };
+
+    //!< @return true if key is a valid sortKey value
+    static bool isSortKey(const std::string &key);
+
+    //!< @return current value of the tick counter (CPU cycles, or nanoseconds if unavailable)
+    static inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    //!< Measures the consume time of an event for the lifetime of the object
+    class EventScope {
+        const EventPtr &pev;
+        uint64_t start;
+    public:
+        EventScope(const EventPtr &ev) : pev(ev), start(enable ? now() : 0) {};
+        ~EventScope() { if (enable) getInstance().recordEvent(pev, now() - start); };
+    };
+
+    //!< Measures the handler time of a message for the lifetime of the object
+    class MessageScope {
+        int type;
+        uint64_t start;
+    public:
+        MessageScope(int t) : type(t), start(enable ? now() : 0) {};
+        ~MessageScope() { if (enable) getInstance().recordMessage(type, now() - start); };
+    };
+
+    //!< Records the consume time of an event
+    void recordEvent(const EventPtr &pev, uint64_t ticks);
+    //!< Records the handler time of a message
+    void recordMessage(int type, uint64_t ticks);
+
+    //!< Starts tick counter calibration, called when the scheduler starts
+    void start();
+    //!< Ends tick counter calibration, called when the scheduler ends
+    void stop();
+
+    /**
+     * @brief Writes the collected statistics as JSON
+     * @param fileName path to the output file
+     * @return false if the file could not be written
+     */
+    bool writeJSON(const std::string &fileName) const;
+
+    //!< Prints collected statistics as tables sorted by sortKey
+    friend std::ostream& operator<<(std::ostream& out, const EventProfiler &ep);
+private:
+    EventProfiler() {};
+    EventProfiler(EventProfiler const&); //<! Disable copy constructor
+    void operator=(EventProfiler const&); //<! Disable assignment operator
+
+    std::unordered_map<int, ProfileEntry> events; //!< statistics per event type
+    std::unordered_map<int, ProfileEntry> messages; //!< statistics per message type
+
+    uint64_t startTicks = 0; //!< tick counter at scheduler start
+    std::chrono::steady_clock::time_point startTime; //!< wall clock at scheduler start
+    double ticksPerUs = 1000; //!< tick counter frequency, calibrated against the wall clock
+};                              // class EventProfiler
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
+
+#endif // EVENTPROFILER_H__
@@ -0,0 +1,42 @@
+/*! @file logHistogram.cpp
+ * @brief Streaming histogram of unsigned integer values, with constant memory.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "logHistogram.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+namespace utils {
+
+double LogHistogram::percentile(double p) const {
+    if (count == 0) return 0;
+
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t)(p / 100.0 * count + 0.5));
+    uint64_t seen = 0;
+    for (int b = 0; b < NB_BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen < rank) continue;
+        if (b < 16) return b;
+        // Bucket b covers [(8 + sub) << (e - 3), (9 + sub) << (e - 3)), return its middle
+        int e = 4 + (b - 16) / 8, sub = (b - 16) % 8;
+        double middle = ldexp(8 + sub, e - 3) + ldexp(0.5, e - 3);
+        return std::min(std::max(middle, (double)min), (double)max);
+    }
+    return max;
+}
+
+void LogHistogram::reset() {
+    count = 0;
+    total = 0;
+    min = UINT64_MAX;
+    max = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
@@ -0,0 +1,59 @@
+/*! @file logHistogram.h
+ * @brief Streaming histogram of unsigned integer values, with constant memory.
+ *  Values below 16 have their own bucket, then each power of two is split in 8 buckets,
+ *  so that percentiles are estimated with a relative error under 7%.
+ */
+
+#ifndef LOGHISTOGRAM_H__
+#define LOGHISTOGRAM_H__
+
+#include <cstdint>
+
+namespace BaseSimulator {
+namespace utils {
+
+//!< Log-linear histogram of uint64_t values
+class LogHistogram {
+public:
+    static const int NB_BUCKETS = 496; //!< buckets needed to cover 64-bit values
+
+    uint64_t count = 0; //!< number of values
+    uint64_t total = 0; //!< sum of the values
+    uint64_t min = UINT64_MAX; //!< smallest value
+    uint64_t max = 0; //!< largest value
+    uint64_t histogram[NB_BUCKETS] = {}; //!< number of values per bucket
+
+    //!< Adds a value to the histogram
+    inline void add(uint64_t v) {
+        count++;
+        total += v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+        histogram[bucketOf(v)]++;
+    }
+
+    //!< @return the mean of the values, 0 if empty
+    inline double mean() const { return count ? (double)total / count : 0; }
+
+    /**
+     * @brief Estimates a percentile of the values
+     * @param p percentile, in [0,100]
+     * @return estimated value, 0 if empty
+     */
+    double percentile(double p) const;
+
+    //!< Removes all values from the histogram
+    void reset();
+
+    //!< @return the bucket of value v
+    static inline int bucketOf(uint64_t v) {
+        if (v < 16) return v;
+        int e = 63 - __builtin_clzll(v);
+        return 16 + (e - 4) * 8 + ((v >> (e - 3)) & 7);
+    }
+};
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
+
+#endif // LOGHISTOGRAM_H__
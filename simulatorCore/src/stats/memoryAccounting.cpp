@@ -0,0 +1,107 @@
+/*! @file memoryAccounting.cpp
+ * @brief Accounting of the memory used by the simulator objects
+ * Implemented following the singleton design pattern.
+ */
+
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+#include "memoryAccounting.h"
+#include "../events/events.h"
+#include "../comm/network.h"
+#include "../utils/trace.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+namespace utils {
+
+static const char *categoryNames[MemoryAccounting::NB_CATEGORIES] = {
+    "events", "messages", "blocks", "GL blocks", "interfaces", "outgoing queues"
+};
+
+static void requestDump(int) {
+    MemoryAccounting::dumpRequested = 1;
+}
+
+void MemoryAccounting::installSignalHandler() {
+    signal(SIGUSR1, requestDump);
+}
+
+void MemoryAccounting::dumpIfRequested() {
+    if (dumpRequested) {
+        dumpRequested = 0;
+        cout << getInstance();
+    }
+}
+
+void MemoryAccounting::add(Category c, int64_t n, int64_t bytes, int type) {
+    lock_guard<std::mutex> lock(mutex);
+    totals[c].add(n, bytes);
+    types[c][type].add(n, bytes);
+}
+
+void MemoryAccounting::trackEvent(Event *ev) {
+    if (ev->memoryTracked) return;
+    ev->memoryTracked = true;
+
+    lock_guard<std::mutex> lock(mutex);
+    totals[EVENTS].add(1, ev->memorySize);
+    MemoryUsage &usage = types[EVENTS][ev->eventType];
+    if (usage.name.empty()) usage.name = ev->getEventName();
+    usage.add(1, ev->memorySize);
+}
+
+void MemoryAccounting::trackMessage(Message *msg) {
+    if (msg->memoryTracked) return;
+    msg->memoryTracked = true;
+
+    lock_guard<std::mutex> lock(mutex);
+    totals[MESSAGES].add(1, msg->memorySize);
+    MemoryUsage &usage = types[MESSAGES][msg->type];
+    if (usage.name.empty()) usage.name = msg->getMessageName() + " #" + to_string(msg->type);
+    usage.add(1, msg->memorySize);
+}
+
+//!< Prints a usage as a table row, memory in kB
+static void printUsage(ostream &out, const string &name, const MemoryUsage &u) {
+    out << left << setw(46) << name << right
+        << setw(12) << u.count << setw(12) << u.bytes / 1024.0
+        << setw(12) << u.peakCount << setw(12) << u.peakBytes / 1024.0 << endl;
+}
+
+//!< Prints the usage of the types of a category, by decreasing peak memory
+static void printTypes(ostream &out, const string &title,
+                       const unordered_map<int, MemoryUsage> &usages) {
+    vector<const MemoryUsage*> sorted;
+    for (const auto &it : usages) sorted.push_back(&it.second);
+    sort(sorted.begin(), sorted.end(), [](const MemoryUsage *a, const MemoryUsage *b) {
+        return a->peakBytes != b->peakBytes ? a->peakBytes > b->peakBytes : a->name < b->name;
+    });
+
+    out << TermColor::BWhite << title << " (sorted by peak kB)" << endl << TermColor::BMagenta;
+    for (const MemoryUsage *u : sorted) printUsage(out, u->name, *u);
+}
+
+ostream& operator<<(ostream& out, const MemoryAccounting &ma) {
+    lock_guard<std::mutex> lock(const_cast<MemoryAccounting&>(ma).mutex);
+
+    out << TermColor::BBlue << fixed << setprecision(1);
+    out << endl << "=== MEMORY USAGE ===" << endl;
+    out << TermColor::BWhite << left << setw(46) << "category" << right << setw(12) << "count"
+        << setw(12) << "kB" << setw(12) << "peak count" << setw(12) << "peak kB" << endl;
+    out << TermColor::BMagenta;
+    for (int c = 0; c < MemoryAccounting::NB_CATEGORIES; c++)
+        printUsage(out, categoryNames[c], ma.totals[c]);
+
+    if (not ma.types[MemoryAccounting::EVENTS].empty())
+        printTypes(out, "Events by type", ma.types[MemoryAccounting::EVENTS]);
+    if (not ma.types[MemoryAccounting::MESSAGES].empty())
+        printTypes(out, "Messages by type", ma.types[MemoryAccounting::MESSAGES]);
+    out << TermColor::Reset;
+    return out;
+}
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
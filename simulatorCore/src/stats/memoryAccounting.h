@@ -0,0 +1,119 @@
+/*! @file memoryAccounting.h
+ * @brief Accounting of the memory used by the simulator objects, enabled from the command
+ *  line (--memory). Counts and bytes of events and messages (per type), blocks, GL blocks,
+ *  interfaces and outgoing queues are tracked with their peaks, and reported at the end of the
+ *  run, on SIGUSR1 or with the [M] key of the GUI. Objects still alive at the end of the run
+ *  are the leak surface.
+ * When disabled, the cost is a test of the enable flag per allocation.
+ * Implemented following the singleton design pattern.
+ */
+
+#ifndef MEMORYACCOUNTING_H__
+#define MEMORYACCOUNTING_H__
+
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class Event;
+class Message;
+
+/**
+ * Declares the allocation functions of an accounted class, recording the size of the allocated
+ *  object (including derived classes) for MemoryAccounting::takeAllocationSize
+ */
+#define MEMORY_ACCOUNTED_CLASS()                                        \
+    static void *operator new(size_t size) {                            \
+        return BaseSimulator::utils::MemoryAccounting::allocate(size); \
+    }                                                                   \
+    static void operator delete(void *p) { ::operator delete(p); }
+
+namespace BaseSimulator {
+namespace utils {
+
+//!< Live and peak usage of one class or type of objects
+class MemoryUsage {
+public:
+    std::string name; //!< printable name of the type
+    int64_t count = 0; //!< number of living objects
+    int64_t bytes = 0; //!< memory used by the living objects
+    int64_t peakCount = 0; //!< largest number of living objects
+    int64_t peakBytes = 0; //!< largest memory used
+
+    //!< Adds n objects using b bytes, or removes them if n and b are negative
+    void add(int64_t n, int64_t b) {
+        count += n;
+        bytes += b;
+        if (count > peakCount) peakCount = count;
+        if (bytes > peakBytes) peakBytes = bytes;
+    }
+};
+
+//!< Singleton-based memory accounting
+//!< @attention Any access to MemoryAccounting must be done through the getInstance() function
+class MemoryAccounting {
+public:
+    enum Category { EVENTS, MESSAGES, BLOCKS, GLBLOCKS, INTERFACES, OUTGOING_QUEUES,
+                    NB_CATEGORIES };
+
+    static inline bool enable = false; //!< Activation flag: true if memory accounting is enabled
+    static inline volatile sig_atomic_t dumpRequested = 0; //!< set on SIGUSR1, see dumpIfRequested
+
+    //<! @brief Used to get the singleton instance of MemoryAccounting.
+    //<! @return singleton instance of MemoryAccounting
+    static MemoryAccounting& getInstance() {
+        static MemoryAccounting instance;
+        return instance;
+    };
+
+    //!< Allocates size bytes for an accounted class, see MEMORY_ACCOUNTED_CLASS
+    static void *allocate(size_t size) {
+        if (enable) allocationSize = size;
+        return ::operator new(size);
+    }
+
+    //!< @return size of the object being constructed, 0 if it has not been allocated by allocate
+    static size_t takeAllocationSize() {
+        size_t size = allocationSize;
+        allocationSize = 0;
+        return size;
+    }
+
+    //!< Installs the SIGUSR1 handler requesting a report, called when accounting is enabled
+    static void installSignalHandler();
+
+    //!< Prints the report if requested by SIGUSR1, called by the scheduler between events
+    static void dumpIfRequested();
+
+    /**
+     * @brief Accounts for n objects of category c using bytes bytes, removed if n is negative
+     * @param type type of the objects in the category, see trackEvent and trackMessage
+     */
+    void add(Category c, int64_t n, int64_t bytes, int type = 0);
+
+    //!< Accounts for a scheduled event, by event type, until its destruction
+    void trackEvent(Event *ev);
+    //!< Accounts for a message entering the network, by message type, until its destruction
+    void trackMessage(Message *msg);
+
+    //!< Prints the live and peak usage of every category, and of every event and message type
+    friend std::ostream& operator<<(std::ostream& out, const MemoryAccounting &ma);
+private:
+    MemoryAccounting() {};
+    MemoryAccounting(MemoryAccounting const&); //<! Disable copy constructor
+    void operator=(MemoryAccounting const&); //<! Disable assignment operator
+
+    static inline thread_local size_t allocationSize = 0; //!< size of the last accounted allocation
+
+    std::mutex mutex; //!< blocks may be constructed by several threads
+    MemoryUsage totals[NB_CATEGORIES]; //!< usage per category
+    std::unordered_map<int, MemoryUsage> types[NB_CATEGORIES]; //!< usage per type, in each category
+};                              // class MemoryAccounting
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
+
+#endif // MEMORYACCOUNTING_H__
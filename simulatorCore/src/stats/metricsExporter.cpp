@@ -0,0 +1,163 @@
+/*! @file metricsExporter.cpp
+ * @brief Live metrics of a running simulation in Prometheus text format
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "metricsExporter.h"
+#include "statsCollector.h"
+#include "../events/events.h"
+#include "../comm/network.h"
+#include "../utils/trace.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+namespace utils {
+
+//!< Writes one metric with its help and type lines
+template<typename T>
+static void writeMetric(ostream &out, const char *name, const char *type, const char *help, T value) {
+    out << "# HELP visiblesim_" << name << " " << help << "\n"
+        << "# TYPE visiblesim_" << name << " " << type << "\n"
+        << "visiblesim_" << name << " " << value << "\n";
+}
+
+string MetricsExporter::getMetrics() {
+    const StatsCollector &sc = StatsCollector::getInstance();
+    const uint64_t events = sc.getEventsProcessed();
+    const auto now = chrono::steady_clock::now();
+    const double elapsed = chrono::duration<double>(now - lastTime).count();
+    const double eventsPerSec = elapsed > 0 ? (events - lastEvents) / elapsed : 0;
+    lastTime = now;
+    lastEvents = events;
+
+    ostringstream out;
+    writeMetric(out, "scheduler_date_us", "gauge", "Simulated date of the last consumed event",
+                sc.getCurrentDate());
+    writeMetric(out, "events_processed_total", "counter", "Number of events processed", events);
+    writeMetric(out, "events_per_second", "gauge", "Events processed per second since the previous sample",
+                eventsPerSec);
+    writeMetric(out, "events_queue_size", "gauge", "Number of events in the scheduler queue",
+                sc.getEventsQueueSize());
+    writeMetric(out, "living_events", "gauge", "Number of events in memory", Event::getNbLivingEvents());
+    writeMetric(out, "living_messages", "gauge", "Number of messages in memory", Message::getNbMessages());
+    writeMetric(out, "messages_processed_total", "counter", "Number of messages sent",
+                sc.getMessagesProcessed());
+    writeMetric(out, "motions_processed_total", "counter", "Number of motions processed",
+                sc.getMotionsProcessed());
+    writeMetric(out, "resident_memory_bytes", "gauge", "Resident set size of the process",
+                StatsCollector::getCurrentRSS() * 1024);
+    return out.str();
+}
+
+void MetricsExporter::writeFile() {
+    const string tmpPath = path + ".tmp";
+    {
+        ofstream fout(tmpPath, ios::trunc);
+        fout << getMetrics();
+        if (not fout.good()) return;
+    }
+    rename(tmpPath.c_str(), path.c_str());
+}
+
+void MetricsExporter::fileLoop() {
+    unique_lock<std::mutex> lock(mutex);
+    while (not stopping) {
+        lock.unlock();
+        writeFile();
+        lock.lock();
+        cv.wait_for(lock, chrono::milliseconds(period), []() { return stopping; });
+    }
+}
+
+void MetricsExporter::socketLoop() {
+    struct pollfd pfd = { listenFd, POLLIN, 0 };
+    while (true) {
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+        }
+        if (poll(&pfd, 1, 100) <= 0) continue;
+
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+        const string metrics = getMetrics();
+        size_t written = 0;
+        while (written < metrics.size()) {
+            ssize_t n = ::write(fd, metrics.data() + written, metrics.size() - written);
+            if (n <= 0) break;
+            written += n;
+        }
+        close(fd);
+    }
+}
+
+void MetricsExporter::start() {
+    if (path.empty() or thread) return;
+
+    lastTime = chrono::steady_clock::now();
+    lastEvents = StatsCollector::getInstance().getEventsProcessed();
+    stopping = false;
+
+    if (isSocket()) {
+        const string sp = socketPath();
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (sp.size() >= sizeof(addr.sun_path)) {
+            cerr << "error: metrics socket path too long: " << sp << endl;
+            return;
+        }
+        strcpy(addr.sun_path, sp.c_str());
+        unlink(sp.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0 or bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0
+            or listen(listenFd, 4) != 0) {
+            cerr << "error: cannot listen on metrics socket " << sp << ": " << strerror(errno) << endl;
+            if (listenFd >= 0) close(listenFd);
+            listenFd = -1;
+            return;
+        }
+        cout << TermColor::BWhite << "(metrics) serving metrics on Unix socket: "
+             << TermColor::Reset << sp << endl;
+        thread = new std::thread(socketLoop);
+    } else {
+        cout << TermColor::BWhite << "(metrics) writing metrics every " << period << " ms to file: "
+             << TermColor::Reset << path << endl;
+        thread = new std::thread(fileLoop);
+    }
+}
+
+void MetricsExporter::stop() {
+    if (not thread) return;
+
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        cv.notify_one();
+    }
+    thread->join();
+    delete thread;
+    thread = nullptr;
+
+    if (isSocket()) {
+        close(listenFd);
+        listenFd = -1;
+        unlink(socketPath().c_str());
+    } else {
+        writeFile(); // final values
+    }
+}
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
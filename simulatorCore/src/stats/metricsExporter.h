@@ -0,0 +1,63 @@
+/*! @file metricsExporter.h
+ * @brief Live metrics of a running simulation in Prometheus text format, enabled from the
+ *  command line (--metrics). A background thread reads the counters of StatsCollector and the
+ *  living object counts without stopping the scheduler thread, and either rewrites a file every
+ *  period (renamed into place, as read by the node exporter textfile collector) or answers each
+ *  connection to a Unix socket with the current metrics, e.g. with `nc -U <socket>`.
+ */
+
+#ifndef METRICSEXPORTER_H__
+#define METRICSEXPORTER_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace BaseSimulator {
+namespace utils {
+
+class MetricsExporter {
+public:
+    static inline std::string path; //!< output file, or Unix socket if prefixed with "unix:", disabled if empty
+    static inline unsigned int period = 1000; //!< file update period, in ms
+
+    //!< Starts the exporter thread if enabled, called at scheduler start
+    static void start();
+
+    //!< Writes the final metrics and stops the exporter thread, called at scheduler end
+    static void stop();
+
+    //!< @return the current metrics in Prometheus text format, events/s measured since the previous call
+    static std::string getMetrics();
+private:
+    static inline std::thread *thread = nullptr; //!< exporter thread
+    static inline std::mutex mutex; //!< protects stopping
+    static inline std::condition_variable cv; //!< wakes up the file exporter when stopping
+    static inline bool stopping = false; //!< asks the exporter thread to terminate
+    static inline int listenFd = -1; //!< listening Unix socket, -1 in file mode
+
+    //!< Previous sample, for the events/s rate
+    static inline std::chrono::steady_clock::time_point lastTime;
+    static inline uint64_t lastEvents = 0;
+
+    //!< @return true if the metrics are served on a Unix socket
+    static bool isSocket() { return path.rfind("unix:", 0) == 0; }
+    //!< @return path of the Unix socket
+    static std::string socketPath() { return path.substr(5); }
+
+    //!< Writes the metrics to a temporary file renamed to path
+    static void writeFile();
+
+    //!< File mode thread loop
+    static void fileLoop();
+    //!< Unix socket mode thread loop
+    static void socketLoop();
+};
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
+
+#endif // METRICSEXPORTER_H__
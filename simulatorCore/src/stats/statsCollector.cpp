@@ -6,6 +6,10 @@
  */
 
 #include <iomanip>
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
 #include "statsCollector.h"
 #include "../base/world.h"
 
@@ -39,9 +43,49 @@ ostream& operator<<(ostream& out,const StatsCollector &sc) {
         << TermColor::BMagenta << sc.nbLivingMessages << endl;
     out << TermColor::BWhite << "Number of events processed per second: "
         << TermColor::BMagenta << sc.computeEventPerSec() << endl;
+    out << TermColor::BWhite << "Peak memory usage: "
+        << TermColor::BMagenta << StatsCollector::getPeakRSS() << " kB" << endl;
     out << TermColor::Reset;
     return out;
 }
 
+uint64_t StatsCollector::getPeakRSS() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+uint64_t StatsCollector::getCurrentRSS() {
+    ifstream statm("/proc/self/statm");
+    uint64_t size, resident;
+    if (statm >> size >> resident) return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    return getPeakRSS();
+}
+
+void StatsCollector::writeJSON(ostream &out) const {
+    out << "{ \"modules\": " << getWorld()->getSize()
+        << ", \"simulatedTimeUs\": " << simulatedElapsedTime
+        << ", \"realTimeUs\": " << std::setprecision(2) << std::fixed << realElapsedTime
+        << ", \"events\": " << eventsProcessed
+        << ", \"messages\": " << messagesProcessed
+        << ", \"motions\": " << motionsProcessed
+        << ", \"largestEventsQueue\": " << largestEventsQueueSize
+        << ", \"eventsPerSec\": " << computeEventPerSec()
+        << ", \"peakRSSkB\": " << getPeakRSS() << " }";
+}
+
+bool StatsCollector::writeJSON(const string &fileName) const {
+    ofstream fout(fileName);
+    if (not fout) return false;
+
+    writeJSON(fout);
+    fout << endl;
+    return fout.good();
+}
+
 } // namespace BaseSimulator::utils
 } // namespace BaseSimulator
@@ -8,8 +8,10 @@
 #ifndef STATSCOLLECTOR_H__
 #define STATSCOLLECTOR_H__
 
+#include <atomic>
 #include <iostream>
 #include <cstdint>
+#include <string>
 
 #include "../utils/tDefs.h"
 
@@ -23,6 +25,8 @@ class StatsCollector {
  *                   Module Description
  ************************************************************/
 public:
+    static inline std::string jsonFileName; //!< if not empty, statistics are also written as JSON to this file
+
     //<! @brief Used to get the singleton instance of StatsCollector.
     //!< Allocate it on first call, return existing instance on all subsequent calls
     //<! @return singleton instance of StatsCollector
@@ -39,18 +43,28 @@ class StatsCollector {
  *             Collected Statistics Description
  ************************************************************/
 private:
+    //!< Counter written by the scheduler thread only and read by any thread (see MetricsExporter),
+    //!<  incremented without the cost of an atomic read-modify-write
+    class Counter : public std::atomic<uint64_t> {
+    public:
+        Counter() : std::atomic<uint64_t>(0) {};
+        inline void inc() { store(load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); };
+    };
+
     // Messages
-    uint64_t messagesProcessed = 0; //!< Total number of messages processed by VisibleSim
+    Counter messagesProcessed; //!< Total number of messages processed by VisibleSim
     uint64_t nbLivingMessages = 0; //!< Total number of messages still in memory at scheduler end
     // uint64_t maxiMessageQueueDepth = 0; //!< Total number of messages processed by VisibleSim
     // Motions
-    uint64_t motionsProcessed = 0; //!< Total number of motion events processed by VisibleSim
+    Counter motionsProcessed; //!< Total number of motion events processed by VisibleSim
     // Events
-    uint64_t eventsProcessed = 0; //!< Total number of events processed by VisibleSim
+    Counter eventsProcessed; //!< Total number of events processed by VisibleSim
+    std::atomic<uint64_t> eventsQueueSize = 0; //!< Current size of the scheduler's event list
     uint64_t nbLivingEvents = 0; //!< Total number of events still in memory at scheduler end
     uint64_t largestEventsQueueSize = 0; //!< Largest size of the scheduler's event
     uint64_t endEventsQueueSize = 0; //!< Size of the events queue at scheduler end
     // Time
+    std::atomic<Time> currentDate = 0; //!< Date of the last event consumed by the scheduler
     Time simulatedElapsedTime = 0; //!< Duration of simulation in discrete simulator time
     double realElapsedTime = 0; //!< Duration of simulation in real time (us)
 
@@ -58,11 +72,16 @@ class StatsCollector {
     inline double computeEventPerSec() const {  return realElapsedTime ? eventsProcessed / (realElapsedTime / 1000000) : 0; };
 public:
     //!< Increments processed message count by 1
-    inline void incMsgCount() { messagesProcessed++; };
+    inline void incMsgCount() { messagesProcessed.inc(); };
     //!< Increments processed motion count by 1
-    inline void incMotionCount() { motionsProcessed++; };
+    inline void incMotionCount() { motionsProcessed.inc(); };
     //!< Increments processed event count by 1
-    inline void incEventsCount() { eventsProcessed++; };
+    inline void incEventsCount() { eventsProcessed.inc(); };
+    //!< Records the state of the scheduler after an event, for live monitoring
+    inline void updateSchedulerState(Time date, uint64_t queueSize) {
+        currentDate.store(date, std::memory_order_relaxed);
+        eventsQueueSize.store(queueSize, std::memory_order_relaxed);
+    };
     //!< Updates both elapsed times
     inline void updateElapsedTime(Time simTime, Time realTime)
         { simulatedElapsedTime = simTime; realElapsedTime = realTime; };
@@ -75,6 +94,33 @@ class StatsCollector {
     inline void setEndEventsQueueSize(uint64_t endSize)
         {  endEventsQueueSize = endSize; };
 
+    inline uint64_t getMessagesProcessed() const { return messagesProcessed; };
+    inline uint64_t getMotionsProcessed() const { return motionsProcessed; };
+    inline uint64_t getEventsProcessed() const { return eventsProcessed; };
+    inline Time getCurrentDate() const { return currentDate; };
+    inline uint64_t getEventsQueueSize() const { return eventsQueueSize; };
+    inline Time getSimulatedElapsedTime() const { return simulatedElapsedTime; };
+    inline double getRealElapsedTime() const { return realElapsedTime; };
+    inline double getEventsPerSec() const { return computeEventPerSec(); };
+
+    //!< @return peak resident set size of the process, in kB
+    static uint64_t getPeakRSS();
+    //!< @return current resident set size of the process, in kB (peak size if unavailable)
+    static uint64_t getCurrentRSS();
+
+    /**
+     * Writes collected statistics as a flat JSON object, without trailing newline
+     * @param out output stream
+     */
+    void writeJSON(std::ostream &out) const;
+
+    /**
+     * Writes collected statistics as JSON to a file
+     * @param fileName output file name
+     * @return true if the file has been written successfully
+     */
+    bool writeJSON(const std::string &fileName) const;
+
     //!< Prints collected statistics to an ouput stream
     friend std::ostream& operator<<(std::ostream& out,const StatsCollector &sc);
 };                              // class StatsCollector
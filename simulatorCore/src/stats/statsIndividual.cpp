@@ -29,6 +29,12 @@ StatsIndividual::StatsIndividual(StatsIndividual const&si) {
  maxIncommingMessageQueueSize = si.maxIncommingMessageQueueSize;
 
  motions = si.motions;
+
+ sampledSentMessages = si.sampledSentMessages;
+ sampledReceivedMessages = si.sampledReceivedMessages;
+ sampledMaxOutgoingMessageQueueSize = si.sampledMaxOutgoingMessageQueueSize;
+ sampledMaxIncommingMessageQueueSize = si.sampledMaxIncommingMessageQueueSize;
+ sampledMaxMessageQueueSize = si.sampledMaxMessageQueueSize;
 }
 
 void StatsIndividual::incSentMessageCount(StatsIndividual *s) {
@@ -77,6 +83,10 @@ void StatsIndividual::updateQueueSizeStats() {
   maxOutgoingMessageQueueSize = max(maxOutgoingMessageQueueSize,outgoingMessageQueueSize);
   maxIncommingMessageQueueSize = max(maxIncommingMessageQueueSize,incommingMessageQueueSize);
   maxMessageQueueSize = max(maxMessageQueueSize,messageQueueSize);
+
+  sampledMaxOutgoingMessageQueueSize = max(sampledMaxOutgoingMessageQueueSize,outgoingMessageQueueSize);
+  sampledMaxIncommingMessageQueueSize = max(sampledMaxIncommingMessageQueueSize,incommingMessageQueueSize);
+  sampledMaxMessageQueueSize = max(sampledMaxMessageQueueSize,messageQueueSize);
 }
 
 void StatsIndividual::incMotionCount(StatsIndividual *s) {
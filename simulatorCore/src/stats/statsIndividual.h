@@ -33,6 +33,15 @@ class StatsIndividual {
 
     // Motions
     uint64_t motions = 0; //!< Total number of perfomed motions
+
+    // Periodic sampling
+    uint64_t sampledSentMessages = 0; //!< Number of sent messages at last StatsSampler snapshot
+    uint64_t sampledReceivedMessages = 0; //!< Number of received messages at last StatsSampler snapshot
+    uint64_t sampledMaxOutgoingMessageQueueSize = 0; //!< Maximum outgoing message queue size since last StatsSampler snapshot
+    uint64_t sampledMaxIncommingMessageQueueSize = 0; //!< Maximum incomming message queue size since last StatsSampler snapshot
+    uint64_t sampledMaxMessageQueueSize = 0; //!< Maximum message queue size since last StatsSampler snapshot
+
+    friend class StatsSampler;
 public:
     static bool enable; //!< Activation flag: true if per module statistics are enable, false otherwise
 
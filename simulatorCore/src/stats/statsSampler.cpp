@@ -0,0 +1,89 @@
+/*! @file statsSampler.cpp
+ * @brief Periodic snapshots of the per-module statistics, driven by simulated time.
+ */
+
+#include <iomanip>
+#include <utility>
+
+#include "statsSampler.h"
+#include "statsIndividual.h"
+#include "../base/buildingBlock.h"
+#include "../base/world.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+namespace utils {
+
+static const char *metricNames[] = { "messageQueue", "outgoingQueue", "incomingQueue",
+                                     "sentMessages", "receivedMessages" };
+
+void StatsSampler::sampleIfNeeded(Time date) {
+    if (date < nextSampleDate) return;
+
+    // Snapshots are labeled with the last period boundary reached
+    sample(date / period * period);
+    nextSampleDate = (date / period + 1) * period;
+}
+
+void StatsSampler::endSampling(Time date) {
+    if (not file) return;
+
+    sample(date);
+    file->close();
+    delete file;
+    file = nullptr;
+}
+
+void StatsSampler::sample(Time date) {
+    if (not file) {
+        cout << TermColor::BWhite << "(stats) sampling module statistics every " << period
+             << " us to file: " << TermColor::Reset << fileName << endl;
+        file = new ofstream(fileName, ios::out | ios::trunc);
+        *file << "date,metric,modules,min,mean,p50,p90,p99,max,hotspots" << endl;
+    }
+
+    LogHistogram histograms[NB_METRICS];
+    // Modules with the largest values, by decreasing value
+    pair<uint64_t, bID> hotspots[NB_METRICS][NB_HOTSPOTS] = {};
+
+    for (const auto &it : getWorld()->getMap()) {
+        StatsIndividual *st = it.second->stats;
+        if (not st) continue;
+
+        const uint64_t values[NB_METRICS] = {
+            st->sampledMaxMessageQueueSize, st->sampledMaxOutgoingMessageQueueSize,
+            st->sampledMaxIncommingMessageQueueSize,
+            st->sentMessages - st->sampledSentMessages,
+            st->receivedMessages - st->sampledReceivedMessages };
+        st->sampledSentMessages = st->sentMessages;
+        st->sampledReceivedMessages = st->receivedMessages;
+        // Maxima of the next period start from the current queue sizes
+        st->sampledMaxMessageQueueSize = st->messageQueueSize;
+        st->sampledMaxOutgoingMessageQueueSize = st->outgoingMessageQueueSize;
+        st->sampledMaxIncommingMessageQueueSize = st->incommingMessageQueueSize;
+
+        for (int m = 0; m < NB_METRICS; m++) {
+            histograms[m].add(values[m]);
+            pair<uint64_t, bID> candidate(values[m], it.first);
+            for (int k = 0; k < NB_HOTSPOTS and candidate.first > 0; k++) {
+                if (candidate.first > hotspots[m][k].first) swap(candidate, hotspots[m][k]);
+            }
+        }
+    }
+
+    *file << fixed << setprecision(2);
+    for (int m = 0; m < NB_METRICS; m++) {
+        const LogHistogram &h = histograms[m];
+        *file << date << "," << metricNames[m] << "," << h.count << ","
+              << (h.count ? h.min : 0) << "," << h.mean() << ","
+              << h.percentile(50) << "," << h.percentile(90) << "," << h.percentile(99) << ","
+              << h.max << ",";
+        for (int k = 0; k < NB_HOTSPOTS and hotspots[m][k].first > 0; k++)
+            *file << (k ? " " : "") << hotspots[m][k].second << ":" << hotspots[m][k].first;
+        *file << "\n";
+    }
+}
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
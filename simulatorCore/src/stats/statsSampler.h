@@ -0,0 +1,55 @@
+/*! @file statsSampler.h
+ * @brief Periodic snapshots of the per-module statistics (StatsIndividual), driven by
+ *  simulated time. At each period boundary, the counters of all modules are aggregated
+ *  into LogHistograms and written as one CSV line per metric, with the modules having the
+ *  largest values (hot spots). Memory does not depend on the number of events.
+ */
+
+#ifndef STATSSAMPLER_H__
+#define STATSSAMPLER_H__
+
+#include <fstream>
+#include <string>
+
+#include "../utils/tDefs.h"
+#include "logHistogram.h"
+
+namespace BaseSimulator {
+namespace utils {
+
+//!< Periodic per-module statistics sampler, enabled from the command line (--stats-period)
+class StatsSampler {
+public:
+    inline static Time period = 0; //!< sampling period in simulated us, sampling disabled if 0
+    inline static std::string fileName = "stats_samples.csv"; //!< output time series file
+
+    /**
+     * @brief Writes a snapshot if date has reached the next period boundary. Called before
+     *  each event is consumed, so that snapshots show the state at the boundary.
+     * @param date date of the next event
+     */
+    static void sampleIfNeeded(Time date);
+
+    /**
+     * @brief Writes a last snapshot and closes the output file, called at scheduler end
+     * @param date end date of the simulation
+     */
+    static void endSampling(Time date);
+private:
+    //!< Sampled metrics, all over the period since the previous snapshot: maximum queue sizes,
+    //!<  sent and received messages
+    enum Metric { MESSAGE_QUEUE, OUTGOING_QUEUE, INCOMING_QUEUE,
+                  SENT_MESSAGES, RECEIVED_MESSAGES, NB_METRICS };
+    static const int NB_HOTSPOTS = 3; //!< number of modules with the largest values to report
+
+    inline static Time nextSampleDate = 0; //!< date of the next snapshot
+    inline static std::ofstream *file = nullptr; //!< output file, opened on first snapshot
+
+    //!< Aggregates the counters of all modules and writes them, labeled with date
+    static void sample(Time date);
+};
+
+} // namespace BaseSimulator::utils
+} // namespace BaseSimulator
+
+#endif // STATSSAMPLER_H__
@@ -1,18 +1,29 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cctype>
+#include <stdexcept>
 #include "commandLine.h"
+#include "../stats/statsCollector.h"
 #include "../stats/statsIndividual.h"
+#include "../stats/eventProfiler.h"
+#include "../stats/statsSampler.h"
+#include "../stats/memoryAccounting.h"
+#include "../stats/metricsExporter.h"
 #include "../gui/openglViewer.h"
 #include "../base/simulator.h"
 #include "trace.h"
+#include "configExporter.h"
+#include "../replay/traceExporter.h"
+#include "logSink.h"
+#include "worldGenerator.h"
 
 void CommandLine::help() const {
     cerr << TermColor::BWhite << "VisibleSim options:" << TermColor::Reset << endl;
     cerr << "\t " << TermColor::BMagenta << "-f " << TermColor::Reset
          << "\t\t\tFull screen mode" << endl;
     cerr << "\t " << TermColor::BMagenta << "-p <program>" << TermColor::Reset
-         << "\t\tPath to a Meld program file (Meld only)" << endl;
+         << "\t\tPath to a Meld program file, .bb or its bytecode packaged as a .so (Meld only)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-D " << TermColor::Reset
          << "\t\t\tDebugger mode (Meld only)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-c <config>" << TermColor::Reset
@@ -37,11 +48,46 @@ void CommandLine::help() const {
          << "\t\t\tEnable regression testing (export terminal configuration)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-l " << TermColor::Reset
          << "\t\t\tEnable printing of log information to file simulation.log" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--log-level <level>" << TermColor::Reset
+         << "\tOnly print console messages up to <level>: none, error, warning, info or debug (default)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--log-sink [<file>]" << TermColor::Reset
+         << "\tWrite console messages asynchronously in binary format to <file> (default: simulation.vslog)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--generate <topology> <size>" << TermColor::Reset
+         << "\tGenerate the modules instead of reading them from the configuration, which becomes optional."
+         << " Topologies: " << BaseSimulator::WorldGenerator::getTopologyNames()
+         << ". Random topologies are seeded by -a" << endl;
     cerr << "\t " << TermColor::BMagenta << "-i " << TermColor::Reset
          << "\t\t\tEnable printing more detailed simulation stats" << endl;
     cerr << "\t " << TermColor::BMagenta << "-a <seed>" << TermColor::Reset
          << "\t\tSet simulation seed" << endl;
     cerr << "\t " << TermColor::BMagenta << "-e " << TermColor::Reset << "\t\t\tExport configuration when simulation finishes" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--convert-config <file>" << TermColor::Reset
+         << "\tConvert the configuration to <file> and exit (binary snapshot if <file> ends with "
+         << CONFIG_SNAPSHOT_EXT << ", XML otherwise)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--export-period <us>" << TermColor::Reset
+         << "\tExport the configuration every <us> of simulated time, on a background thread" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--stats-period <us> [<file>]" << TermColor::Reset
+         << "\tWrite per-module statistics snapshots every <us> of simulated time to <file> (default: stats_samples.csv)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--stats-json <file>" << TermColor::Reset
+         << "\tWrite global statistics (events/s, peak memory usage...) as JSON to <file> at scheduler end" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--build-threads <n>" << TermColor::Reset
+         << "\tConstruct the modules of the configuration on <n> threads (0: all cores, default: 1)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--meld-threads <n>" << TermColor::Reset
+         << "\tEvaluate the rules of the Meld VMs on <n> threads (0: all cores, default: 1, Meld only)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--convert-program <file>" << TermColor::Reset
+         << "\tConvert the Meld program to a precompiled image <file> (.mpi) or to native code <file> (.cpp) and exit (Meld only)" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--profile [<file>]" << TermColor::Reset
+         << "\tProfile event consume and message handler times per type, and write them as JSON to <file>" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--profile-sort <key>" << TermColor::Reset
+         << "\tSort the profile by <key>: name, count, total (default), mean, p50, p95, p99 or max" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--memory" << TermColor::Reset
+         << "\t\tAccount the memory used by events, messages, blocks and interfaces, reported at scheduler end,"
+         << " on SIGUSR1 or with the [M] key" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--metrics <file> [<ms>]" << TermColor::Reset
+         << "\tWrite live metrics in Prometheus text format to <file> every <ms> (default: 1000),"
+         << " or serve them on a Unix socket if <file> is unix:<path>" << endl;
+    cerr << "\t " << TermColor::BMagenta << "--trace [<file>]" << TermColor::Reset
+         << "\tExport a Chrome Trace / Perfetto timeline of the simulation to <file> (default: trace.json)" << endl;
     cerr << "\t " << TermColor::BMagenta << "-h " << TermColor::Reset << "\t\t\tHelp" << endl;
 }
 
@@ -83,6 +129,170 @@ void CommandLine::read(int argc, char *argv[], BlockCodeBuilder bcb) {
                         replayEnabled = true;
                         ReplayExporter::enableDebugging();
                         cout << "--debug-replay option enabled" << endl;
+                    } else if (varg == string("convert-config")) {
+                        if (argc < 2 or argv[1][0] == '-') {
+                            throw CLIParsingError("No output file provided after --convert-config");
+                        }
+
+                        convertConfigFile = string(argv[1]);
+                        argc--;
+                        argv++;
+                    } else if (varg == string("export-period")) {
+                        unsigned long long period = 0;
+                        try {
+                            if (argc >= 2 and isdigit(argv[1][0])) period = stoull(argv[1]);
+                        } catch(std::logic_error&) {
+                            throw CLIParsingError(string("Period out of range after --export-period: ") + argv[1]);
+                        }
+                        if (period == 0) {
+                            throw CLIParsingError("No valid period provided after --export-period");
+                        }
+
+                        ConfigExporter::exportPeriod = period;
+                        argc--;
+                        argv++;
+                    } else if (varg == string("stats-period")) {
+                        unsigned long long period = 0;
+                        try {
+                            if (argc >= 2 and isdigit(argv[1][0])) period = stoull(argv[1]);
+                        } catch(std::logic_error&) {
+                            throw CLIParsingError(string("Period out of range after --stats-period: ") + argv[1]);
+                        }
+                        if (period == 0) {
+                            throw CLIParsingError("No valid period provided after --stats-period");
+                        }
+
+                        utils::StatsSampler::period = period;
+                        utils::StatsIndividual::enable = true;
+                        argc--;
+                        argv++;
+                        if (argc > 1 and argv[1][0] != '-') { // filename supplied
+                            utils::StatsSampler::fileName = string(argv[1]);
+                            argc--;
+                            argv++;
+                        }
+                    } else if (varg == string("generate")) {
+                        if (argc < 3 or BaseSimulator::WorldGenerator::parseTopology(argv[1]) < 0) {
+                            throw CLIParsingError("No valid topology provided after --generate: "
+                                                  + BaseSimulator::WorldGenerator::getTopologyNames());
+                        }
+                        if (not isdigit(argv[2][0])) {
+                            throw CLIParsingError("No size provided after --generate <topology>");
+                        }
+
+                        topology = BaseSimulator::WorldGenerator::parseTopology(argv[1]);
+                        try {
+                            topologyParameter = stoi(argv[2]);
+                        } catch(std::logic_error&) {
+                            throw CLIParsingError(string("Size out of range after --generate <topology>: ")
+                                                  + argv[2]);
+                        }
+                        if (not BaseSimulator::WorldGenerator(topology, topologyParameter, 0).isSizeValid()) {
+                            throw CLIParsingError("Invalid size provided after --generate <topology>");
+                        }
+                        argc -= 2;
+                        argv += 2;
+                    } else if (varg == string("stats-json")) {
+                        if (argc < 2 or argv[1][0] == '-') {
+                            throw CLIParsingError("No filename provided after --stats-json");
+                        }
+
+                        utils::StatsCollector::jsonFileName = string(argv[1]);
+                        argc--;
+                        argv++;
+                    } else if (varg == string("build-threads")) {
+                        if (argc < 2 or not isdigit(argv[1][0])) {
+                            throw CLIParsingError("No number of threads provided after --build-threads");
+                        }
+
+                        try {
+                            buildThreads = stoi(argv[1]);
+                        } catch(std::logic_error&) {
+                            throw CLIParsingError(string("Number of threads out of range after --build-threads: ")
+                                                  + argv[1]);
+                        }
+                        argc--;
+                        argv++;
+                    } else if (varg == string("meld-threads")) {
+                        if (argc < 2 or not isdigit(argv[1][0])) {
+                            throw CLIParsingError("No number of threads provided after --meld-threads");
+                        }
+
+                        try {
+                            meldThreads = stoi(argv[1]);
+                        } catch(std::logic_error&) {
+                            throw CLIParsingError(string("Number of threads out of range after --meld-threads: ")
+                                                  + argv[1]);
+                        }
+                        argc--;
+                        argv++;
+                    } else if (varg == string("convert-program")) {
+                        if (argc < 2 or argv[1][0] == '-') {
+                            throw CLIParsingError("No output file provided after --convert-program");
+                        }
+
+                        convertProgramFile = string(argv[1]);
+                        argc--;
+                        argv++;
+                    } else if (varg == string("profile")) {
+                        utils::EventProfiler::enable = true;
+                        if (argc > 1 and argv[1][0] != '-') { // JSON filename supplied
+                            utils::EventProfiler::jsonFileName = string(argv[1]);
+                            argc--;
+                            argv++;
+                        }
+                    } else if (varg == string("metrics")) {
+                        if (argc < 2 or argv[1][0] == '-' or string(argv[1]) == "unix:") {
+                            throw CLIParsingError("No file or socket provided after --metrics");
+                        }
+
+                        utils::MetricsExporter::path = string(argv[1]);
+                        argc--;
+                        argv++;
+                        if (argc > 1 and isdigit(argv[1][0])) { // period supplied
+                            utils::MetricsExporter::period = max(1, atoi(argv[1]));
+                            argc--;
+                            argv++;
+                        }
+                    } else if (varg == string("memory")) {
+                        utils::MemoryAccounting::enable = true;
+                        utils::MemoryAccounting::installSignalHandler();
+                    } else if (varg == string("log-level")) {
+                        static const string levels[] = { "none", "error", "warning", "info", "debug" };
+                        int level = 0;
+                        while (argc > 1 and level < 5 and levels[level] != argv[1]) level++;
+                        if (argc < 2 or level == 5) {
+                            throw CLIParsingError("No valid level provided after --log-level");
+                        }
+
+                        ConsoleStream::runtimeLevel = static_cast<LogLevel>(level);
+                        argc--;
+                        argv++;
+                    } else if (varg == string("log-sink")) {
+                        string logFile;
+                        if (argc > 1 and argv[1][0] != '-') { // filename supplied
+                            logFile = string(argv[1]);
+                            argc--;
+                            argv++;
+                        }
+                        LogSink::enable(logFile);
+                    } else if (varg == string("trace")) {
+                        string traceFile;
+                        if (argc > 1 and argv[1][0] != '-') { // filename supplied
+                            traceFile = string(argv[1]);
+                            argc--;
+                            argv++;
+                        }
+                        TraceExporter::enable(traceFile);
+                    } else if (varg == string("profile-sort")) {
+                        if (argc < 2 or not utils::EventProfiler::isSortKey(argv[1])) {
+                            throw CLIParsingError("No valid sort key provided after --profile-sort");
+                        }
+
+                        utils::EventProfiler::enable = true;
+                        utils::EventProfiler::sortKey = string(argv[1]);
+                        argc--;
+                        argv++;
                     }
                     break;
                 }
@@ -34,6 +34,8 @@ class CommandLine {
 
     bool meldDebugger = false;
     string programPath = "program.bb";
+    unsigned int meldThreads = 1; //!< number of threads evaluating the Meld rules, provided with --meld-threads <n>
+    string convertProgramFile; //!< output of the Meld program conversion, provided with --convert-program <name>
     string vmPath = "";
     int vmPort = 0;
 
@@ -46,6 +48,9 @@ class CommandLine {
     bool replayEnabled = false; //<! indicates if simulation capture for replay is enabled
     string replayFilename;           //!< name of the replay file, provided with --replay <name>
 
+    string convertConfigFile; //!< output of the configuration conversion, provided with --convert-config <name>
+    unsigned int buildThreads = 1; //!< number of threads constructing the modules, provided with --build-threads <n>
+
     bool simulationSeedSet = false;
     int simulationSeed = 0;
 
@@ -62,6 +67,9 @@ class CommandLine {
     bool isReplayEnabled() const{ return replayEnabled; }
     string getReplayFilename() const { return replayFilename; }
 
+    string getConvertConfigFile() const { return convertConfigFile; }
+    unsigned int getBuildThreads() const { return buildThreads; }
+
     bool randomWorldRequested() const;
     int getRandomTopology() const { return topology; }
     int getRandomTopologyParameter() const { return topologyParameter; }
@@ -69,6 +77,8 @@ class CommandLine {
     int getSchedulerMode() const { return schedulerMode; }
     bool getMeldDebugger() const { return meldDebugger; }
     string getProgramPath() const { return programPath; }
+    unsigned int getMeldThreads() const { return meldThreads; }
+    string getConvertProgramFile() const { return convertProgramFile; }
     string getVMPath() const { return vmPath; }
     int getVMPort() const { return vmPort; }
     string getConfigFile() const { return configFile; }
@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -61,10 +64,7 @@ string toXmlAttribute(Vector3D &pos) {
  *   Configuration Exporters Implementation
  ************************************************************/
 
-ConfigExporter::ConfigExporter(World *_world) {
-    world = _world;
-    config = new TiXmlDocument();
-
+string ConfigExporter::getExportNameRoot() {
     string exportedConfigNameRoot;
     if (Simulator::configFileName.empty()) {
         exportedConfigNameRoot = "export";
@@ -81,8 +81,18 @@ ConfigExporter::ConfigExporter(World *_world) {
             .substr(0, exportedConfigNameRoot.size()-4);
     }
 
-    configName = Simulator::regrTesting ?
-        ".confCheck.xml" : generateTimestampedFilename(exportedConfigNameRoot, "xml");
+    return exportedConfigNameRoot;
+}
+
+ConfigExporter::ConfigExporter(World *_world) {
+    world = _world;
+    config = new TiXmlDocument();
+
+    if (not Simulator::exportConfigFileName.empty())
+        configName = Simulator::exportConfigFileName;
+    else
+        configName = Simulator::regrTesting ?
+            ".confCheck.xml" : generateTimestampedFilename(getExportNameRoot(), "xml");
     config->LinkEndChild(new TiXmlDeclaration("1.0", "", "no"));
 }
 
@@ -97,13 +107,133 @@ ConfigExporter::~ConfigExporter() {
     delete config;
 }
 
-void ConfigExporter::exportConfiguration() {
+/**
+ * @brief Prints the start tag of an element and its attributes, as TiXmlElement::Print
+ */
+static void printStartTag(FILE *fout, const TiXmlElement *elt, int depth) {
+    for (int i = 0; i < depth; i++) fprintf(fout, "    ");
+    fprintf(fout, "<%s", elt->Value());
+    for (const TiXmlAttribute *attr = elt->FirstAttribute(); attr; attr = attr->Next()) {
+        fprintf(fout, " ");
+        attr->Print(fout, depth);
+    }
+}
+
+template<typename F>
+bool ConfigExporter::writeConfiguration(const string &fileName, const TiXmlDocument &doc, F blocks) {
+    FILE *fout = fopen(fileName.c_str(), "w");
+    if (not fout) return false;
+
+    for (const TiXmlNode *node = doc.FirstChild(); node; node = node->NextSibling()) {
+        const TiXmlElement *worldElt = node->ToElement();
+        const TiXmlElement *blockListElt =
+            (worldElt and worldElt->LastChild()) ? worldElt->LastChild()->ToElement() : nullptr;
+        if (not blockListElt or blockListElt->ValueStr() != "blockList") {
+            node->Print(fout, 0);
+            fprintf(fout, "\n");
+            continue;
+        }
+
+        // World element, printed by hand so that blocks are streamed into the blockList
+        printStartTag(fout, worldElt, 0);
+        fprintf(fout, ">");
+        for (const TiXmlNode *child = worldElt->FirstChild(); child != blockListElt;
+             child = child->NextSibling()) {
+            if (not child->ToText()) fprintf(fout, "\n");
+            child->Print(fout, 1);
+        }
+
+        fprintf(fout, "\n");
+        printStartTag(fout, blockListElt, 1);
+        bool empty = true;
+        blocks([&](const ExportedBlock &eb) {
+            if (empty) fprintf(fout, ">");
+            empty = false;
+
+            TiXmlElement bbElt("block");
+            bbElt.SetAttribute("position", toXmlAttribute(eb.position[0], eb.position[1], eb.position[2]).c_str());
+            bbElt.SetAttribute("color", toXmlAttribute<int>(eb.color[0], eb.color[1], eb.color[2]).c_str());
+            if (eb.master) bbElt.SetAttribute("master", "true");
+            ConfigSnapshot::forEachAttribute(eb.attributes, [&](string_view n, string_view v) {
+                bbElt.SetAttribute(string(n), string(v));
+            });
+
+            fprintf(fout, "\n");
+            bbElt.Print(fout, 2);
+        });
+        if (empty) fprintf(fout, " />");
+        else fprintf(fout, "\n    </%s>", blockListElt->Value());
+        fprintf(fout, "\n</%s>\n", worldElt->Value());
+    }
+
+    const bool written = ferror(fout) == 0;
+    return fclose(fout) == 0 and written;
+}
+
+bool ConfigExporter::exportConfiguration() {
     exportWorld();
     exportCameraAndLightSource();
     exportBlockList();
-    config->SaveFile(configName);
 
-    cerr << "Configuration exported to file: " << configName << endl;
+    const map<bID, BuildingBlock*>& blocks = world->getMap();
+    if (backgroundExport) {
+        // Blocks are captured now, as the simulation goes on while the file is being written
+        vector<ExportedBlock> captured;
+        captured.reserve(blocks.size());
+        for (auto const& idBBPair : blocks) {
+            if (isExported(idBBPair.second))
+                captured.push_back(exportBlock(idBBPair.second));
+        }
+
+        waitForBackgroundExport();
+        backgroundExportDone = std::async(std::launch::async,
+                                          [doc = config, fileName = configName,
+                                           captured = std::move(captured)]() {
+            if (writeConfiguration(fileName, *doc, [&](auto write) {
+                    for (const ExportedBlock &eb : captured) write(eb);
+                }))
+                cerr << "Configuration exported to file: " << fileName << endl;
+            else
+                cerr << "error: could not write configuration " << fileName << endl;
+            delete doc;
+        });
+        config = nullptr; // owned by the background export
+        return true;
+    }
+
+    bool written = writeConfiguration(configName, *config, [&](auto write) {
+        for (auto const& idBBPair : blocks) {
+            if (isExported(idBBPair.second))
+                write(exportBlock(idBBPair.second));
+        }
+    });
+
+    if (written)
+        cerr << "Configuration exported to file: " << configName << endl;
+    else
+        cerr << "error: could not write configuration " << configName << endl;
+
+    return written;
+}
+
+void ConfigExporter::exportConfigurationIfNeeded(Time date) {
+    if (date < max(nextExportDate, exportPeriod)) return;
+
+    // Exports are named after the simulation date at which they are taken
+    const string previousFileName = Simulator::exportConfigFileName;
+    Simulator::exportConfigFileName = getExportNameRoot() + "_t" + to_string(date) + ".xml";
+
+    backgroundExport = true;
+    getWorld()->exportConfiguration();
+    backgroundExport = false;
+    Simulator::exportConfigFileName = previousFileName;
+
+    nextExportDate = (date / exportPeriod + 1) * exportPeriod;
+}
+
+void ConfigExporter::waitForBackgroundExport() {
+    if (backgroundExportDone.valid())
+        backgroundExportDone.get();
 }
 
 void ConfigExporter::exportCameraAndLightSource() {
@@ -157,29 +287,180 @@ void ConfigExporter::exportWorld() {
 void ConfigExporter::exportBlockList() {
     blockListElt = new TiXmlElement("blockList");
     Vector3D blockSize = world->lattice->gridScale;
-    map<bID, BaseSimulator::BuildingBlock*> blocks = world->getMap();
     blockListElt->SetAttribute("blockSize", toXmlAttribute(blockSize).c_str());
+    worldElt->LinkEndChild(blockListElt);
+}
 
-    for(auto const& idBBPair : blocks) {
-        if (idBBPair.second->getState() != BuildingBlock::REMOVED
-            and (idBBPair.second->ptrGlBlock and idBBPair.second->ptrGlBlock->isVisible()))
-            exportBlock(idBBPair.second);
+bool ConfigExporter::isExported(BuildingBlock *bb) {
+    return bb->getState() != BuildingBlock::REMOVED
+        and (bb->ptrGlBlock and bb->ptrGlBlock->isVisible());
+}
+
+ExportedBlock ConfigExporter::exportBlock(BuildingBlock *bb) {
+    ExportedBlock eb { bb->position, bb->color, bb->isMaster, string() };
+
+    // Family specific attributes are collected through a temporary element
+    TiXmlElement bbElt("block");
+    exportAdditionalAttribute(&bbElt, bb);
+    for (const TiXmlAttribute *a = bbElt.FirstAttribute(); a; a = a->Next()) {
+        eb.attributes.append(a->Name()).push_back('\0');
+        eb.attributes.append(a->Value()).push_back('\0');
     }
 
-    worldElt->LinkEndChild(blockListElt);
+    return eb;
+}
+
+void SnapshotConfigExporter::residualDocument(TiXmlDocument &doc) {
+    doc = *Simulator::getSimulator()->getConfigDocument();
+
+    TiXmlNode *worldNode = doc.FirstChild("world");
+    if (worldNode) {
+        TiXmlNode *blockListNode = worldNode->FirstChild("blockList");
+        if (blockListNode) {
+            blockListNode->Clear();
+            TiXmlElement *blockListElt = blockListNode->ToElement();
+            blockListElt->RemoveAttribute("ids");
+            blockListElt->RemoveAttribute("idseed");
+            blockListElt->RemoveAttribute("step");
+        } else {
+            worldNode->LinkEndChild(new TiXmlElement("blockList"));
+        }
+
+        TiXmlNode *obstacleListNode = worldNode->FirstChild("obstacleList");
+        if (obstacleListNode) worldNode->RemoveChild(obstacleListNode);
+    }
+}
+
+string SnapshotConfigExporter::exportResidualXml() {
+    TiXmlDocument doc;
+    residualDocument(doc);
+
+    TiXmlPrinter printer;
+    doc.Accept(&printer);
+    return printer.Str();
+}
+
+void SnapshotConfigExporter::captureRecords(vector<SnapshotBlock> &blocks,
+                                            vector<SnapshotObstacle> &obstacles,
+                                            string &attributes) {
+    const map<bID, string>& blockAttributes = Simulator::getSimulator()->getBlockAttributes();
+
+    const map<bID, BuildingBlock*>& blockMap = world->getMap();
+    blocks.reserve(blockMap.size());
+    for (auto const& idBBPair : blockMap) {
+        BuildingBlock *bb = idBBPair.second;
+        if (not isExported(bb))
+            continue;
+
+        SnapshotBlock rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.id = bb->blockId;
+        for (int i = 0; i < 3; i++) rec.position[i] = bb->position[i];
+        rec.orientation = bb->orientationCode;
+        // Obstacle modules are not inserted into the lattice
+        if (bb->isMaster) rec.flags |= SnapshotBlock::MASTER;
+        if (world->lattice->getBlock(bb->position) != bb) rec.flags |= SnapshotBlock::OBSTACLE;
+        for (int i = 0; i < 4; i++) rec.color[i] = bb->color[i];
+
+        const auto& attrs = blockAttributes.find(bb->blockId);
+        if (attrs != blockAttributes.end()) {
+            rec.attrOffset = attributes.size();
+            rec.attrSize = attrs->second.size();
+            attributes.append(attrs->second);
+        }
+
+        blocks.push_back(rec);
+    }
+
+    // Obstacles from the obstacleList only exist as graphical blocks
+    vector<bID> obstacleIds;
+    for (auto const& idGlPair : world->getMapGl()) {
+        if (blockMap.find(idGlPair.first) == blockMap.end())
+            obstacleIds.push_back(idGlPair.first);
+    }
+    sort(obstacleIds.begin(), obstacleIds.end());
+
+    const Vector3D& scale = world->lattice->gridScale;
+    for (bID id : obstacleIds) {
+        GlBlock *glb = world->getMapGl()[id];
+        SnapshotObstacle rec;
+        memset(&rec, 0, sizeof(rec));
+        for (int i = 0; i < 3; i++)
+            rec.position[i] = static_cast<int16_t>(lround(glb->position[i] / scale[i]));
+        for (int i = 0; i < 3; i++) rec.color[i] = glb->color[i];
+        rec.color[3] = 255;
+        obstacles.push_back(rec);
+    }
+}
+
+bool SnapshotConfigExporter::exportConfiguration() {
+    vector<SnapshotBlock> blocks;
+    vector<SnapshotObstacle> obstacles;
+    string attributes;
+    captureRecords(blocks, obstacles, attributes);
+
+    bool written = ConfigSnapshot::write(configName, exportResidualXml(), blocks, obstacles, attributes);
+    if (written)
+        cerr << "Configuration exported to file: " << configName << endl;
+    else
+        cerr << "error: could not write configuration snapshot " << configName << endl;
+
+    return written;
 }
 
-void ConfigExporter::exportBlock(BuildingBlock *bb) {
-    BuildingBlock *blc = bb;
-    TiXmlElement *bbElt = new TiXmlElement("block");
-    Cell3DPosition pos = blc->position;
+bool SnapshotXmlConfigExporter::exportConfiguration() {
+    vector<SnapshotBlock> blocks;
+    vector<SnapshotObstacle> obstacles;
+    string attributes;
+    captureRecords(blocks, obstacles, attributes);
+
+    TiXmlDocument doc;
+    residualDocument(doc);
+    TiXmlElement *worldElt = doc.FirstChildElement("world");
+    if (not worldElt) {
+        cerr << "error: no world element to export to " << configName << endl;
+        return false;
+    }
+
+    // IDs are given by the records, in MANUAL mode
+    TiXmlElement *blockListElt = worldElt->FirstChildElement("blockList");
+    blockListElt->SetAttribute("ids", "MANUAL");
+    for (const SnapshotBlock &rec : blocks) {
+        TiXmlElement bbElt("block");
+        bbElt.SetAttribute("id", to_string(rec.id));
+        bbElt.SetAttribute("position", toXmlAttribute<int>(rec.position[0], rec.position[1],
+                                                           rec.position[2]));
+        bbElt.SetAttribute("color", toXmlAttribute<int>(rec.color[0], rec.color[1], rec.color[2]));
+        bbElt.SetAttribute("orientation", rec.orientation);
+        if (rec.flags & SnapshotBlock::MASTER) bbElt.SetAttribute("master", "true");
+        if (rec.flags & SnapshotBlock::OBSTACLE) bbElt.SetAttribute("obstacle", "true");
+        ConfigSnapshot::forEachAttribute(string_view(attributes).substr(rec.attrOffset, rec.attrSize),
+                                         [&](string_view n, string_view v) {
+            bbElt.SetAttribute(string(n), string(v));
+        });
+        blockListElt->InsertEndChild(bbElt);
+    }
+
+    if (not obstacles.empty()) {
+        TiXmlElement *obstacleListElt = new TiXmlElement("obstacleList");
+        for (const SnapshotObstacle &rec : obstacles) {
+            TiXmlElement obstacleElt("obstacle");
+            obstacleElt.SetAttribute("position", toXmlAttribute<int>(rec.position[0], rec.position[1],
+                                                                     rec.position[2]));
+            obstacleElt.SetAttribute("color", toXmlAttribute<int>(rec.color[0], rec.color[1],
+                                                                  rec.color[2]));
+            obstacleListElt->InsertEndChild(obstacleElt);
+        }
+        worldElt->LinkEndChild(obstacleListElt);
+    }
 
-    bbElt->SetAttribute("position", toXmlAttribute(pos).c_str());
-    bbElt->SetAttribute("color", toXmlAttribute(blc->color[0],blc->color[1],blc->color[2]).c_str());
-    if (bb->isMaster) bbElt->SetAttribute("master", "true");
+    bool written = doc.SaveFile(configName);
+    if (written)
+        cerr << "Configuration exported to file: " << configName << endl;
+    else
+        cerr << "error: could not write configuration " << configName << endl;
 
-    exportAdditionalAttribute(bbElt, bb);
-    blockListElt->LinkEndChild(bbElt);
+    return written;
 }
 
 void Catoms3DConfigExporter::exportAdditionalAttribute(TiXmlElement *bbElt, BuildingBlock *bb) {
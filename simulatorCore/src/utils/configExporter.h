@@ -7,6 +7,11 @@
 #ifndef CONFIGEXPORTER_H__
 #define CONFIGEXPORTER_H__
 
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+
 #define TIXML_USE_STL	1
 #include "../deps/TinyXML/tinyxml.h"
 
@@ -14,6 +19,7 @@
 #include "../base/buildingBlock.h"
 #include "../gui/openglViewer.h"
 #include "../gui/camera.h"
+#include "configSnapshot.h"
 
 using namespace std;
 
@@ -23,6 +29,16 @@ namespace BaseSimulator {
  *   Abstract Configuration Exporter
  ************************************************************/
 
+/**
+ * @brief State of a block at time of export, as written to the blockList
+ */
+struct ExportedBlock {
+    Cell3DPosition position; //!< position of the block
+    Color color;             //!< color of the block
+    bool master;             //!< true if the block is a master block
+    string attributes;       //!< "name\0value\0" pairs set by exportAdditionalAttribute, empty if none
+};
+
 /**
  * @brief Abstract Configuration Exporter
  *
@@ -32,6 +48,12 @@ namespace BaseSimulator {
  *  2. The current state of the camera and lightsource
  *  3. The list of blocks and their current attributes.
  *    (Common ones + type specific ones exported by the virtual function exportAdditionalAttribute)
+ *
+ * Only the world and camera elements are built as a TinyXML document, blocks are written
+ *  to the file one at a time, in the same format as TiXmlDocument::SaveFile.
+ *
+ * When a period is set (--export-period), configurations are also exported during the simulation.
+ *  Blocks are then captured by the simulation thread, and written on a background thread.
  */
 class ConfigExporter {
 protected:
@@ -39,8 +61,29 @@ class ConfigExporter {
     TiXmlDocument *config; //!< the TiXML Document used for export
     string configName;     //!< the name of the output configuration file
     TiXmlElement *worldElt; //!< a pointer to the world XML element of the document
-    TiXmlElement *blockListElt; //!< a pointer to the blockList XML element of the document
+    TiXmlElement *blockListElt; //!< a pointer to the blockList XML element of the document, written last
+
+    inline static bool backgroundExport = false; //!< if true, the next export is written on the background thread
+    inline static Time nextExportDate = 0; //!< date of the next periodic export
+    inline static std::future<void> backgroundExportDone; //!< completion of the last periodic export
+
+    /**
+     * @return the prefix of the names of the exported configuration files, derived from the configuration file name
+     */
+    static string getExportNameRoot();
+
+    /**
+     * @brief Writes a configuration file from a document and a block list
+     * @param fileName name of the output file
+     * @param doc document holding the world element, whose last child is an empty blockList
+     * @param blocks function called with a function writing one block, to be called on each block to export
+     * @return false if the file could not be written
+     */
+    template<typename F>
+    static bool writeConfiguration(const string &fileName, const TiXmlDocument &doc, F blocks);
 public:
+    inline static Time exportPeriod = 0; //!< period of the exports during the simulation, 0 if disabled
+
     /**
      * @brief Constructor for the abstract configuration exporter
      *  Creates the output document, filename and header
@@ -61,8 +104,21 @@ class ConfigExporter {
 
     /**
      * @brief Main function of the configuration exporter, calls all export subfunctions sequentially.
+     * @return false if the file could not be written
      */
-    void exportConfiguration();
+    virtual bool exportConfiguration();
+
+    /**
+     * @brief Exports the configuration of the world on a background thread if the export period has elapsed,
+     *  to be called by the scheduler after each event
+     * @param date current simulation date
+     */
+    static void exportConfigurationIfNeeded(Time date);
+
+    /**
+     * @brief Waits for the background thread to finish writing the last periodic export
+     */
+    static void waitForBackgroundExport();
     /**
      * @brief Exports the camera and lightSource (Current position and orientation) to the configuration file.
      */
@@ -72,16 +128,21 @@ class ConfigExporter {
      */
     void exportWorld();
     /**
-     * @brief Initializes the blockList XML element and calls exportBlock on each block for export.
-     *  The default color of the blockList will be the one of the user selected block.
+     * @brief Initializes the blockList XML element, blocks are added when writing the file.
      */
     void exportBlockList();
     /**
      * @brief Exports all the generic attributes of a BuildingBlock
      * @param bb : Pointer to the block to export
+     * @return the state of the block to be written
      *  If exporting a block family specific attribute is needed, the exportAdditionalAttribute can be used.
      */
-    void exportBlock(BuildingBlock *bb);
+    ExportedBlock exportBlock(BuildingBlock *bb);
+    /**
+     * @brief Indicates whether a block is part of the exported configuration
+     * @param bb : Pointer to the block
+     */
+    static bool isExported(BuildingBlock *bb);
 
     /**
      * @brief Exports additional non-generic attributes from block bb.
@@ -91,6 +152,84 @@ class ConfigExporter {
     virtual void exportAdditionalAttribute(TiXmlElement *bbElt, BuildingBlock *bb) {};
 };
 
+/************************************************************
+ *   Binary Snapshot Exporter
+ ************************************************************/
+
+/**
+ * @brief Binary Configuration Exporter
+ *
+ * Saves the world at time of export into a binary snapshot (see configSnapshot.h).
+ *  Modules and obstacles are written as binary records, while all other elements of
+ *  the current configuration (visuals, camera, target, customizations...) are copied as XML.
+ *  Common to all block families, since the records and the stored block attributes
+ *  hold everything that is read from the blockList.
+ */
+class SnapshotConfigExporter : public ConfigExporter {
+protected:
+    /**
+     * @brief Captures the records of the modules and obstacles of the world
+     * @param blocks module records, in block ID order
+     * @param obstacles obstacle records
+     * @param attributes block attributes section, referenced by the module records
+     */
+    void captureRecords(vector<SnapshotBlock> &blocks, vector<SnapshotObstacle> &obstacles,
+                        string &attributes);
+
+    /**
+     * @brief Copies the current configuration document without its blocks and obstacles,
+     *  and without ID assignment attributes (IDs are stored in the block records)
+     * @param doc the output document
+     */
+    static void residualDocument(TiXmlDocument &doc);
+public:
+    /**
+     * @brief Constructor for the binary configuration exporter
+     * @param _world world to export
+     * @param _filename name of the output file
+     */
+    SnapshotConfigExporter(World *_world, const string& _filename)
+        : ConfigExporter(_world, _filename) {};
+    virtual ~SnapshotConfigExporter() {};
+
+    /**
+     * @brief Writes the snapshot file
+     * @return false if the file could not be written
+     */
+    virtual bool exportConfiguration() override;
+
+    /**
+     * @brief Generates the XML part of the snapshot (see residualDocument)
+     * @return the XML text
+     */
+    static string exportResidualXml();
+};
+
+/**
+ * @brief XML Conversion Exporter
+ *
+ * Saves the content of a snapshot of the world as an XML configuration: the residual XML,
+ *  with every module record as a block element (ID, position, color, orientation, master and
+ *  obstacle flags, stored attributes) of a MANUAL ID blockList, and every obstacle record in
+ *  an obstacleList. Loading the file gives back the configuration that was exported.
+ */
+class SnapshotXmlConfigExporter : public SnapshotConfigExporter {
+public:
+    /**
+     * @brief Constructor for the XML conversion exporter
+     * @param _world world to export
+     * @param _filename name of the output file
+     */
+    SnapshotXmlConfigExporter(World *_world, const string& _filename)
+        : SnapshotConfigExporter(_world, _filename) {};
+    virtual ~SnapshotXmlConfigExporter() {};
+
+    /**
+     * @brief Writes the XML configuration file
+     * @return false if the file could not be written
+     */
+    virtual bool exportConfiguration() override;
+};
 
 /************************************************************
  *   Subclasses
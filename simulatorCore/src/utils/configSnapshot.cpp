@@ -0,0 +1,155 @@
+/**
+ * @file configSnapshot.cpp
+ * Binary configuration snapshot format
+ */
+
+#include "configSnapshot.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace BaseSimulator {
+
+//!< Records are 8-byte aligned within the file, so that mapped records are aligned in memory
+static inline uint64_t alignRecord(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+bool ConfigSnapshot::isSnapshotFile(const string &fileName) {
+    ifstream fin(fileName, ios::in | ios::binary);
+    char magic[8];
+    return fin.read(magic, sizeof(magic))
+        and memcmp(magic, CONFIG_SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+bool ConfigSnapshot::load(const string &fileName) {
+    release();
+
+#ifndef WIN32
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 and st.st_size > 0) {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            data = static_cast<const char*>(addr);
+            size = st.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+#endif
+
+    if (not data) {
+        ifstream fin(fileName, ios::in | ios::binary);
+        if (not fin) return false;
+        buffer.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    // Validate header and sections bounds
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+    if (size < sizeof(SnapshotHeader)
+        or memcmp(h->magic, CONFIG_SNAPSHOT_MAGIC, sizeof(h->magic)) != 0
+        or h->version != VERSION
+        or h->headerSize != sizeof(SnapshotHeader)
+        or h->xmlOffset + h->xmlSize >= size
+        or data[h->xmlOffset + h->xmlSize] != '\0'
+        or h->blocksOffset + h->nbBlocks * sizeof(SnapshotBlock) > size
+        or h->obstaclesOffset + h->nbObstacles * sizeof(SnapshotObstacle) > size
+        or h->attributesOffset + h->attributesSize > size) {
+        release();
+        return false;
+    }
+
+    return true;
+}
+
+void ConfigSnapshot::release() {
+#ifndef WIN32
+    if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+    vector<char>().swap(buffer);
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
+
+string_view ConfigSnapshot::getXml() const {
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+    return string_view(data + h->xmlOffset, h->xmlSize);
+}
+
+const SnapshotBlock* ConfigSnapshot::getBlocks() const {
+    if (not data) return nullptr;
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+    return reinterpret_cast<const SnapshotBlock*>(data + h->blocksOffset);
+}
+
+size_t ConfigSnapshot::getNbBlocks() const {
+    return data ? reinterpret_cast<const SnapshotHeader*>(data)->nbBlocks : 0;
+}
+
+const SnapshotObstacle* ConfigSnapshot::getObstacles() const {
+    if (not data) return nullptr;
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+    return reinterpret_cast<const SnapshotObstacle*>(data + h->obstaclesOffset);
+}
+
+size_t ConfigSnapshot::getNbObstacles() const {
+    return data ? reinterpret_cast<const SnapshotHeader*>(data)->nbObstacles : 0;
+}
+
+string_view ConfigSnapshot::getAttributes(const SnapshotBlock &rec) const {
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+    if (rec.attrSize == 0 or rec.attrOffset + rec.attrSize > h->attributesSize)
+        return string_view();
+    return string_view(data + h->attributesOffset + rec.attrOffset, rec.attrSize);
+}
+
+bool ConfigSnapshot::write(const string &fileName, const string &xml,
+                           const vector<SnapshotBlock> &blocks,
+                           const vector<SnapshotObstacle> &obstacles,
+                           const string &attributes) {
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CONFIG_SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.headerSize = sizeof(SnapshotHeader);
+    h.xmlOffset = sizeof(SnapshotHeader);
+    h.xmlSize = xml.size();
+    h.blocksOffset = alignRecord(h.xmlOffset + h.xmlSize + 1);
+    h.nbBlocks = blocks.size();
+    h.obstaclesOffset = alignRecord(h.blocksOffset + h.nbBlocks * sizeof(SnapshotBlock));
+    h.nbObstacles = obstacles.size();
+    h.attributesOffset = h.obstaclesOffset + h.nbObstacles * sizeof(SnapshotObstacle);
+    h.attributesSize = attributes.size();
+
+    ofstream fout(fileName, ios::out | ios::binary | ios::trunc);
+    if (not fout) return false;
+
+    static const char zeros[8] = {};
+    fout.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    fout.write(xml.c_str(), xml.size() + 1);
+    fout.write(zeros, h.blocksOffset - (h.xmlOffset + h.xmlSize + 1));
+    fout.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(SnapshotBlock));
+    fout.write(zeros, h.obstaclesOffset - (h.blocksOffset + h.nbBlocks * sizeof(SnapshotBlock)));
+    fout.write(reinterpret_cast<const char*>(obstacles.data()),
+               obstacles.size() * sizeof(SnapshotObstacle));
+    fout.write(attributes.data(), attributes.size());
+
+    return fout.good();
+}
+
+} // namespace BaseSimulator
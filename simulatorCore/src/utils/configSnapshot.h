@@ -0,0 +1,158 @@
+/**
+ * @file configSnapshot.h
+ * Header for the binary configuration snapshot format
+ *
+ * A snapshot holds the same information as an XML configuration file, but stores
+ *  modules and obstacles as fixed-size binary records that can be memory-mapped and
+ *  fed to the world without any text parsing. Everything else (visuals, world
+ *  attributes, camera, target, customizations) is kept as XML text inside the snapshot
+ *  and parsed by TinyXML, so that it goes through the regular configuration parsing.
+ *
+ * Block-specific attributes that are not part of the records (e.g. those read by
+ *  BlockCode::parseUserBlockElements) are stored as "name\0value\0" pairs in an attribute section.
+ *
+ * File layout (host byte order):
+ *  [SnapshotHeader][XML text + '\0'][padding][SnapshotBlock * nbBlocks][SnapshotObstacle * nbObstacles][attributes]
+ */
+
+#ifndef CONFIGSNAPSHOT_H__
+#define CONFIGSNAPSHOT_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BaseSimulator {
+
+#define CONFIG_SNAPSHOT_MAGIC "VSIMSNAP" //!< first 8 bytes of every snapshot file
+#define CONFIG_SNAPSHOT_EXT ".vsnap"     //!< extension of snapshot files
+
+//!< Header of a snapshot file, offsets are relative to the beginning of the file
+struct SnapshotHeader {
+    char magic[8];            //!< CONFIG_SNAPSHOT_MAGIC
+    uint32_t version;         //!< ConfigSnapshot::VERSION of the writer
+    uint32_t headerSize;      //!< sizeof(SnapshotHeader) of the writer
+    uint64_t xmlOffset;       //!< offset of the residual XML configuration text
+    uint64_t xmlSize;         //!< size of the XML text, without its terminating '\0'
+    uint64_t blocksOffset;    //!< offset of the first SnapshotBlock record
+    uint64_t nbBlocks;        //!< number of SnapshotBlock records
+    uint64_t obstaclesOffset; //!< offset of the first SnapshotObstacle record
+    uint64_t nbObstacles;     //!< number of SnapshotObstacle records
+    uint64_t attributesOffset; //!< offset of the block attributes section
+    uint64_t attributesSize;  //!< size of the block attributes section
+};
+
+//!< A module of the blockList (modules and obstacle modules)
+struct SnapshotBlock {
+    enum Flags : uint8_t { MASTER = 0x1, OBSTACLE = 0x2 };
+
+    uint64_t id;          //!< block ID
+    int16_t position[3];  //!< lattice cell of the block
+    uint8_t orientation;  //!< orientation code of the block
+    uint8_t flags;        //!< combination of Flags
+    uint8_t color[4];     //!< RGBA color
+    uint32_t attrSize;    //!< size of the additional attributes of the block, 0 if none
+    uint64_t attrOffset;  //!< offset of the additional attributes in the attributes section
+};
+
+//!< An element of the obstacleList (displayed only, not part of the lattice)
+struct SnapshotObstacle {
+    int16_t position[3]; //!< lattice cell of the obstacle
+    uint8_t color[4];    //!< RGBA color
+    uint8_t padding[2];
+};
+
+static_assert(sizeof(SnapshotBlock) == 32, "SnapshotBlock records must be packed");
+static_assert(sizeof(SnapshotObstacle) == 12, "SnapshotObstacle records must be packed");
+
+/**
+ * @brief Read-only, memory-mapped view of a snapshot file
+ */
+class ConfigSnapshot {
+    const char *data = nullptr; //!< content of the file
+    size_t size = 0; //!< size of the file
+    bool mapped = false; //!< true if data was memory-mapped, false if read into buffer
+    std::vector<char> buffer; //!< file content when memory mapping is unavailable
+public:
+    static const uint32_t VERSION = 1; //!< current version of the format
+
+    ConfigSnapshot() {};
+    ConfigSnapshot(const ConfigSnapshot&) = delete;
+    ~ConfigSnapshot() { release(); };
+
+    /**
+     * @brief Checks the magic number of a file
+     * @param fileName path to the file
+     * @return true if the file exists and is a configuration snapshot
+     */
+    static bool isSnapshotFile(const std::string &fileName);
+
+    /**
+     * @brief Maps a snapshot file into memory and checks its header
+     * @param fileName path to the snapshot file
+     * @return false if the file could not be read or is not a valid snapshot
+     */
+    bool load(const std::string &fileName);
+
+    /**
+     * @brief Unmaps the snapshot file
+     */
+    void release();
+
+    //!< @return true if a snapshot is currently loaded
+    bool isLoaded() const { return data != nullptr; }
+
+    //!< @return the residual XML configuration (NUL-terminated)
+    std::string_view getXml() const;
+
+    //!< @return the module records, in export order
+    const SnapshotBlock* getBlocks() const;
+    size_t getNbBlocks() const;
+
+    //!< @return the obstacle records, in export order
+    const SnapshotObstacle* getObstacles() const;
+    size_t getNbObstacles() const;
+
+    /**
+     * @brief Gives access to the additional attributes of a block
+     * @param rec block record
+     * @return a view on the "name\0value\0" pairs of the block, empty if none
+     */
+    std::string_view getAttributes(const SnapshotBlock &rec) const;
+
+    /**
+     * @brief Iterates over "name\0value\0" attribute pairs
+     * @param attrs attribute pairs, as returned by getAttributes
+     * @param f function called with each name and value
+     */
+    template<typename F>
+    static void forEachAttribute(std::string_view attrs, F f) {
+        while (not attrs.empty()) {
+            std::string_view name = attrs.substr(0, attrs.find('\0'));
+            attrs.remove_prefix(std::min(attrs.size(), name.size() + 1));
+            std::string_view value = attrs.substr(0, attrs.find('\0'));
+            attrs.remove_prefix(std::min(attrs.size(), value.size() + 1));
+            f(name, value);
+        }
+    }
+
+    /**
+     * @brief Writes a snapshot file
+     * @param fileName path to the output file
+     * @param xml residual XML configuration
+     * @param blocks module records
+     * @param obstacles obstacle records
+     * @param attributes block attributes section, referenced by the block records
+     * @return false if the file could not be written
+     */
+    static bool write(const std::string &fileName, const std::string &xml,
+                      const std::vector<SnapshotBlock> &blocks,
+                      const std::vector<SnapshotObstacle> &obstacles,
+                      const std::string &attributes);
+};
+
+} // namespace BaseSimulator
+
+#endif // CONFIGSNAPSHOT_H__
@@ -0,0 +1,242 @@
+/**
+ * @file configStreamParser.cpp
+ * Streaming configuration file parser
+ */
+
+#include "configStreamParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "exceptions.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+static inline bool isXmlBlank(char c) {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r';
+}
+
+/************************************************************
+ *   XmlElementView
+ ************************************************************/
+
+string_view XmlElementView::attribute(string_view name) const {
+    string_view res;
+    forEachAttribute([&](string_view n, string_view v) {
+        if (n != name) return false;
+        res = v;
+        return true;
+    });
+    return res;
+}
+
+void XmlElementView::fillTiXmlElement(TiXmlElement &elt) const {
+    forEachAttribute([&](string_view n, string_view v) {
+        elt.SetAttribute(string(n), string(v));
+        return false;
+    });
+}
+
+/************************************************************
+ *   ConfigStreamParser
+ ************************************************************/
+
+bool ConfigStreamParser::load(const string &fileName) {
+    ifstream fin(fileName, ios::in | ios::binary);
+    if (not fin) return false;
+
+    fin.seekg(0, ios::end);
+    const streamoff len = fin.tellg();
+    if (len <= 0) return false;
+    buffer.resize(len);
+    fin.seekg(0, ios::beg);
+    if (not fin.read(&buffer[0], len)) return false;
+
+    // Normalize line endings in place, as TiXmlDocument::LoadFile does (CR LF and CR -> LF)
+    size_t w = 0;
+    for (size_t r = 0; r < buffer.size(); r++) {
+        if (buffer[r] == '\r') {
+            buffer[w++] = '\n';
+            if (r + 1 < buffer.size() and buffer[r + 1] == '\n') r++;
+        } else buffer[w++] = buffer[r];
+    }
+    buffer.resize(w);
+
+    // Single pass over the document, tracking the path of open elements
+    //  and collecting the ranges of the elements to stream
+    vector<string_view> path;
+    vector<pair<size_t,size_t>> blockRanges, obstacleRanges;
+    bool blockListDone = false, obstacleListDone = false;
+    bool inBlockList = false, inObstacleList = false;
+    bool blocksStreamable = true, obstaclesStreamable = true;
+
+    const char *base = buffer.data();
+    size_t i = 0;
+    while ((i = buffer.find('<', i)) != string::npos) {
+        if (buffer.compare(i, 4, "<!--") == 0) {
+            i = buffer.find("-->", i + 4);
+            if (i == string::npos) break;
+            i += 3;
+            continue;
+        }
+
+        if (buffer.compare(i, 9, "<![CDATA[") == 0) {
+            i = buffer.find("]]>", i + 9);
+            if (i == string::npos) break;
+            i += 3;
+            continue;
+        }
+
+        if (buffer.compare(i, 2, "<?") == 0 or buffer.compare(i, 2, "<!") == 0) {
+            i = buffer.find('>', i + 2);
+            if (i == string::npos) break;
+            i++;
+            continue;
+        }
+
+        if (buffer.compare(i, 2, "</") == 0) {
+            if (not path.empty()) {
+                if (path.size() == 2 and inBlockList) { inBlockList = false; blockListDone = true; }
+                if (path.size() == 2 and inObstacleList) { inObstacleList = false; obstacleListDone = true; }
+                path.pop_back();
+            }
+            i = buffer.find('>', i + 2);
+            if (i == string::npos) break;
+            i++;
+            continue;
+        }
+
+        // Start tag: read name, then find the end of the tag while skipping quoted values
+        size_t nameEnd = i + 1;
+        while (nameEnd < buffer.size() and not isXmlBlank(buffer[nameEnd])
+               and buffer[nameEnd] != '/' and buffer[nameEnd] != '>')
+            nameEnd++;
+        string_view name(base + i + 1, nameEnd - i - 1);
+
+        size_t tagEnd = nameEnd;
+        char quote = 0;
+        bool hasEntity = false;
+        while (tagEnd < buffer.size()) {
+            const char c = buffer[tagEnd];
+            if (quote) {
+                if (c == quote) quote = 0;
+                else if (c == '&') hasEntity = true;
+            } else if (c == '"' or c == '\'') quote = c;
+            else if (c == '>') break;
+            tagEnd++;
+        }
+        if (tagEnd >= buffer.size()) break;
+        const bool selfClosing = buffer[tagEnd - 1] == '/';
+
+        if (path.size() == 1 and path[0] == "world") {
+            if (name == "blockList" and not blockListDone) {
+                inBlockList = not selfClosing;
+                blockListDone = selfClosing;
+            } else if (name == "obstacleList" and not obstacleListDone) {
+                inObstacleList = not selfClosing;
+                obstacleListDone = selfClosing;
+            }
+        } else if (path.size() == 2) {
+            // Elements with children or escaped characters are left to TinyXML
+            if (inBlockList and name == "block") {
+                if (selfClosing and not hasEntity) blockRanges.push_back({ i, tagEnd + 1 });
+                else blocksStreamable = false;
+            } else if (inObstacleList and name == "obstacle") {
+                if (selfClosing and not hasEntity) obstacleRanges.push_back({ i, tagEnd + 1 });
+                else obstaclesStreamable = false;
+            }
+        }
+
+        if (not selfClosing) path.push_back(name);
+        i = tagEnd + 1;
+    }
+
+    // Relative order of block elements determines their IDs, so either all of them
+    //  are streamed, or none
+    if (not blocksStreamable) blockRanges.clear();
+    if (not obstaclesStreamable) obstacleRanges.clear();
+
+    vector<pair<size_t,size_t>> removed;
+    removed.reserve(blockRanges.size() + obstacleRanges.size());
+    std::merge(blockRanges.begin(), blockRanges.end(),
+               obstacleRanges.begin(), obstacleRanges.end(), back_inserter(removed));
+
+    // Views skip the '<' and element name, and stop before the closing "/>"
+    blocks.reserve(blockRanges.size());
+    for (const auto &r : blockRanges)
+        blocks.emplace_back(base + r.first + strlen("<block"), base + r.second - 2);
+    obstacles.reserve(obstacleRanges.size());
+    for (const auto &r : obstacleRanges)
+        obstacles.emplace_back(base + r.first + strlen("<obstacle"), base + r.second - 2);
+
+    size_t kept = 0;
+    domText.reserve(buffer.size());
+    for (const auto &r : removed) {
+        domText.append(buffer, kept, r.first - kept);
+        kept = r.second;
+    }
+    domText.append(buffer, kept, string::npos);
+
+    return true;
+}
+
+void ConfigStreamParser::release() {
+    vector<XmlElementView>().swap(blocks);
+    vector<XmlElementView>().swap(obstacles);
+    string().swap(domText);
+    string().swap(buffer);
+}
+
+bool ConfigStreamParser::parseInt(const char *&p, const char *end, int &res) {
+    while (p < end and isXmlBlank(*p)) p++;
+    bool neg = false;
+    if (p < end and (*p == '-' or *p == '+')) neg = (*p++ == '-');
+    if (p >= end or *p < '0' or *p > '9') return false;
+    int v = 0;
+    while (p < end and *p >= '0' and *p <= '9') v = v * 10 + (*p++ - '0');
+    res = neg ? -v : v;
+    return true;
+}
+
+/**
+ * @brief Parses three comma separated integers from v into res
+ * @return true if successful
+ */
+static bool parseIntTriple(string_view v, int res[3]) {
+    const char *p = v.data(), *end = v.data() + v.size();
+    for (int k = 0; k < 3; k++) {
+        if (not ConfigStreamParser::parseInt(p, end, res[k])) return false;
+        if (k < 2) {
+            while (p < end and *p != ',') p++;
+            if (p++ >= end) return false;
+        }
+    }
+    return true;
+}
+
+void ConfigStreamParser::parseCell3DPosition(string_view v, Cell3DPosition &pos) {
+    int xyz[3];
+    if (not parseIntTriple(v, xyz)) {
+        stringstream error;
+        error << "invalid position attribute value in configuration file: " << v << "\n";
+        throw ParsingException(error.str());
+    }
+    pos.set(xyz[0], xyz[1], xyz[2]);
+}
+
+void ConfigStreamParser::parseColor(string_view v, Color &color) {
+    int rgb[3];
+    if (not parseIntTriple(v, rgb)) {
+        stringstream error;
+        error << "invalid color attribute value in configuration file: " << v << "\n";
+        throw ParsingException(error.str());
+    }
+    color.set(rgb[0], rgb[1], rgb[2], color[3]);
+}
+
+} // namespace BaseSimulator
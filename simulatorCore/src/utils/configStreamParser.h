@@ -0,0 +1,131 @@
+/**
+ * @file configStreamParser.h
+ * Header for the streaming configuration file parser
+ *
+ * Large configurations (10^5 - 10^6 modules) spend most of their loading time
+ *  building and walking the TinyXML DOM for the blockList and obstacleList
+ *  sections. ConfigStreamParser performs a single linear scan of the configuration
+ *  file, extracts the self-closing <block/> and <obstacle/> elements of these
+ *  sections as zero-copy views into the file buffer, and hands the remaining
+ *  (small) document to TinyXML.
+ */
+
+#ifndef CONFIGSTREAMPARSER_H__
+#define CONFIGSTREAMPARSER_H__
+
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define TIXML_USE_STL	1
+#include "../deps/TinyXML/tinyxml.h"
+
+#include "../grid/cell3DPosition.h"
+#include "color.h"
+
+namespace BaseSimulator {
+
+/**
+ * @brief Zero-copy view of a self-closing XML element inside the configuration buffer
+ */
+class XmlElementView {
+    const char *attrBegin; //!< first character after the element name
+    const char *attrEnd; //!< position of the closing "/>" of the element
+public:
+    XmlElementView(const char *b, const char *e) : attrBegin(b), attrEnd(e) {}
+
+    /**
+     * @brief Iterates over the name="value" pairs of the element, without copying them
+     * @param f function called with each name and value, iteration stops when it returns true
+     */
+    template<typename F>
+    void forEachAttribute(F f) const {
+        const char *p = attrBegin;
+        while (p < attrEnd) {
+            while (p < attrEnd and isspace(*p)) p++;
+            const char *name = p;
+            while (p < attrEnd and *p != '=' and not isspace(*p)) p++;
+            std::string_view n(name, p - name);
+            while (p < attrEnd and *p != '\'' and *p != '"') p++;
+            if (p >= attrEnd) return;
+            const char quote = *p++;
+            const char *value = p;
+            while (p < attrEnd and *p != quote) p++;
+            if (f(n, std::string_view(value, p - value))) return;
+            p++;
+        }
+    }
+
+    /**
+     * @brief Looks up the raw value of an attribute, without copying it
+     * @param name attribute name
+     * @return a view on the attribute value, whose data() is nullptr if attribute is absent
+     */
+    std::string_view attribute(std::string_view name) const;
+
+    /**
+     * @brief Copies all attributes of the element into a TinyXML element,
+     *  for block-specific parsing functions that expect a TiXmlElement
+     * @param elt element to populate
+     */
+    void fillTiXmlElement(TiXmlElement &elt) const;
+};
+
+/**
+ * @brief Single pass configuration file scanner for the blockList and obstacleList sections
+ */
+class ConfigStreamParser {
+    std::string buffer; //!< raw content of the configuration file
+    std::string domText; //!< configuration file without the streamed elements, for TinyXML
+    std::vector<XmlElementView> blocks; //!< streamed world/blockList/block elements
+    std::vector<XmlElementView> obstacles; //!< streamed world/obstacleList/obstacle elements
+public:
+    /**
+     * @brief Reads and scans a configuration file
+     * @param fileName path to the configuration file
+     * @return false if the file could not be read, true otherwise
+     */
+    bool load(const std::string &fileName);
+
+    /**
+     * @return the text of the configuration file with all streamed elements removed,
+     *  to be parsed with TiXmlDocument::Parse
+     */
+    const std::string& getDomText() const { return domText; }
+
+    //!< @return views on the <block/> elements of the blockList, in file order
+    const std::vector<XmlElementView>& getBlocks() const { return blocks; }
+    //!< @return views on the <obstacle/> elements of the obstacleList, in file order
+    const std::vector<XmlElementView>& getObstacles() const { return obstacles; }
+
+    /**
+     * @brief Frees the file buffer and all element views once the configuration has been loaded
+     */
+    void release();
+
+    /**
+     * @brief Parses an integer in place, skipping leading blanks (stoi semantics)
+     * @param p current parsing position, advanced past the parsed integer
+     * @param end end of the input
+     * @param res parsed value
+     * @return true if an integer could be read
+     */
+    static bool parseInt(const char *&p, const char *end, int &res);
+
+    /**
+     * @brief Parses a "x,y,z" attribute value into a cell position
+     * @throw ParsingException if the value is ill-formatted
+     */
+    static void parseCell3DPosition(std::string_view v, Cell3DPosition &pos);
+
+    /**
+     * @brief Parses a "r,g,b" attribute value into a color (alpha is left untouched)
+     * @throw ParsingException if the value is ill-formatted
+     */
+    static void parseColor(std::string_view v, Color &color);
+};
+
+} // namespace BaseSimulator
+
+#endif // CONFIGSTREAMPARSER_H__
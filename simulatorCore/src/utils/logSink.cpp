@@ -0,0 +1,108 @@
+/**
+ * @file   logSink.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Asynchronous binary sink for console messages
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "logSink.h"
+#include "color.h"
+
+using namespace std;
+
+LogSink::ThreadBuffer::ThreadBuffer() {
+    data.reserve(bufferSize);
+    lock_guard<std::mutex> lock(mutex);
+    threadBuffers.push_back(this);
+}
+
+LogSink::ThreadBuffer::~ThreadBuffer() {
+    lock_guard<std::mutex> lock(mutex);
+    threadBuffers.erase(find(threadBuffers.begin(), threadBuffers.end(), this));
+    if (writer and not data.empty()) submit(data);
+}
+
+LogSink::ThreadBuffer& LogSink::getThreadBuffer() {
+    static thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+void LogSink::submit(vector<char> &data) {
+    pending.emplace_back();
+    pending.back().swap(data);
+    data.reserve(bufferSize);
+    cv.notify_one();
+}
+
+void LogSink::enable(const string &fn) {
+    enabled = true;
+    if (not fn.empty()) fileName = fn;
+}
+
+void LogSink::write(Time date, bID id, uint8_t level, const string &message) {
+    ThreadBuffer &buffer = getThreadBuffer();
+    vector<char> &data = buffer.data;
+
+    const uint32_t size = message.size();
+    const size_t offset = data.size();
+    data.resize(offset + sizeof(date) + sizeof(id) + sizeof(level) + sizeof(size) + size);
+    char *p = data.data() + offset;
+    memcpy(p, &date, sizeof(date)); p += sizeof(date);
+    memcpy(p, &id, sizeof(id)); p += sizeof(id);
+    memcpy(p, &level, sizeof(level)); p += sizeof(level);
+    memcpy(p, &size, sizeof(size)); p += sizeof(size);
+    memcpy(p, message.data(), size);
+
+    if (data.size() >= bufferSize or not writer.load(memory_order_acquire)) {
+        lock_guard<std::mutex> lock(mutex);
+        if (not writer) {
+            cout << TermColor::BWhite << "(log) writing console messages to file: "
+                 << TermColor::Reset << fileName << endl;
+            file.open(fileName, ios::out | ios::binary | ios::trunc);
+            file.write(LOG_SINK_MAGIC, strlen(LOG_SINK_MAGIC));
+            writer.store(new thread(writeLoop), memory_order_release);
+        }
+        if (data.size() >= bufferSize) submit(data);
+    }
+}
+
+void LogSink::writeLoop() {
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, []() { return stopping or not pending.empty(); });
+        while (not pending.empty()) {
+            vector<char> data;
+            data.swap(pending.front());
+            pending.pop_front();
+            lock.unlock();
+            file.write(data.data(), data.size());
+            lock.lock();
+        }
+        if (stopping) return;
+    }
+}
+
+void LogSink::endLogging() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        if (not writer) return;
+        for (ThreadBuffer *buffer : threadBuffers)
+            if (not buffer->data.empty()) submit(buffer->data);
+        stopping = true;
+        cv.notify_one();
+    }
+    thread *t = writer.load();
+    t->join();
+    delete t;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        writer.store(nullptr);
+    }
+    stopping = false;
+    enabled = false;
+    file.close();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file   logSink.h
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Asynchronous binary sink for console messages
+ *
+ * When enabled (--log-sink), console messages are appended as binary records to a
+ *  buffer owned by the calling thread, without any text formatting. Full buffers are
+ *  handed to a writer thread that appends them to the log file.
+ *
+ * File layout: [LOG_SINK_MAGIC] then records [date u64][blockId u32][level u8][size u32][message],
+ *  in host byte order. Use utilities/decodeLog.py to convert it into the simulation.log format.
+ */
+
+#ifndef LOGSINK_H__
+#define LOGSINK_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tDefs.h"
+
+#define LOG_SINK_MAGIC "VSIMLOG1" //!< first 8 bytes of every binary log file
+
+class LogSink {
+    static inline bool enabled = false; //!< true if console messages go to the sink
+    static inline std::string fileName = "simulation.vslog"; //!< binary log file name
+    static inline const size_t bufferSize = 1 << 16; //!< size at which a thread buffer is written
+
+    //!< Per-thread record buffer, handed to the writer when full or when its thread exits
+    struct ThreadBuffer {
+        std::vector<char> data;
+        ThreadBuffer();
+        ~ThreadBuffer();
+    };
+
+    //! writer thread, started with the first message, set with mutex locked but tested without it by write
+    static inline std::atomic<std::thread*> writer{nullptr};
+    static inline std::mutex mutex; //!< protects all members below
+    static inline std::condition_variable cv; //!< signals the writer thread
+    static inline std::deque<std::vector<char>> pending; //!< buffers waiting to be written
+    static inline std::vector<ThreadBuffer*> threadBuffers; //!< buffers of all logging threads
+    static inline std::ofstream file; //!< binary log file
+    static inline bool stopping = false; //!< asks the writer thread to terminate
+
+    //!< @return the buffer of the calling thread
+    static ThreadBuffer& getThreadBuffer();
+
+    //!< Hands a buffer to the writer thread, called with mutex locked
+    static void submit(std::vector<char> &data);
+
+    //!< Writer thread loop
+    static void writeLoop();
+public:
+    /**
+     * Enables the sink
+     * @param fn log file name, default file name is used if empty
+     */
+    static void enable(const std::string &fn);
+
+    //!< @return true if console messages are written to the sink
+    static inline bool isEnabled() { return enabled; }
+
+    /**
+     * Appends a message to the buffer of the calling thread
+     * @param date simulation date of the message
+     * @param id id of the module that wrote the message
+     * @param level LogLevel of the message
+     * @param message text of the message, without end of line
+     */
+    static void write(Time date, bID id, uint8_t level, const std::string &message);
+
+    /**
+     * Writes all buffered messages, stops the writer thread and closes the file
+     * @note Is called at scheduler end, when no other thread is logging
+     */
+    static void endLogging();
+};
+
+#endif // LOGSINK_H__
@@ -8,11 +8,17 @@
 #include "trace.h"
 #include "../events/scheduler.h"
 #include "../replay/replayExporter.h"
+#include "logSink.h"
 
 std::ofstream log_file{};
 
 ConsoleStream& ConsoleStream::operator<<(const char* value ) {
     int l=strlen(value);
+    if (not isEnabled(level)) {
+        if (l > 0 and value[l-1]=='\n') level = LOG_LEVEL_INFO;
+        return *this;
+    }
+
     if (value[l-1]=='\n') {
         string s(value);
         s = s.substr(0,l-1);
@@ -32,6 +38,10 @@ ConsoleStream& ConsoleStream::operator<<(const char* value ) {
 
 
 void ConsoleStream::flush() {
-    scheduler->trace(stream.str(),blockId);
+    if (LogSink::isEnabled())
+        LogSink::write(scheduler->now(), blockId, level, stream.str());
+    else
+        scheduler->trace(stream.str(),blockId);
     stream.str("");
+    level = LOG_LEVEL_INFO;
 }
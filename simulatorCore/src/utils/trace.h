@@ -32,11 +32,25 @@ namespace BaseSimulator {
 class Scheduler;
 }
 
+//!< Severity of console messages, a message is printed if its level is lower or equal
+//!< to both the compile-time (VS_LOG_LEVEL) and runtime (--log-level) levels
+enum LogLevel { LOG_LEVEL_NONE, LOG_LEVEL_ERROR, LOG_LEVEL_WARNING, LOG_LEVEL_INFO, LOG_LEVEL_DEBUG };
+
+// Compile-time level, e.g. TEMP_CCFLAGS += -DVS_LOG_LEVEL=LOG_LEVEL_WARNING
+#ifndef VS_LOG_LEVEL
+#define VS_LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
 class ConsoleStream {
     BaseSimulator::Scheduler *scheduler;
     bID blockId;
     stringstream stream;
+    LogLevel level = LOG_LEVEL_INFO; //!< level of the current line
 public:
+    static inline LogLevel runtimeLevel = LOG_LEVEL_DEBUG; //!< runtime level, set by --log-level
+
+    //!< @return true if messages of level l are printed
+    static inline bool isEnabled(LogLevel l) { return l <= VS_LOG_LEVEL and l <= runtimeLevel; }
 
     ConsoleStream() { stream.str(""); };
     void setInfo(BaseSimulator::Scheduler*s,bID id) {
@@ -44,15 +58,26 @@ class ConsoleStream {
         blockId=id;
     }
 
+    //!< Sets the level of the current line, LOG_LEVEL_INFO by default, use through CONSOLE(l)
+    ConsoleStream& at(LogLevel l) { level = l; return *this; }
+
     void flush();
 
     ConsoleStream& operator<<(const char* value );
 
     template<typename T>
     ConsoleStream& operator<<( T const& value ) {
-        stream << value;
+        if (isEnabled(level)) stream << value;
         return *this;
     }
 };
 
+/**
+ * Writes a line of level l to the console of the current block code, e.g.
+ *  CONSOLE(LOG_LEVEL_DEBUG) << "received " << msg << "\n";
+ * Operands are not even evaluated if the level is disabled, and the statement is removed
+ *  by the compiler if the level is above VS_LOG_LEVEL
+ */
+#define CONSOLE(l) if (not ConsoleStream::isEnabled(l)) {} else console.at(l)
+
 #endif
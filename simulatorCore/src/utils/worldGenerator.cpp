@@ -0,0 +1,173 @@
+/**
+ * @file   worldGenerator.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Procedural generation of configurations for scaling tests
+ */
+
+#include <climits>
+#include <cmath>
+#include <random>
+
+#include "worldGenerator.h"
+#include "exceptions.h"
+
+namespace BaseSimulator {
+
+static const char *topologyNames[WorldGenerator::NB_TOPOLOGIES] = {
+    "line", "grid", "blob", "blob3d", "disc", "maze"
+};
+
+WorldGenerator::WorldGenerator(int t, int s, unsigned int sd) : topology(t), size(s), seed(sd) {
+    long side;
+    long dims[3] = { 1, 1, 1 };
+    switch (topology) {
+        case LINE: dims[0] = size; break;
+        case GRID: dims[0] = dims[1] = size; break;
+        case BLOB: // large enough to hold the random growth of size modules
+            side = 2 * (long)ceil(sqrt(size)) + 1;
+            dims[0] = dims[1] = side;
+            break;
+        case BLOB3D:
+            side = 2 * (long)ceil(cbrt(size)) + 1;
+            dims[0] = dims[1] = dims[2] = side;
+            break;
+        case DISC: dims[0] = dims[1] = 2 * (long)size + 1; break;
+        case MAZE: dims[0] = dims[1] = max(3, size | 1); break; // rooms at odd coordinates
+    }
+
+    sizeValid = size > 0 and dims[0] <= SHRT_MAX and dims[1] <= SHRT_MAX and dims[2] <= SHRT_MAX;
+    if (sizeValid) gridSize.set(dims[0], dims[1], dims[2]);
+}
+
+int WorldGenerator::parseTopology(const string &name) {
+    for (int t = 0; t < NB_TOPOLOGIES; t++) {
+        if (name == topologyNames[t]) return t;
+    }
+    return -1;
+}
+
+string WorldGenerator::getTopologyNames() {
+    string names;
+    for (int t = 0; t < NB_TOPOLOGIES; t++) {
+        if (t) names += ", ";
+        names += topologyNames[t];
+    }
+    return names;
+}
+
+void WorldGenerator::generate(const Lattice *lattice) {
+    modules.clear();
+    obstacles.clear();
+
+    switch (topology) {
+        case LINE:
+            for (short x = 0; x < gridSize[0]; x++) modules.push_back(Cell3DPosition(x, 0, 0));
+            break;
+        case GRID:
+            for (short y = 0; y < gridSize[1]; y++)
+                for (short x = 0; x < gridSize[0]; x++) modules.push_back(Cell3DPosition(x, y, 0));
+            break;
+        case BLOB:
+            generateBlob(lattice, Cell3DPosition(gridSize[0] / 2, gridSize[1] / 2, 0));
+            break;
+        case BLOB3D:
+            generateBlob(lattice, Cell3DPosition(gridSize[0] / 2, gridSize[1] / 2, gridSize[2] / 2));
+            break;
+        case DISC: generateDisc(lattice); break;
+        case MAZE: generateMaze(); break;
+    }
+}
+
+void WorldGenerator::generateBlob(const Lattice *lattice, const Cell3DPosition &center) {
+    mt19937 generator(seed);
+    vector<bool> reached(nbCells(), false);
+    vector<Cell3DPosition> frontier = { center }; // free cells next to the blob
+    reached[cellIndex(center)] = true;
+    modules.reserve(size);
+
+    // Eden growth: a random cell of the frontier is added to the blob at each step
+    while ((int)modules.size() < size and not frontier.empty()) {
+        size_t i = uniform_int_distribution<size_t>(0, frontier.size() - 1)(generator);
+        Cell3DPosition p = frontier[i];
+        frontier[i] = frontier.back();
+        frontier.pop_back();
+        modules.push_back(p);
+
+        for (const Cell3DPosition &n : lattice->getNeighborhood(p)) {
+            if (not reached[cellIndex(n)]) {
+                reached[cellIndex(n)] = true;
+                frontier.push_back(n);
+            }
+        }
+    }
+
+    if ((int)modules.size() < size) {
+        stringstream error;
+        error << "only " << modules.size() << " modules of a " << topologyNames[topology]
+              << " of " << size << " modules fit in the lattice"
+              << (topology == BLOB3D ? ", blob3d requires a 3D lattice" : "") << "\n";
+        throw ParsingException(error.str());
+    }
+}
+
+void WorldGenerator::generateDisc(const Lattice *lattice) {
+    const Cell3DPosition center(size, size, 0);
+    vector<int> distance(nbCells(), -1);
+    distance[cellIndex(center)] = 0;
+    modules.push_back(center);
+
+    // Breadth-first search, modules are sorted by distance to the center
+    for (size_t head = 0; head < modules.size(); head++) {
+        const Cell3DPosition p = modules[head];
+        const int d = distance[cellIndex(p)];
+        if (d == size) continue;
+
+        for (const Cell3DPosition &n : lattice->getNeighborhood(p)) {
+            if (n[2] == 0 and distance[cellIndex(n)] < 0) {
+                distance[cellIndex(n)] = d + 1;
+                modules.push_back(n);
+            }
+        }
+    }
+}
+
+void WorldGenerator::generateMaze() {
+    mt19937 generator(seed);
+    const short side = gridSize[0];
+    vector<bool> open(nbCells(), false);
+
+    // Randomized depth-first search on the rooms, carving the walls between visited rooms
+    const Cell3DPosition moves[4] = { {2, 0, 0}, {-2, 0, 0}, {0, 2, 0}, {0, -2, 0} };
+    vector<Cell3DPosition> stack = { Cell3DPosition(1, 1, 0) };
+    open[cellIndex(stack.back())] = true;
+    while (not stack.empty()) {
+        const Cell3DPosition p = stack.back();
+        Cell3DPosition next[4];
+        int nbNext = 0;
+        for (const Cell3DPosition &m : moves) {
+            Cell3DPosition n = p + m;
+            if (n[0] > 0 and n[0] < side and n[1] > 0 and n[1] < side and not open[cellIndex(n)])
+                next[nbNext++] = n;
+        }
+
+        if (nbNext == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        const Cell3DPosition n = next[uniform_int_distribution<int>(0, nbNext - 1)(generator)];
+        open[cellIndex(Cell3DPosition((p[0] + n[0]) / 2, (p[1] + n[1]) / 2, 0))] = true;
+        open[cellIndex(n)] = true;
+        stack.push_back(n);
+    }
+
+    for (short y = 0; y < side; y++) {
+        for (short x = 0; x < side; x++) {
+            const Cell3DPosition p(x, y, 0);
+            (open[cellIndex(p)] ? modules : obstacles).push_back(p);
+        }
+    }
+}
+
+} // namespace BaseSimulator
@@ -0,0 +1,97 @@
+/**
+ * @file   worldGenerator.h
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Procedural generation of configurations for scaling tests
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../grid/cell3DPosition.h"
+#include "../grid/lattice.h"
+
+using namespace std;
+
+namespace BaseSimulator {
+
+/**
+ * Generates the module and obstacle positions of a configuration of a given topology and size,
+ *  for any module type, requested with --generate <topology> <size>.
+ *
+ * The grid size only depends on the topology and size, so that the world can be created before
+ *  generation. Positions are then generated using the connectivity of the lattice of the world:
+ *  - line: <size> modules along the x axis
+ *  - grid: <size> x <size> modules in the z = 0 plane
+ *  - blob: <size> modules grown at random from the center of the z = 0 plane
+ *  - blob3d: <size> modules grown at random from the center of the grid (3D lattices only)
+ *  - disc: modules at most <size> hops away from the center of the z = 0 plane,
+ *    a hexagon on hexagonal lattices
+ *  - maze: a random perfect maze in a <size> x <size> square, corridors are modules
+ *    and walls are obstacles
+ * Modules are connected, and random topologies only depend on the seed.
+ */
+class WorldGenerator {
+public:
+    enum Topology { LINE, GRID, BLOB, BLOB3D, DISC, MAZE, NB_TOPOLOGIES };
+
+    /**
+     * @param topology topology of the configuration
+     * @param size size parameter of the topology, see class description
+     * @param seed seed of the random topologies
+     */
+    WorldGenerator(int topology, int size, unsigned int seed);
+
+    /**
+     * @return the topology named name, or -1 if there is none
+     */
+    static int parseTopology(const string &name);
+
+    //!< @return the names of the topologies, separated by commas
+    static string getTopologyNames();
+
+    //!< @return the size of the grid containing the generated configuration
+    Cell3DPosition getGridSize() const { return gridSize; }
+
+    //!< @return false if the grid of the configuration would exceed the range of Cell3DPosition
+    bool isSizeValid() const { return sizeValid; }
+
+    /**
+     * Generates the configuration
+     * @param lattice lattice of the world, of size getGridSize()
+     * @throw ParsingException if the topology cannot be generated on this lattice
+     */
+    void generate(const Lattice *lattice);
+
+    //!< @return positions of the modules, in id order, the first one being the center or origin
+    const vector<Cell3DPosition>& getModules() const { return modules; }
+    //!< @return positions of the obstacles
+    const vector<Cell3DPosition>& getObstacles() const { return obstacles; }
+
+private:
+    int topology;
+    int size;
+    unsigned int seed;
+    Cell3DPosition gridSize;
+    bool sizeValid;
+    vector<Cell3DPosition> modules;
+    vector<Cell3DPosition> obstacles;
+
+    //!< @return index of p in a grid of size gridSize
+    inline size_t cellIndex(const Cell3DPosition &p) const {
+        return p[0] + (size_t)gridSize[0] * (p[1] + (size_t)gridSize[1] * p[2]);
+    }
+
+    //!< @return number of cells of the grid
+    inline size_t nbCells() const {
+        return (size_t)gridSize[0] * gridSize[1] * gridSize[2];
+    }
+
+    void generateBlob(const Lattice *lattice, const Cell3DPosition &center);
+    void generateDisc(const Lattice *lattice);
+    void generateMaze();
+};
+
+} // namespace BaseSimulator
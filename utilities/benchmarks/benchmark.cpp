@@ -0,0 +1,512 @@
+/**
+ * @file   benchmark.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Micro-benchmark harness and world generator of the VisibleSim benchmark suite
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "base/world.h"
+#include "comm/network.h"
+#include "events/events.h"
+#include "meld/meldInterpretVM.h"
+#include "stats/statsCollector.h"
+
+using namespace BaseSimulator;
+using namespace BaseSimulator::utils;
+
+#ifndef VSBENCH_SIMULATOR_SRC
+#define VSBENCH_SIMULATOR_SRC "../../simulatorCore/src"
+#endif
+
+void BenchmarkReport::measure(const string &name, const function<uint64_t()> &round) {
+    using clock = chrono::steady_clock;
+    uint64_t operations = 0;
+    const auto start = clock::now();
+    double elapsed = 0;
+    do {
+        operations += round();
+        elapsed = chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < minDuration);
+
+    add(name, operations, operations ? elapsed * 1e9 / operations : 0);
+}
+
+void BenchmarkReport::recordSimulationStats() {
+    ostringstream out;
+    StatsCollector::getInstance().writeJSON(out);
+    stats = out.str();
+}
+
+void BenchmarkReport::writeJSON(ostream &out, const string &module, int size) const {
+    out << fixed << setprecision(3);
+    out << "{\n  \"module\": \"" << module << "\",\n  \"size\": " << size
+        << ",\n  \"simulation\": " << (stats.empty() ? "null" : stats)
+        << ",\n  \"micro\": [";
+    bool first = true;
+    for (const Result &r : results) {
+        out << (first ? "\n" : ",\n")
+            << "    { \"name\": \"" << r.name << "\", \"operations\": " << r.operations
+            << ", \"nsPerOp\": " << r.nsPerOp << " }";
+        first = false;
+    }
+    out << (first ? "]" : "\n  ]") << "\n}";
+}
+
+bool writeConfiguration(const string &fileName, const Cell3DPosition &gridSize,
+                        const vector<Cell3DPosition> &positions) {
+    ofstream fout(fileName);
+    if (not fout) return false;
+
+    fout << "<?xml version=\"1.0\" standalone=\"no\" ?>\n"
+         << "<world gridSize=\"" << gridSize[0] << "," << gridSize[1] << "," << gridSize[2] << "\">\n"
+         << "<blockList color=\"128,128,128\">\n";
+    for (const Cell3DPosition &p : positions)
+        fout << "    <block position=\"" << p[0] << "," << p[1] << "," << p[2] << "\"/>\n";
+    fout << "</blockList>\n</world>\n";
+
+    return fout.good();
+}
+
+//!< Creates a private directory under /tmp, returns its path or an empty string on failure
+static string makeTemporaryDirectory() {
+    char dirName[] = "/tmp/vsbenchXXXXXX";
+    return mkdtemp(dirName) ? string(dirName) : string();
+}
+
+//!< Predicate of a synthetic Meld program
+struct MeldPredicate {
+    string name;
+    uint8_t properties; //!< 0x01 aggregate, 0x02 persistent, 0x04 linear
+    vector<uint8_t> argTypes; //!< FIELD_INT, FIELD_FLOAT...
+    vector<uint8_t> code; //!< bytecode run when a fact is derived or retracted
+};
+
+//!< Rule of a synthetic Meld program
+struct MeldRule {
+    string name;
+    vector<uint8_t> predicates; //!< included predicates, the rule runs while they all have facts
+    vector<uint8_t> code; //!< bytecode of the rule body
+};
+
+/**
+ * Writes a Meld program in the .bb format read by MeldInterpretVM::readProgram
+ * @param fileName output file name
+ * @param predicates predicates of the program, predicate 0 is _init
+ * @param rules rules of the program
+ * @return true if the file has been written successfully
+ */
+static bool writeMeldProgram(const string &fileName, const vector<MeldPredicate> &predicates,
+                             const vector<MeldRule> &rules) {
+    // Numbers of predicates and rules, offset of each descriptor, then the descriptors
+    vector<uint8_t> prog = { (uint8_t)predicates.size(), (uint8_t)rules.size() };
+    prog.resize(2 + 2 * (predicates.size() + rules.size()), 0);
+    vector<size_t> codeOffsets; // positions of the code offsets in the descriptors
+    size_t descriptor = 2;
+    for (const MeldPredicate &p : predicates) {
+        prog[descriptor] = prog.size();
+        descriptor += 2;
+        codeOffsets.push_back(prog.size());
+        prog.insert(prog.end(), { 0, 0, p.properties, 0, 0, (uint8_t)p.argTypes.size() });
+        prog.insert(prog.end(), p.argTypes.begin(), p.argTypes.end());
+    }
+    for (const MeldRule &r : rules) {
+        prog[descriptor] = prog.size();
+        descriptor += 2;
+        codeOffsets.push_back(prog.size());
+        prog.insert(prog.end(), { 0, 0, 0, (uint8_t)r.predicates.size() });
+        prog.insert(prog.end(), r.predicates.begin(), r.predicates.end());
+    }
+    if (prog.size() > 0xff) return false; // descriptor offsets are single bytes
+
+    vector<const vector<uint8_t>*> codes;
+    for (const MeldPredicate &p : predicates) codes.push_back(&p.code);
+    for (const MeldRule &r : rules) codes.push_back(&r.code);
+    for (size_t i = 0; i < codes.size(); i++) {
+        prog[codeOffsets[i]] = prog.size() & 0xff;
+        prog[codeOffsets[i] + 1] = prog.size() >> 8;
+        prog.insert(prog.end(), codes[i]->begin(), codes[i]->end());
+    }
+    if (prog.size() > 0xffff) return false;
+
+    // Every value is followed by a comma, as in the files generated by the Meld compiler
+    ofstream fout(fileName);
+    if (not fout) return false;
+    fout << "const unsigned char meld_prog[] = {" << hex << setfill('0');
+    for (uint8_t byte : prog) fout << "0x" << setw(2) << (int)byte << ", ";
+    fout << dec << "};\n\nchar *tuple_names[] = {";
+    for (const MeldPredicate &p : predicates) fout << "\"" << p.name << "\", ";
+    fout << "};\n\nchar *rule_names[] = {";
+    for (const MeldRule &r : rules) fout << "\"" << r.name << "\", ";
+    fout << "};\n";
+
+    return fout.good();
+}
+
+//!< Straight-line body of work(a, b, c): field moves, integer arithmetic and a test which always fails
+static const int meldWorkBlocks = 32;
+static const uint64_t meldWorkInstructions = 11 * meldWorkBlocks + 1;
+
+//!< Limit of the counter of the processAll program, see loadMeldProgram
+static const meld_int meldCountLimit = 100;
+
+/**
+ * Loads the Meld program of the benchmarks, MeldInterpretVM::setConfiguration only loads one
+ *  program per process. Predicates: _init, work(a, b, c) run by the dispatch benchmarks, linear
+ *  count(n) and persistent step(n). Rules: _init -o count(0). and
+ *  count(N), N < meldCountLimit -o count(N + 1), step(N).
+ * @return true if the program has been loaded
+ */
+static bool loadMeldProgram() {
+    vector<uint8_t> body;
+    for (int i = 0; i < meldWorkBlocks; i++) {
+        body.insert(body.end(), {
+            0x22, 0, 0, 1,          // MVFIELDREG 0.a -> r1
+            0x22, 1, 0, 2,          // MVFIELDREG 0.b -> r2
+            0x3d, 1, 2, 3,          // INTPLUS r1 r2 -> r3
+            0x1f, 3, 0, 0, 0, 4,    // MVINTREG 3 -> r4
+            0x44, 3, 4, 5,          // INTMUL r3 r4 -> r5
+            0x3e, 5, 1, 6,          // INTLESSER r5 r1 -> r6
+            0x60, 6, 10, 0, 0, 0,   // IF r6, skips the next instruction
+            0x26, 5, 2, 0,          // MVREGFIELD r5 -> 0.c
+            0x26, 3, 2, 0,          // MVREGFIELD r3 -> 0.c
+            0x21, 1, 0, 2, 0,       // MVFIELDFIELD 0.b -> 0.c
+            0x3a, 3, 1, 7,          // INTMINUS r3 r1 -> r7
+            0x07, 6, 8,             // NOT r6 -> r8
+        });
+    }
+    body.push_back(RETURN_INSTR);
+
+    // Linear iteration over the facts of type into r0, the body follows, then the code after it
+    auto linearIter = [](uint8_t type, uint8_t bodySize) -> vector<uint8_t> {
+        vector<uint8_t> iter(LINEAR_ITER_BASE, 0);
+        iter[0] = LINEAR_ITER_INSTR;
+        iter[9] = type;
+        iter[12] = LINEAR_ITER_BASE;                        // inner jump
+        iter[16] = LINEAR_ITER_BASE + bodySize;             // outer jump
+        return iter;
+    };
+    vector<uint8_t> init = { 0x10, 0, 0, 0, 0 };            // RULE 0
+    const vector<uint8_t> initBody = {
+        0x11,                                               // RULE_DONE
+        0x80, 0,                                            // REMOVE r0
+        0x40, 2, 1,                                         // ALLOC count -> r1
+        0x1e, 0, 0, 0, 0, 0, 1,                             // MVINTFIELD 0 -> 1.n
+        0x77, 1,                                            // ADDLINEAR r1
+        0xd0,                                               // RETURN_LINEAR
+    };
+    const vector<uint8_t> initIter = linearIter(0, initBody.size());
+    init.insert(init.end(), initIter.begin(), initIter.end());
+    init.insert(init.end(), initBody.begin(), initBody.end());
+    init.push_back(RETURN_INSTR);
+
+    vector<uint8_t> count = { 0x10, 1, 0, 0, 0 };           // RULE 1
+    const vector<uint8_t> countBody = {
+        0x22, 0, 0, 1,                                      // MVFIELDREG 0.n -> r1
+        0x1f, (uint8_t)meldCountLimit, 0, 0, 0, 2,          // MVINTREG meldCountLimit -> r2
+        0x3e, 1, 2, 3,                                      // INTLESSER r1 r2 -> r3
+        0x60, 3, 38, 0, 0, 0,                               // IF r3, else goes to NEXT
+        0x11,                                               // RULE_DONE
+        0x80, 0,                                            // REMOVE r0
+        0x40, 2, 4,                                         // ALLOC count -> r4
+        0x1f, 1, 0, 0, 0, 5,                                // MVINTREG 1 -> r5
+        0x3d, 1, 5, 6,                                      // INTPLUS r1 r5 -> r6
+        0x26, 6, 0, 4,                                      // MVREGFIELD r6 -> 4.n
+        0x77, 4,                                            // ADDLINEAR r4
+        0x40, 3, 7,                                         // ALLOC step -> r7
+        0x26, 1, 0, 7,                                      // MVREGFIELD r1 -> 7.n
+        0x78, 7,                                            // ADDPERS r7
+        0xd0,                                               // RETURN_LINEAR
+        0x01,                                               // NEXT
+    };
+    const vector<uint8_t> countIter = linearIter(2, countBody.size());
+    count.insert(count.end(), countIter.begin(), countIter.end());
+    count.insert(count.end(), countBody.begin(), countBody.end());
+    count.push_back(RETURN_INSTR);
+
+    const string dir = makeTemporaryDirectory();
+    if (dir.empty()) {
+        cerr << "error: cannot create a directory for the Meld program" << endl;
+        return false;
+    }
+    const string programFile = dir + "/vsbench_meld.bb";
+    const bool written = writeMeldProgram(programFile, {
+            { "_init", 0x04, {}, { RETURN_INSTR } },
+            { "work", 0x02, { FIELD_INT, FIELD_INT, FIELD_INT }, body },
+            { "count", 0x04, { FIELD_INT }, { RETURN_INSTR } },
+            { "step", 0x02, { FIELD_INT }, { RETURN_INSTR } },
+        }, {
+            { "_init -o count(0).", { 0 }, init },
+            { "count(N), N < limit -o count(N + 1), step(N).", { 2 }, count },
+        });
+    if (written) MeldInterpret::MeldInterpretVM::setConfiguration(programFile, false);
+    remove(programFile.c_str());
+    rmdir(dir.c_str());
+    if (not written) cerr << "error: cannot write Meld program " << programFile << endl;
+    return written;
+}
+
+/**
+ * Translates the Meld program of the benchmarks to C++ with MeldInterpretVM::writeNativeCode,
+ *  compiles it with $CXX (default: c++) in a temporary directory and loads it. The VMs run it
+ *  while MeldInterpretVM::nativeDispatch is set
+ * @return true if the native code has been loaded
+ */
+static bool loadMeldNativeCode() {
+    const string dir = makeTemporaryDirectory();
+    if (dir.empty()) {
+        cerr << "error: cannot create a directory for the Meld native code" << endl;
+        return false;
+    }
+    const string source = dir + "/vsbench_meld.cpp", library = dir + "/vsbench_meld.so";
+    MeldInterpret::MeldInterpretVM::writeNativeCode(source);
+    const char *compiler = getenv("CXX");
+    const string command = string(compiler ? compiler : "c++") + " -O2 -shared -fPIC -I"
+        + VSBENCH_SIMULATOR_SRC + " -o " + library + " " + source;
+    const bool compiled = system(command.c_str()) == 0;
+    if (compiled) MeldInterpret::MeldInterpretVM::readNativeCode(library);
+    else cerr << "error: cannot compile the Meld native code with " << command << endl;
+    // The loaded library stays mapped
+    remove(source.c_str());
+    remove(library.c_str());
+    rmdir(dir.c_str());
+    return compiled;
+}
+
+/**
+ * Meld bytecode dispatch, with the switch, with the computed goto and compiled to native code if
+ *  loaded, in ns per bytecode instruction. The body of predicate work(a, b, c) is run on one tuple
+ *  by a VM of module
+ */
+static void runMeldDispatchBenchmarks(BenchmarkReport &report, BuildingBlock *module, bool native) {
+    using MeldInterpret::MeldInterpretVM;
+    MeldInterpretVM *vm = new MeldInterpretVM(module);
+    tuple_t work = vm->tuple_alloc(1);
+    for (int field = 0; field < 3; field++)
+        MELD_INT(TUPLE_FIELD(work, field * sizeof(meld_int))) = field + 1;
+    const unsigned char *meld_prog = MeldInterpretVM::meld_prog;
+    const unsigned char *start = TYPE_START(1);
+    Register reg[32] = {};
+
+    const bool switchDispatch = MeldInterpretVM::switchDispatch;
+    const bool nativeDispatch = MeldInterpretVM::nativeDispatch;
+    const char *names[] = { "switch", "computedGoto", "native" };
+    for (int mode = 0; mode < (native ? 3 : 2); mode++) {
+        MeldInterpretVM::switchDispatch = mode == 0;
+        MeldInterpretVM::nativeDispatch = mode == 2;
+        MELD_INT(TUPLE_FIELD(work, 2 * sizeof(meld_int))) = 0;
+        report.measure(string("meld.dispatch.") + names[mode], [&]() {
+            for (int i = 0; i < 1000; i++)
+                vm->process_bytecode(work, start, 1, NOT_LINEAR, reg, PROCESS_TUPLE);
+            return 1000 * meldWorkInstructions;
+        });
+        // The last move of the body copies b to c
+        if (MELD_INT(TUPLE_FIELD(work, 2 * sizeof(meld_int))) != 2)
+            cerr << "error: wrong result of the Meld bytecode with the " << names[mode]
+                 << " dispatch" << endl;
+    }
+    MeldInterpretVM::switchDispatch = switchDispatch;
+    MeldInterpretVM::nativeDispatch = nativeDispatch;
+    delete vm;
+}
+
+/**
+ * MeldInterpretVM::processAll on a VM per module, interpreted with 1 thread and with 4 threads and
+ *  compiled to native code with 1 thread if loaded, in ns per pass of a VM. Each round creates the
+ *  VMs and runs passes of the counter program until equilibrium, which must be reached with
+ *  count(meldCountLimit) in every VM. The databases of the VMs, hashed in block order, must be the
+ *  same in every case
+ */
+static void runMeldProcessAllBenchmarks(BenchmarkReport &report, const vector<BuildingBlock*> &modules,
+                                        bool native) {
+    using MeldInterpret::MeldInterpretVM;
+    const unsigned char *meld_prog = MeldInterpretVM::meld_prog;
+    const unsigned char *arguments = MeldInterpretVM::arguments;
+    // Handling of _init and rule 0, then handling of count(n + 1) and step(n) and rule 1 for each
+    // n, ten times as many passes means that the VMs never become idle
+    const int maxPasses = 10 * (3 * meldCountLimit + 4);
+
+    const unsigned int nbThreads = MeldInterpretVM::nbThreads;
+    const bool nativeDispatch = MeldInterpretVM::nativeDispatch;
+    const char *names[] = { "oneThread", "fourThreads", "native" };
+    const unsigned int threadCounts[] = { 1, 4, 1 };
+    uint64_t hashes[3] = { 0, 0, 0 };
+    bool counted = true, idle = true;
+    for (int mode = 0; mode < (native ? 3 : 2); mode++) {
+        MeldInterpretVM::nbThreads = threadCounts[mode];
+        MeldInterpretVM::nativeDispatch = mode == 2;
+        uint64_t &hash = hashes[mode];
+        report.measure(string("meld.processAll.") + names[mode], [&]() {
+            vector<MeldInterpretVM*> vms;
+            for (BuildingBlock *bb : modules)
+                vms.push_back(new MeldInterpretVM(bb));
+            uint64_t vmPasses = 0;
+            for (int pass = 0; pass < maxPasses and not MeldInterpretVM::equilibrium(); pass++)
+                vmPasses += MeldInterpretVM::processAll();
+            idle = idle and MeldInterpretVM::equilibrium();
+
+            // FNV-1a hash of the facts and their counts
+            hash = 14695981039346656037ULL;
+            auto add = [&hash](const void *data, size_t size) {
+                for (size_t i = 0; i < size; i++) {
+                    hash ^= ((const unsigned char*)data)[i];
+                    hash *= 1099511628211ULL;
+                }
+            };
+            for (MeldInterpretVM *vm : vms) {
+                tuple_queue *counts = vm->tuples[2];
+                counted = counted and counts != NULL and counts->length == 1
+                    and MELD_INT(TUPLE_FIELD(counts->head->tuple, 0)) == meldCountLimit;
+                for (tuple_type type = 0; type < NUM_TYPES; type++) {
+                    if (vm->tuples[type] == NULL) continue;
+                    for (tuple_entry *entry = vm->tuples[type]->head; entry; entry = entry->next) {
+                        add(entry->tuple, TYPE_SIZE(type));
+                        add(&entry->records.count, sizeof(entry->records.count));
+                    }
+                }
+                delete vm;
+            }
+            return vmPasses;
+        });
+    }
+    MeldInterpretVM::nbThreads = nbThreads;
+    MeldInterpretVM::nativeDispatch = nativeDispatch;
+    if (not idle)
+        cerr << "error: the Meld VMs do not reach equilibrium" << endl;
+    if (not counted)
+        cerr << "error: wrong result of the Meld processAll program" << endl;
+    if (hashes[0] != hashes[1])
+        cerr << "error: the Meld databases differ with 1 thread and with 4 threads" << endl;
+    if (native and hashes[0] != hashes[2])
+        cerr << "error: the Meld databases differ with the interpreter and with the native code" << endl;
+}
+
+void runCommonBenchmarks(BenchmarkReport &report) {
+    World *world = getWorld();
+    Lattice *lattice = world->lattice;
+    vector<BuildingBlock*> modules;
+    for (const auto &it : world->getMap()) modules.push_back(it.second);
+    volatile uint64_t sink = 0; // prevents the compiler from discarding benchmarked calls
+
+    // Same container as Scheduler::eventsMap, with events in random date order
+    const int nbEvents = 100000;
+    vector<Time> dates(nbEvents);
+    mt19937 generator(0);
+    for (Time &d : dates) d = generator() % 1000000;
+    report.measure("eventQueue.pushPop", [&]() {
+        multimap<Time, EventPtr> eventsMap;
+        for (Time d : dates)
+            eventsMap.insert(pair<Time, EventPtr>(d, make_shared<CodeEndSimulationEvent>(d)));
+        while (not eventsMap.empty()) {
+            sink += eventsMap.begin()->second->id;
+            eventsMap.erase(eventsMap.begin());
+        }
+        return (uint64_t)nbEvents;
+    });
+
+    report.measure("lattice.getBlock", [&]() {
+        for (BuildingBlock *bb : modules)
+            sink += lattice->getBlock(bb->position)->blockId;
+        return (uint64_t)modules.size();
+    });
+
+    report.measure("lattice.getActiveNeighborCells", [&]() {
+        for (BuildingBlock *bb : modules)
+            sink += lattice->getActiveNeighborCells(bb->position).size();
+        return (uint64_t)modules.size();
+    });
+
+    report.measure("module.connectedInterfaces", [&]() {
+        for (BuildingBlock *bb : modules) {
+            for (P2PNetworkInterface *ni : bb->getP2PNetworkInterfaces())
+                if (ni->isConnected()) sink += ni->getConnectedBlockId();
+        }
+        return (uint64_t)modules.size();
+    });
+
+    // Each processed message has been scheduled, sent, transmitted and handled by the flooding code
+    StatsCollector &stats = StatsCollector::getInstance();
+    if (stats.getMessagesProcessed())
+        report.add("message.sendReceive", stats.getMessagesProcessed(),
+                   stats.getRealElapsedTime() * 1000 / stats.getMessagesProcessed());
+}
+
+void runMeldBenchmarks(BenchmarkReport &report) {
+    vector<BuildingBlock*> modules;
+    for (const auto &it : getWorld()->getMap()) modules.push_back(it.second);
+    volatile uint64_t sink = 0; // prevents the compiler from discarding benchmarked calls
+    mt19937 generator(0);
+
+    // Meld VM delayed tuples (SEND_DELAY), each due entry is sent again later, as by a periodic rule
+    const int nbDelayed = 10000;
+    vector<tuple_pentry> entries(nbDelayed, tuple_pentry { 0, nullptr, record_type(1), nullptr, 0 });
+    report.measure("meld.delayedTuples.pushPop", [&]() {
+        MeldInterpret::tuple_wheel delayed(0);
+        Time now = 0;
+        for (tuple_pentry &entry : entries) {
+            entry.priority = 1 + generator() % (2 * nbDelayed);
+            delayed.push(&entry);
+        }
+        uint64_t operations = 0;
+        while (operations < 10 * (uint64_t)nbDelayed) {
+            now++;
+            tuple_pentry *entry;
+            while ((entry = delayed.pop_expired(now)) != nullptr) {
+                entry->priority = now + 1 + generator() % (2 * nbDelayed);
+                delayed.push(entry);
+                operations++;
+            }
+        }
+        return operations;
+    });
+
+    // Meld VM stratified tuples, over a few stratification rounds
+    report.measure("meld.stratTuples.pushPop", [&]() {
+        MeldInterpret::tuple_strata strata;
+        for (tuple_pentry &entry : entries) {
+            entry.priority = 1 + generator() % 8;
+            strata.push(&entry);
+        }
+        while (not strata.empty())
+            sink += strata.pop()->priority;
+        return (uint64_t)nbDelayed;
+    });
+
+    // Meld VM min and sum aggregates under churn: a record is retracted and another derived,
+    // then the aggregate value is read, as by aggregate_recalc
+    const int nbRecords = 10000;
+    vector<meld_int> records(nbRecords);
+    for (int aggType : { AGG_MIN_INT, AGG_SUM_INT }) {
+        report.measure(aggType == AGG_MIN_INT ? "meld.aggregate.minChurn" : "meld.aggregate.sumChurn", [&]() {
+            MeldInterpret::tuple_aggregate aggregate(aggType);
+            for (meld_int &value : records) {
+                value = generator() % 1000000;
+                aggregate.update(&value, 0, 1);
+            }
+            for (int i = 0; i < 10 * nbRecords; i++) {
+                meld_int &value = records[generator() % nbRecords];
+                aggregate.update(&value, 1, 0);
+                value = generator() % 1000000;
+                aggregate.update(&value, 0, 1);
+                meld_int acc;
+                aggregate.get(&acc);
+                sink += acc;
+            }
+            return 10 * (uint64_t)nbRecords;
+        });
+    }
+
+    if (loadMeldProgram()) {
+        const bool native = loadMeldNativeCode();
+        runMeldDispatchBenchmarks(report, modules.front(), native);
+        runMeldProcessAllBenchmarks(report, modules, native);
+    }
+}
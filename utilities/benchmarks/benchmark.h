@@ -0,0 +1,101 @@
+/**
+ * @file   benchmark.h
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Micro-benchmark harness and world generator of the VisibleSim benchmark suite
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "grid/cell3DPosition.h"
+
+using namespace std;
+
+/**
+ * Collects the results of the benchmarks of one run and writes them as JSON
+ */
+class BenchmarkReport {
+    //!< Result of a micro-benchmark
+    struct Result {
+        string name;
+        uint64_t operations;
+        double nsPerOp;
+    };
+
+    vector<Result> results;
+    string stats; //!< JSON global statistics of the simulation, see StatsCollector::writeJSON
+
+public:
+    static inline double minDuration = 0.2; //!< minimal duration of a micro-benchmark, in seconds
+
+    /**
+     * Times a micro-benchmark, by calling round until minDuration has elapsed
+     * @param name benchmark name, as written to the report
+     * @param round function running one round of the benchmark, returns its number of operations
+     */
+    void measure(const string &name, const function<uint64_t()> &round);
+
+    //!< Adds a result computed by the caller
+    void add(const string &name, uint64_t operations, double nsPerOp) {
+        results.push_back({ name, operations, nsPerOp });
+    }
+
+    //!< Records the global statistics of the simulation that has just ended
+    void recordSimulationStats();
+
+    /**
+     * Writes the report as a JSON object, without trailing newline
+     * @param module module type of the run
+     * @param size size parameter of the generated world
+     */
+    void writeJSON(ostream &out, const string &module, int size) const;
+};
+
+/**
+ * Writes a headless configuration file
+ * @param fileName output file name
+ * @param gridSize size of the lattice
+ * @param positions positions of the modules, the first one is the flooding source
+ * @return true if the file has been written successfully
+ */
+bool writeConfiguration(const string &fileName, const Cell3DPosition &gridSize,
+                        const vector<Cell3DPosition> &positions);
+
+/**
+ * Micro-benchmarks that do not depend on the module type, run on the current world:
+ *  event queue push/pop, Lattice::getBlock, lattice neighborhood and interfaces iteration,
+ *  and the end-to-end cost of a message derived from the simulation statistics
+ */
+void runCommonBenchmarks(BenchmarkReport &report);
+
+/**
+ * Meld VM micro-benchmarks, run on the modules of the current world: delayed and stratified
+ *  tuples queues and aggregates under churn, bytecode switch and computed goto dispatch and
+ *  native code, VM passes with 1 thread, with 4 threads and with native code. The VM only loads
+ *  one program per process, so they are run once, by vsbench meld
+ */
+void runMeldBenchmarks(BenchmarkReport &report);
+
+/**
+ * Module type specific benchmarks: run the flooding macro benchmark on the configuration
+ *  given by the command line, then the common micro-benchmarks and motion engine queries
+ * @param argc, argv VisibleSim command line
+ * @param report report receiving the results
+ */
+void runBlinkyBlocksBenchmark(int argc, char *argv[], BenchmarkReport &report);
+void runCatoms3DBenchmark(int argc, char *argv[], BenchmarkReport &report);
+void runHexanodesBenchmark(int argc, char *argv[], BenchmarkReport &report);
+
+/**
+ * Meld benchmarks: runs the flooding on the BlinkyBlocks configuration given by the command line,
+ *  then the Meld micro-benchmarks on its modules
+ * @param argc, argv VisibleSim command line
+ * @param report report receiving the results
+ */
+void runMeldBenchmark(int argc, char *argv[], BenchmarkReport &report);
@@ -0,0 +1,29 @@
+/**
+ * @file   blinkyBlocksBenchmark.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  BlinkyBlocks benchmarks: flooding on a cube of modules in a square lattice
+ */
+
+#include "robots/blinkyBlocks/blinkyBlocksSimulator.h"
+#include "robots/blinkyBlocks/blinkyBlocksBlockCode.h"
+
+#include "benchmark.h"
+#include "floodingBlockCode.hpp"
+
+using namespace BlinkyBlocks;
+
+void runBlinkyBlocksBenchmark(int argc, char *argv[], BenchmarkReport &report) {
+    createSimulator(argc, argv,
+                    FloodingBlockCode<BlinkyBlocksBlockCode, BlinkyBlocksBlock>::buildNewBlockCode);
+    report.recordSimulationStats();
+    runCommonBenchmarks(report);
+    deleteSimulator();
+}
+
+void runMeldBenchmark(int argc, char *argv[], BenchmarkReport &report) {
+    createSimulator(argc, argv,
+                    FloodingBlockCode<BlinkyBlocksBlockCode, BlinkyBlocksBlock>::buildNewBlockCode);
+    runMeldBenchmarks(report);
+    deleteSimulator();
+}
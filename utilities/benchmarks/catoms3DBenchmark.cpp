@@ -0,0 +1,34 @@
+/**
+ * @file   catoms3DBenchmark.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Catoms3D benchmarks: flooding on a cube of modules in a FCC lattice,
+ *  and rotation queries of the motion engine
+ */
+
+#include "robots/catoms3D/catoms3DSimulator.h"
+#include "robots/catoms3D/catoms3DBlockCode.h"
+#include "robots/catoms3D/catoms3DMotionEngine.h"
+
+#include "benchmark.h"
+#include "floodingBlockCode.hpp"
+
+using namespace Catoms3D;
+
+void runCatoms3DBenchmark(int argc, char *argv[], BenchmarkReport &report) {
+    createSimulator(argc, argv,
+                    FloodingBlockCode<Catoms3DBlockCode, Catoms3DBlock>::buildNewBlockCode);
+    report.recordSimulationStats();
+    runCommonBenchmarks(report);
+
+    vector<Catoms3DBlock*> modules;
+    for (const auto &it : Catoms3D::getWorld()->getMap()) modules.push_back((Catoms3DBlock*)it.second);
+    volatile size_t sink = 0;
+    report.measure("motionEngine.getAllRotationsForModule", [&]() {
+        for (Catoms3DBlock *catom : modules)
+            sink += Catoms3DMotionEngine::getAllRotationsForModule(catom).size();
+        return (uint64_t)modules.size();
+    });
+
+    deleteSimulator();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file   floodingBlockCode.hpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Flooding block code used by the macro benchmarks, for any module type
+ */
+
+#ifndef FloodingBlockCode_H_
+#define FloodingBlockCode_H_
+
+#include "base/blockCode.h"
+#include "comm/network.h"
+
+static const int FLOOD_MSG_ID = 9001;
+
+/**
+ * Module #1 floods a message to the whole configuration, each module forwards the first
+ *  copy it receives to all its other neighbors and records its hop distance to the source
+ * @tparam ModuleBlockCode block code base class of the module type, e.g. Catoms3DBlockCode
+ * @tparam ModuleBlock building block class of the module type, e.g. Catoms3DBlock
+ */
+template<class ModuleBlockCode, class ModuleBlock>
+class FloodingBlockCode : public ModuleBlockCode {
+    int distance = -1; //!< hop distance to the source, -1 until the flood is received
+public:
+    FloodingBlockCode(ModuleBlock *host) : ModuleBlockCode(host) {
+        if (not host) return;
+
+        this->addMessageEventFunc2(FLOOD_MSG_ID,
+                                   std::bind(&FloodingBlockCode::floodFunction, this,
+                                             std::placeholders::_1, std::placeholders::_2));
+    }
+
+    void startup() override {
+        if (this->hostBlock->blockId == 1) {
+            distance = 0;
+            this->sendMessageToAllNeighbors(new MessageOf<int>(FLOOD_MSG_ID, distance), 1000, 100, 0);
+        }
+    }
+
+    void floodFunction(std::shared_ptr<Message> msg, P2PNetworkInterface *sender) {
+        if (distance >= 0) return;
+
+        distance = *std::static_pointer_cast<MessageOf<int>>(msg)->getData() + 1;
+        this->sendMessageToAllNeighbors(new MessageOf<int>(FLOOD_MSG_ID, distance), 1000, 100, 1, sender);
+    }
+
+    static BaseSimulator::BlockCode *buildNewBlockCode(BaseSimulator::BuildingBlock *host) {
+        return (new FloodingBlockCode((ModuleBlock*)host));
+    }
+};
+
+#endif /* FloodingBlockCode_H_ */
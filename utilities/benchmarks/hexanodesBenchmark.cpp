@@ -0,0 +1,34 @@
+/**
+ * @file   hexanodesBenchmark.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  Hexanodes benchmarks: flooding on a parallelogram of modules in a hexagonal lattice,
+ *  and motion queries of the motion engine
+ */
+
+#include "robots/hexanodes/hexanodesSimulator.h"
+#include "robots/hexanodes/hexanodesBlockCode.h"
+#include "robots/hexanodes/hexanodesWorld.h"
+
+#include "benchmark.h"
+#include "floodingBlockCode.hpp"
+
+using namespace Hexanodes;
+
+void runHexanodesBenchmark(int argc, char *argv[], BenchmarkReport &report) {
+    createSimulator(argc, argv,
+                    FloodingBlockCode<HexanodesBlockCode, HexanodesBlock>::buildNewBlockCode);
+    report.recordSimulationStats();
+    runCommonBenchmarks(report);
+
+    vector<HexanodesBlock*> modules;
+    for (const auto &it : Hexanodes::getWorld()->getMap()) modules.push_back((HexanodesBlock*)it.second);
+    volatile size_t sink = 0;
+    report.measure("motionEngine.getAllMotionsForModule", [&]() {
+        for (HexanodesBlock *module : modules)
+            sink += Hexanodes::getWorld()->getAllMotionsForModule(module).size();
+        return (uint64_t)modules.size();
+    });
+
+    deleteSimulator();
+}
@@ -0,0 +1,86 @@
+#!/bin/bash
+
+usage() {
+    echo "Usage: $0 [<output.json>] [<sizes>]"
+    echo "Example: $0 benchmarks.json \"4 8 16\""
+    echo "Runs the flooding benchmarks of vsbench on generated blinkyBlocks, catoms3D and hexanodes"
+    echo "worlds of increasing <sizes> (default: \"4 8 16\", about <size>^3 modules), the Meld VM"
+    echo "benchmarks once on the largest blinkyBlocks world, and the shapeReconfiguration scenarios"
+    echo "if that application has been built, all in terminal mode."
+    echo "Results are written as JSON to <output.json> (default: benchmarks.json)"
+    exit 1
+}
+
+[ "$1" == "-h" ] && usage
+
+benchDir="$(cd "$(dirname "$0")" && pwd)"
+output="${1:-benchmarks.json}"
+sizes=${2:-"4 8 16"}
+reconf="$benchDir/../../applicationsBin/shapeReconfiguration"
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+if [ ! -x "$benchDir/vsbench" ]; then
+    echo "error: vsbench not found, run 'make benchmarks' from the VisibleSim root directory first"
+    exit 1
+fi
+
+# Joins the JSON objects of the files given as arguments into a JSON array
+join() {
+    local sep=""
+    echo "["
+    for f in "$@"; do
+        echo -n "$sep"
+        cat "$f"
+        sep=","
+    done
+    echo "]"
+}
+
+flooding=()
+for module in blinkyBlocks catoms3D hexanodes; do
+    for size in $sizes; do
+        result="$tmp/flooding_${module}_$size.json"
+        echo "flooding: $module, size $size"
+        if (cd "$tmp" && "$benchDir/vsbench" $module $size "$result" > "$result.log" 2>&1); then
+            flooding+=("$result")
+        else
+            echo "error: run failed, see output below"; tail -20 "$result.log"
+        fi
+    done
+done
+
+meld=()
+meldSize=${sizes##* }
+result="$tmp/meld_$meldSize.json"
+echo "meld: blinkyBlocks, size $meldSize"
+if (cd "$tmp" && "$benchDir/vsbench" meld $meldSize "$result" > "$result.log" 2>&1); then
+    meld+=("$result")
+else
+    echo "error: run failed, see output below"; tail -20 "$result.log"
+fi
+
+reconfiguration=()
+if [ -x "$reconf/shapeReconfiguration" ]; then
+    for config in "$reconf"/*.xml; do
+        name="$(basename "$config")"
+        result="$tmp/reconfiguration_$name.json"
+        echo "reconfiguration: shapeReconfiguration $name"
+        if (cd "$reconf" && ./shapeReconfiguration -t -c "$name" --stats-json "$tmp/stats.json" > "$result.log" 2>&1) \
+            && [ -s "$tmp/stats.json" ]; then
+            echo "{ \"application\": \"shapeReconfiguration\", \"config\": \"$name\", \"simulation\": $(cat "$tmp/stats.json") }" > "$result"
+            reconfiguration+=("$result")
+        else
+            echo "error: run failed, see output below"; tail -20 "$result.log"
+        fi
+        rm -f "$tmp/stats.json"
+    done
+fi
+
+{
+    echo "{ \"date\": \"$(date -Iseconds)\", \"host\": \"$(uname -n)\","
+    echo "\"flooding\": $(join "${flooding[@]}"),"
+    echo "\"meld\": $(join "${meld[@]}"),"
+    echo "\"reconfiguration\": $(join "${reconfiguration[@]}") }"
+} > "$output"
+echo "Results written to $output"
@@ -0,0 +1,99 @@
+/**
+ * @file   vsbench.cpp
+ * @date   Sun Oct 18 2026
+ *
+ * @brief  VisibleSim benchmark runner: generates a world of a given module type and size,
+ *  floods it headless, runs the micro-benchmarks on it and writes the results as JSON
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "benchmark.h"
+
+//!< Benchmarked module types
+static const struct {
+    const char *name;
+    int dimensions; //!< 3 for a cube of size^3 modules, 2 for a parallelogram of about size^3 modules
+    void (*run)(int argc, char *argv[], BenchmarkReport &report);
+} moduleTypes[] = {
+    { "blinkyBlocks", 3, runBlinkyBlocksBenchmark },
+    { "catoms3D", 3, runCatoms3DBenchmark },
+    { "hexanodes", 2, runHexanodesBenchmark },
+    { "meld", 3, runMeldBenchmark }, // Meld VM benchmarks on a blinkyBlocks world
+};
+static const int nbModuleTypes = sizeof(moduleTypes) / sizeof(moduleTypes[0]);
+
+static void usage() {
+    cerr << "Usage: vsbench <module> <size> [<output.json>] [-- <VisibleSim options>]" << endl
+         << "  <module>\tblinkyBlocks, catoms3D, hexanodes, or meld for the Meld VM benchmarks"
+         << endl
+         << "  <size>\tside of the generated world, about <size>^3 modules" << endl
+         << "  <output.json>\tresults file (default: benchmark.json)" << endl;
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) usage();
+
+    const string module = argv[1];
+    const int size = atoi(argv[2]);
+    int type = 0;
+    while (type < nbModuleTypes and module != moduleTypes[type].name) type++;
+    if (type == nbModuleTypes or size <= 0) usage();
+
+    string outputFile = "benchmark.json";
+    int next = 3;
+    if (argc > next and string(argv[next]) != "--") outputFile = argv[next++];
+    if (argc > next and string(argv[next]) != "--") usage();
+
+    // Generated world, module #1 (the flooding source) is in a corner
+    Cell3DPosition gridSize;
+    vector<Cell3DPosition> positions;
+    if (moduleTypes[type].dimensions == 3) {
+        gridSize.set(size, size, size);
+        for (int z = 0; z < size; z++)
+            for (int y = 0; y < size; y++)
+                for (int x = 0; x < size; x++)
+                    positions.push_back(Cell3DPosition(x, y, z));
+    } else {
+        const int side = lround(pow(size, 1.5));
+        gridSize.set(side, side, 1);
+        for (int y = 0; y < side; y++)
+            for (int x = 0; x < side; x++)
+                positions.push_back(Cell3DPosition(x, y, 0));
+    }
+
+    const string configFile = "vsbench_" + module + "_" + to_string(size) + ".xml";
+    if (not writeConfiguration(configFile, gridSize, positions)) {
+        cerr << "error: cannot write configuration " << configFile << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Headless VisibleSim command line, followed by the user options
+    vector<char*> vsArgv = { argv[0], (char*)"-t", (char*)"-c", (char*)configFile.c_str() };
+    for (int i = next + 1; i < argc; i++) vsArgv.push_back(argv[i]);
+    vsArgv.push_back(nullptr);
+
+    BenchmarkReport report;
+    try {
+        moduleTypes[type].run(vsArgv.size() - 1, vsArgv.data(), report);
+    } catch (std::exception const& e) {
+        cerr << "Uncaught exception: " << e.what() << endl;
+        remove(configFile.c_str());
+        return EXIT_FAILURE;
+    }
+    remove(configFile.c_str());
+
+    ofstream fout(outputFile);
+    report.writeJSON(fout, module, size);
+    fout << endl;
+    if (not fout.good()) {
+        cerr << "error: cannot write results to " << outputFile << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+usage() {
+    echo "Usage: $0 <path-to-blockCode-binary> <config.xml> [<runs>]"
+    echo "Example: $0 ../applicationsBin/shapeReconfiguration/shapeReconfiguration config.xml 5"
+    echo "Converts config.xml into a binary snapshot (config.vsnap), then compares"
+    echo "the configuration loading time of both formats over <runs> runs (default: 3)"
+    exit 1
+}
+
+# Check parameters
+[ $# -lt 2 ] && usage
+
+if [ ! -x "$1" ]; then
+    echo "error: invalid BlockCode $1"
+    exit 1
+fi
+
+bc="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+bcDir="$(dirname "$bc")"
+config="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")"
+snapshot="${config%.xml}.vsnap"
+runs=${3:-3}
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+# Loading time is reported by --convert-config, conversion output is discarded
+load_time() {
+    (cd "$bcDir" && "$bc" -t -c "$1" --convert-config "$2" 2>&1) \
+        | grep -a "loaded in" | sed 's/.* loaded in \([0-9.]*\) ms.*/\1/'
+}
+
+echo "Converting $config to $snapshot"
+(cd "$bcDir" && "$bc" -t -c "$config" --convert-config "$snapshot" 2>&1) | grep -a "loaded in"
+[ -r "$snapshot" ] || { echo "error: conversion failed"; exit 1; }
+
+for format in xml vsnap; do
+    input="$config"
+    [ $format == vsnap ] && input="$snapshot"
+    total=0
+    for ((i = 0; i < runs; i++)); do
+        t=$(load_time "$input" "$tmp/out.vsnap")
+        total=$(awk "BEGIN { print $total + $t }")
+    done
+    echo -e "$format:\t$(awk "BEGIN { printf \"%.2f\", $total / $runs }") ms (mean of $runs runs, $(stat -c %s "$input") bytes)"
+done
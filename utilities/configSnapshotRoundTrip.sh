@@ -0,0 +1,61 @@
+#!/bin/bash
+
+usage() {
+    echo "Usage: $0 <path-to-blockCode-binary> <config.xml>"
+    echo "Example: $0 ../applicationsBin/shapeReconfiguration/shapeReconfiguration config.xml"
+    echo "Checks that configuration conversions are lossless: config.xml is converted to a snapshot,"
+    echo "the snapshot to XML, and that XML to a snapshot and to XML again. Both snapshots and both"
+    echo "XML conversions must be identical. The simulation is then run headless from config.xml and"
+    echo "from the converted XML, and must end in the same configuration (see -g)"
+    exit 1
+}
+
+# Check parameters
+[ $# -lt 2 ] && usage
+
+if [ ! -x "$1" ]; then
+    echo "error: invalid BlockCode $1"
+    exit 1
+fi
+
+bc="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+bcDir="$(dirname "$bc")"
+config="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")"
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+convert() {
+    (cd "$bcDir" && "$bc" -t -c "$1" --convert-config "$2" > /dev/null 2>&1)
+    [ -r "$2" ] || { echo "error: conversion of $(basename "$1") to $(basename "$2") failed"; exit 1; }
+}
+
+# Final configuration of a headless run, exported by -g
+run() {
+    (cd "$bcDir" && rm -f .confCheck.xml && "$bc" -t -g -c "$1" > /dev/null 2>&1 \
+         && mv .confCheck.xml "$2")
+    [ -r "$2" ] || { echo "error: simulation of $(basename "$1") failed"; exit 1; }
+}
+
+convert "$config" "$tmp/a.vsnap"
+convert "$tmp/a.vsnap" "$tmp/b.xml"
+convert "$tmp/b.xml" "$tmp/c.vsnap"
+convert "$tmp/b.xml" "$tmp/d.xml"
+
+rc=0
+check() {
+    if cmp -s "$2" "$3"; then
+        echo -e "$1:\tPASS"
+    else
+        echo -e "$1:\tFAILED ($(basename "$2") and $(basename "$3") differ)"
+        rc=1
+    fi
+}
+
+check "snapshot -> XML -> snapshot" "$tmp/a.vsnap" "$tmp/c.vsnap"
+check "XML -> XML" "$tmp/b.xml" "$tmp/d.xml"
+
+run "$config" "$tmp/final_config.xml"
+run "$tmp/b.xml" "$tmp/final_converted.xml"
+check "simulation" "$tmp/final_config.xml" "$tmp/final_converted.xml"
+
+exit $rc
@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+"""Converts a binary console log written with --log-sink into the simulation.log text format
+
+Usage: decodeLog.py <simulation.vslog> [<level>]
+Prints messages up to <level>: 1 error, 2 warning, 3 info, 4 debug (default: 4, all messages)
+"""
+
+import struct
+import sys
+
+MAGIC = b"VSIMLOG1"
+RECORD = struct.Struct("=QIBI")  # date, block id, level, message size
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    maxLevel = int(sys.argv[2]) if len(sys.argv) > 2 else 4
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+
+    if data[:len(MAGIC)] != MAGIC:
+        sys.exit("error: " + sys.argv[1] + " is not a binary console log")
+
+    pos = len(MAGIC)
+    out = sys.stdout
+    while pos + RECORD.size <= len(data):
+        date, bid, level, size = RECORD.unpack_from(data, pos)
+        pos += RECORD.size
+        message = data[pos:pos + size].decode("utf-8", "replace")
+        pos += size
+        if level <= maxLevel:
+            out.write("%.6f #%d: %s\n" % (date / 1000000, bid, message))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+#!/bin/bash
+
+usage() {
+    echo "Usage: $0 <program.bb> [<program.so> [<program.cpp>]]"
+    echo "Example: $0 ../applicationsBin/meld/program.bb program.so program.cpp"
+    echo "Packages the C arrays of a Meld program (meld_prog, tuple_names, rule_names and"
+    echo "optionally extern_functs, extern_functs_args) into a shared library (default: <program>.so),"
+    echo "loaded by the MeldInterpret VM when given to -p in place of the .bb file."
+    echo "The native code of the rules, written by a Meld simulation run with -p <program.bb>"
+    echo "--convert-program <program.cpp>, is compiled into the library if given, the VM then runs it"
+    echo "in place of the bytecode"
+    exit 1
+}
+
+# Check parameters
+[ $# -lt 1 ] && usage
+
+if [ ! -r "$1" ]; then
+    echo "error: cannot read Meld program $1"
+    exit 1
+fi
+
+program="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+plugin="${2:-${program%.bb}.so}"
+native="$3"
+if [ -n "$native" ] && [ ! -r "$native" ]; then
+    echo "error: cannot read Meld native code $native"
+    exit 1
+fi
+tmp="$(mktemp -d)"
+trap 'rm -rf "$tmp"' EXIT
+
+# Register type of the external functions, for programs including extern_functions.bbh without
+# providing it: the header next to the program is found first
+cat > "$tmp/extern_functions.bbh" <<HEADER
+#include <stdint.h>
+typedef uintptr_t Register;
+HEADER
+
+cp "$program" "$tmp/program.c"
+# Size of the bytecode, with which the VM checks that the native code was generated from it
+echo "const unsigned int meld_prog_size = sizeof(meld_prog);" >> "$tmp/program.c"
+if ! ${CC:-gcc} -O2 -fPIC -I"$(dirname "$program")" -I"$tmp" -c -o "$tmp/program.o" "$tmp/program.c"; then
+    echo "error: compilation of $program failed"
+    exit 1
+fi
+objects="$tmp/program.o"
+
+if [ -n "$native" ]; then
+    src="$(cd "$(dirname "$0")/../simulatorCore/src" && pwd)"
+    if ! ${CXX:-g++} -O2 -fPIC -I"$src" -c -o "$tmp/native.o" "$native"; then
+        echo "error: compilation of $native failed"
+        exit 1
+    fi
+    objects="$objects $tmp/native.o"
+fi
+
+if ! ${CXX:-g++} -shared -o "$plugin" $objects; then
+    echo "error: link of $plugin failed"
+    exit 1
+fi
+
+for symbol in meld_prog tuple_names rule_names; do
+    if ! nm -D --defined-only "$plugin" | grep -qw "$symbol"; then
+        echo "error: $program does not define $symbol"
+        rm -f "$plugin"
+        exit 1
+    fi
+done
+
+if [ -n "$native" ]; then
+    echo "Meld program bytecode and native code packaged in $plugin"
+else
+    echo "Meld program bytecode packaged in $plugin"
+fi
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Behavioral and performance regression testing of VisibleSim applications
+
+Usage: perfRegressionTest.py [options] <testDir>
+
+<testDir>/perfTests.txt lists the tests, one per line (# starts a comment):
+    <testID> <application> <VisibleSim arguments>
+    e.g. reconf1 shapeReconfiguration -c scenario1.xml
+Arguments naming files of <testDir> are passed as absolute paths. Each test is run headless
+(-t -g --stats-json) from applicationsBin/<application>, <runs> times.
+
+Behavior: the final configuration of every run (see -g) must match the golden file
+<testDir>/<testID>.golden.xml. Performance: the medians of events/s, wall time and peak memory are
+compared to the baseline <testDir>/<testID>.perf.json, a test fails if one of them is worse by
+more than <threshold> percent. Golden files and baselines are written with --update.
+
+Options:
+    -n <runs>       number of runs per test (default: 5)
+    -t <threshold>  performance regression threshold, in percent (default: 10)
+    -b <binDir>     applications directory (default: applicationsBin next to utilities)
+    -r <report>     writes the results of all tests as JSON to <report>
+    --update        records golden files and baselines instead of checking them
+Exits with status 1 if a test fails.
+"""
+
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+MANIFEST = "perfTests.txt"
+CHECK_FILE = ".confCheck.xml"  # exported by the -g option (Simulator::regrTesting)
+
+# Compared metrics: name, key in the stats JSON, True if higher is better
+METRICS = [("eventsPerSec", "eventsPerSec", True),
+           ("wallTimeMs", None, False),
+           ("peakRSSkB", "peakRSSkB", False)]
+
+
+def usage():
+    print(__doc__)
+    sys.exit(1)
+
+
+def parseArguments(argv):
+    options = {"runs": 5, "threshold": 10.0, "update": False, "report": None,
+               "binDir": os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "applicationsBin")}
+    values = {"-n": ("runs", int), "-t": ("threshold", float), "-b": ("binDir", str), "-r": ("report", str)}
+    testDir = None
+    i = 0
+    while i < len(argv):
+        if argv[i] in values and i + 1 < len(argv):
+            key, convert = values[argv[i]]
+            options[key] = convert(argv[i + 1])
+            i += 1
+        elif argv[i] == "--update":
+            options["update"] = True
+        elif testDir is None and not argv[i].startswith("-"):
+            testDir = os.path.abspath(argv[i])
+        else:
+            usage()
+        i += 1
+
+    if testDir is None or options["runs"] < 1:
+        usage()
+    return testDir, options
+
+
+def readManifest(testDir):
+    tests = []
+    with open(os.path.join(testDir, MANIFEST)) as f:
+        for line in f:
+            fields = line.split("#")[0].split()
+            if len(fields) < 2:
+                continue
+            args = [os.path.join(testDir, a) if os.path.isfile(os.path.join(testDir, a)) else a
+                    for a in fields[2:]]
+            tests.append({"id": fields[0], "application": fields[1], "args": args})
+    return tests
+
+
+def runOnce(test, binDir, tmp):
+    """Runs a test headless, returns (final configuration, metrics) or raises RuntimeError"""
+    appDir = os.path.join(binDir, test["application"])
+    statsFile = os.path.join(tmp, "stats.json")
+    checkFile = os.path.join(appDir, CHECK_FILE)
+    for f in (statsFile, checkFile):
+        if os.path.exists(f):
+            os.remove(f)
+
+    command = [os.path.join(appDir, test["application"])] + test["args"] + ["-t", "-g", "--stats-json", statsFile]
+    start = time.perf_counter()
+    result = subprocess.run(command, cwd=appDir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    wallTimeMs = (time.perf_counter() - start) * 1000
+
+    if result.returncode != 0 or not os.path.exists(checkFile) or not os.path.exists(statsFile):
+        error = result.stderr.decode("utf-8", "replace").strip().splitlines()
+        raise RuntimeError("run failed (status %d)%s" % (result.returncode, (": " + error[-1]) if error else ""))
+
+    with open(checkFile, "rb") as f:
+        config = f.read()
+    os.remove(checkFile)
+    with open(statsFile) as f:
+        stats = json.load(f)
+
+    metrics = {"wallTimeMs": wallTimeMs, "events": stats["events"]}
+    for name, key, _ in METRICS:
+        if key:
+            metrics[name] = stats[key]
+    return config, metrics
+
+
+def runTest(test, testDir, options, tmp):
+    """Runs a test options["runs"] times, returns its result"""
+    result = {"id": test["id"], "behavior": "PASS", "performance": "PASS", "notes": []}
+    golden = os.path.join(testDir, test["id"] + ".golden.xml")
+    baseline = os.path.join(testDir, test["id"] + ".perf.json")
+
+    configs, runs = [], []
+    try:
+        for _ in range(options["runs"]):
+            config, metrics = runOnce(test, options["binDir"], tmp)
+            configs.append(config)
+            runs.append(metrics)
+    except RuntimeError as e:
+        result["behavior"] = "FAILED"
+        result["notes"].append(str(e))
+        return result
+
+    medians = {name: statistics.median(r[name] for r in runs) for name, _, _ in METRICS}
+    medians["events"] = runs[0]["events"]
+    result["medians"] = medians
+    if len(set(configs)) > 1:
+        result["behavior"] = "FAILED"
+        result["notes"].append("final configurations differ between runs")
+
+    if options["update"] and result["behavior"] == "PASS":
+        with open(golden, "wb") as f:
+            f.write(configs[0])
+        with open(baseline, "w") as f:
+            json.dump(dict(medians, runs=options["runs"]), f, indent=2)
+            f.write("\n")
+        result["performance"] = result["behavior"] = "UPDATED"
+        return result
+
+    if options["update"]:
+        return result  # non deterministic test, not recorded
+
+    if not os.path.exists(golden):
+        result["behavior"] = "FAILED"
+        result["notes"].append("no golden file, run with --update first")
+    else:
+        with open(golden, "rb") as f:
+            reference = f.read()
+        if any(c != reference for c in configs):
+            result["behavior"] = "FAILED"
+            result["notes"].append("final configuration differs from " + os.path.basename(golden))
+
+    if not os.path.exists(baseline):
+        result["performance"] = "FAILED"
+        result["notes"].append("no baseline, run with --update first")
+        return result
+
+    with open(baseline) as f:
+        reference = json.load(f)
+    result["baseline"] = reference
+    if reference.get("events") != medians["events"]:
+        result["notes"].append("%d events processed instead of %s" % (medians["events"], reference.get("events")))
+    for name, _, higherIsBetter in METRICS:
+        if not reference.get(name):
+            continue
+        change = 100.0 * (medians[name] - reference[name]) / reference[name]
+        if (-change if higherIsBetter else change) > options["threshold"]:
+            result["performance"] = "FAILED"
+            result["notes"].append("%s %.1f%% %s than baseline (%.1f instead of %.1f)"
+                                   % (name, abs(change), "lower" if higherIsBetter else "higher",
+                                      medians[name], reference[name]))
+    return result
+
+
+def printResult(result):
+    colors = {"PASS": "\033[33;32m", "FAILED": "\033[33;31m", "UPDATED": "\033[33;34m"}
+    status = lambda s: colors[s] + s + "\x1B[0m"
+    medians = result.get("medians")
+    print("%-24s behavior [%s]\tperformance [%s]%s" % (
+        result["id"] + ":", status(result["behavior"]), status(result["performance"]),
+        "\t%.0f events/s, %.1f ms, %d kB" % (medians["eventsPerSec"], medians["wallTimeMs"],
+                                               medians["peakRSSkB"]) if medians else ""))
+    for note in result["notes"]:
+        print("    " + note)
+
+
+def main():
+    testDir, options = parseArguments(sys.argv[1:])
+    tests = readManifest(testDir)
+    print("Performance regression testing: %d tests, median of %d runs, threshold %.1f%%"
+          % (len(tests), options["runs"], options["threshold"]))
+
+    results = []
+    tmp = tempfile.mkdtemp()
+    try:
+        for test in tests:
+            results.append(runTest(test, testDir, options, tmp))
+            printResult(results[-1])
+    finally:
+        shutil.rmtree(tmp)
+
+    if options["report"]:
+        with open(options["report"], "w") as f:
+            json.dump({"runs": options["runs"], "threshold": options["threshold"], "tests": results}, f, indent=2)
+            f.write("\n")
+
+    sys.exit(1 if any("FAILED" in (r["behavior"], r["performance"]) for r in results) else 0)
+
+
+if __name__ == "__main__":
+    main()